@@ -132,6 +132,26 @@ declare global {
         executeLegacy(command: string): void;
     }
 
+    interface PluginPerformanceStats {
+        plugin: string;
+        /** The most time in milliseconds the plugin has spent in a single tick. */
+        maxTickTime: number;
+        /** The number of ticks the plugin has exceeded the configured tick budget in. */
+        ticksOverBudget: number;
+        calls: PluginCallStats[];
+    }
+
+    interface PluginCallStats {
+        /** The hook the callback is subscribed to, or the kind of callback. */
+        type: string;
+        count: number;
+        /** Times are in milliseconds. */
+        totalTime: number;
+        averageTime: number;
+        maxTime: number;
+        allocations: number;
+    }
+
     /**
      * Core APIs for storage and subscriptions.
      */
@@ -181,6 +201,24 @@ declare global {
          */
         getRandom(min: number, max: number): number;
 
+        /**
+         * Gets the time spent and the allocations made in the callbacks of each plugin
+         * since the game was started or the stats were reset with the plugin_stats console command.
+         */
+        getPerformanceStats(): PluginPerformanceStats[];
+
+        /**
+         * Runs the given script in its own context on a background thread. The worker has no access
+         * to the game, it can only exchange messages with the plugin. Inside the script, call
+         * postMessage to send a message to the plugin and define a global onMessage function to
+         * receive messages from it. Workers are terminated when the plugin is stopped.
+         * @param script The JavaScript source code to run.
+         * @throws An error if the plugin already has too many workers running. Terminated workers
+         * count until their script has stopped, which is at its next postMessage call if it is busy.
+         * A script that never returns keeps counting until the game exits, also across plugin reloads.
+         */
+        createWorker(script: string): Worker;
+
         /**
          * Registers a new game action that allows clients to interact with the game.
          * @param action The unique name of the action.
@@ -226,6 +264,32 @@ declare global {
         subscribe(hook: "network.leave", callback: (e: NetworkEventArgs) => void): IDisposable;
         subscribe(hook: "ride.ratings.calculate", callback: (e: RideRatingsCalculateArgs) => void): IDisposable;
         subscribe(hook: "action.location", callback: (e: ActionLocationArgs) => void): IDisposable;
+        /**
+         * Called at the end of each tick with the events of all the actions executed since the previous call.
+         * While the game is paused, it is called once per frame instead.
+         * Cheaper than action.execute for plugins that only need to observe actions.
+         */
+        subscribe(hook: "action.execute.batch", callback: (e: GameActionEventArgs[]) => void): IDisposable;
+    }
+
+    /**
+     * A script running on a background thread. Messages are copied between the plugin and the
+     * worker, they may contain undefined, null, booleans, numbers, strings, arrays, plain objects
+     * and typed arrays such as those returned by the bulk map queries.
+     */
+    interface Worker {
+        /**
+         * Called on the game thread with each message the worker posts.
+         */
+        onMessage: ((message: any) => void) | undefined;
+        readonly isTerminated: boolean;
+
+        postMessage(message: any): void;
+        /**
+         * Stops delivering messages in both directions and stops the worker once its script returns.
+         * A busy script can not be interrupted, it keeps running until its next postMessage call.
+         */
+        terminate(): void;
     }
 
     interface Configuration {
@@ -270,6 +334,12 @@ declare global {
          * Rotation of the camera from 0 to 3.
          */
         rotation: number;
+
+        /**
+         * PNG compression level from 0 to 9, 0 writes the image uncompressed which is the fastest.
+         * By default, the compression level from the configuration is used.
+         */
+        compressionLevel?: number;
     }
 
     type ObjectType =
@@ -291,7 +361,7 @@ declare global {
     type HookType =
         "interval.tick" | "interval.day" |
         "network.chat" | "network.action" | "network.join" | "network.leave" |
-        "ride.ratings.calculate" | "action.location";
+        "ride.ratings.calculate" | "action.location" | "action.execute.batch";
 
     type ExpenditureType =
         "ride_construction" |
@@ -313,6 +383,9 @@ declare global {
         readonly player: number;
         readonly type: string;
         readonly isClientOnly: boolean;
+        /**
+         * The arguments of the action, only created when first read.
+         */
         readonly args: object;
         result: GameActionResult;
     }
@@ -408,6 +481,64 @@ declare global {
         getEntity(id: number): Entity;
         getAllEntities(type: EntityType): Entity[];
         getAllEntities(type: "peep"): Peep[];
+
+        /**
+         * Gets the surface of every tile in the given region, in tile coordinates, as typed arrays.
+         * The data of tile (x, y) is at index (y - region.y) * region.width + (x - region.x).
+         * Much faster than calling getTile for each tile when reading large parts of the map.
+         */
+        getTileData(x: number, y: number, width: number, height: number): TileData;
+
+        /**
+         * Gets the types of the elements on every tile in the given region, in tile coordinates.
+         */
+        getElementTypes(x: number, y: number, width: number, height: number): ElementTypeData;
+
+        /**
+         * Gets the positions and states of all entities of the given type as typed arrays,
+         * in the same order as getAllEntities.
+         */
+        getEntityData(type: EntityType): EntityData;
+    }
+
+    /**
+     * The region a bulk query covers, clipped to the map.
+     */
+    interface MapRegionData {
+        x: number;
+        y: number;
+        width: number;
+        height: number;
+    }
+
+    interface TileData extends MapRegionData {
+        baseHeight: Uint8Array;
+        waterHeight: Uint16Array;
+        surfaceStyle: Uint8Array;
+        edgeStyle: Uint8Array;
+        numElements: Uint16Array;
+    }
+
+    interface ElementTypeData extends MapRegionData {
+        /**
+         * The types of the elements of tile i are types[offsets[i]] up to but not including types[offsets[i + 1]].
+         */
+        offsets: Uint32Array;
+        /**
+         * 0: surface, 1: footpath, 2: track, 3: small_scenery, 4: entrance, 5: wall, 6: large_scenery, 7: banner
+         */
+        types: Uint8Array;
+    }
+
+    interface EntityData {
+        id: Uint16Array;
+        x: Int16Array;
+        y: Int16Array;
+        z: Int16Array;
+        /**
+         * The state of peeps and the status of cars, 0 for other entities.
+         */
+        state: Uint8Array;
     }
 
     type TileElementType =
@@ -2390,7 +2390,6 @@ static void window_ride_construction_draw_track_piece(
 
 static TileElement _tempTrackTileElement;
 static TileElement _tempSideTrackTileElement = { 0x80, 0x8F, 128, 128, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
-static TileElement* _backupTileElementArrays[5];
 
 /**
  *
@@ -2438,16 +2437,11 @@ static void sub_6CBCE2(
         auto southTileCoords = centreTileCoords + TileDirectionDelta[TILE_ELEMENT_DIRECTION_SOUTH];
 
         // Replace map elements with temporary ones containing track
-        _backupTileElementArrays[0] = map_get_first_element_at(centreTileCoords.ToCoordsXY());
-        _backupTileElementArrays[1] = map_get_first_element_at(eastTileCoords.ToCoordsXY());
-        _backupTileElementArrays[2] = map_get_first_element_at(westTileCoords.ToCoordsXY());
-        _backupTileElementArrays[3] = map_get_first_element_at(northTileCoords.ToCoordsXY());
-        _backupTileElementArrays[4] = map_get_first_element_at(southTileCoords.ToCoordsXY());
-        map_set_tile_element(centreTileCoords, &_tempTrackTileElement);
-        map_set_tile_element(eastTileCoords, &_tempSideTrackTileElement);
-        map_set_tile_element(westTileCoords, &_tempSideTrackTileElement);
-        map_set_tile_element(northTileCoords, &_tempSideTrackTileElement);
-        map_set_tile_element(southTileCoords, &_tempSideTrackTileElement);
+        map_substitute_tile_elements(centreTileCoords, &_tempTrackTileElement);
+        map_substitute_tile_elements(eastTileCoords, &_tempSideTrackTileElement);
+        map_substitute_tile_elements(westTileCoords, &_tempSideTrackTileElement);
+        map_substitute_tile_elements(northTileCoords, &_tempSideTrackTileElement);
+        map_substitute_tile_elements(southTileCoords, &_tempSideTrackTileElement);
 
         // Set the temporary track element
         _tempTrackTileElement.SetType(TILE_ELEMENT_TYPE_TRACK);
@@ -2469,11 +2463,7 @@ static void sub_6CBCE2(
         sub_68B2B7(session, coords);
 
         // Restore map elements
-        map_set_tile_element(centreTileCoords, _backupTileElementArrays[0]);
-        map_set_tile_element(eastTileCoords, _backupTileElementArrays[1]);
-        map_set_tile_element(westTileCoords, _backupTileElementArrays[2]);
-        map_set_tile_element(northTileCoords, _backupTileElementArrays[3]);
-        map_set_tile_element(southTileCoords, _backupTileElementArrays[4]);
+        map_restore_tile_elements();
 
         trackBlock++;
     }
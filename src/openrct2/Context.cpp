@@ -32,8 +32,11 @@
 #include "core/File.h"
 #include "core/FileScanner.h"
 #include "core/FileStream.hpp"
+#include "core/FileWatcher.h"
 #include "core/Guard.hpp"
 #include "core/Http.h"
+#include "core/JobPool.hpp"
+#include "core/Json.hpp"
 #include "core/MemoryStream.h"
 #include "core/Path.hpp"
 #include "core/String.hpp"
@@ -42,6 +45,7 @@
 #include "interface/Chat.h"
 #include "interface/InteractiveConsole.h"
 #include "interface/Viewport.h"
+#include "interface/Window.h"
 #include "localisation/Date.h"
 #include "localisation/Localisation.h"
 #include "localisation/LocalisationService.h"
@@ -66,11 +70,18 @@
 #include "world/Park.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <exception>
+#include <functional>
+#include <future>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 using namespace OpenRCT2;
 using namespace OpenRCT2::Audio;
@@ -121,6 +132,33 @@ namespace OpenRCT2
         uint32_t _lastUpdateTime = 0;
         bool _variableFrame = false;
 
+        struct StartupStage
+        {
+            std::string Name;
+            std::thread::id ThreadId;
+            std::chrono::steady_clock::time_point Start;
+            std::chrono::steady_clock::time_point End;
+        };
+
+        // Timings of the stages run by Initialise, used for --startup-trace
+        std::chrono::steady_clock::time_point _startupTime;
+        std::vector<StartupStage> _startupStages;
+        std::mutex _startupStagesMutex;
+
+        // The user content directories are watched so the repositories pick up new content without a restart
+        enum : uint8_t
+        {
+            CONTENT_OBJECTS = 1 << 0,
+            CONTENT_TRACK_DESIGNS = 1 << 1,
+            CONTENT_SCENARIOS = 1 << 2,
+        };
+        std::mutex _changedContentMutex;
+        uint8_t _changedContent{};
+        uint32_t _lastContentChangeTick{};
+        uint8_t _contentIndexUpdatesToApply{};
+        std::future<uint8_t> _contentIndexUpdate;
+        std::vector<std::unique_ptr<FileWatcher>> _contentWatchers;
+
         // If set, will end the OpenRCT2 game loop. Intentially private to this module so that the flag can not be set back to
         // false.
         bool _finished = false;
@@ -155,6 +193,12 @@ namespace OpenRCT2
             // NOTE: We must shutdown all systems here before Instance is set back to null.
             //       If objects use GetContext() in their destructor things won't go well.
 
+            _contentWatchers.clear();
+            if (_contentIndexUpdate.valid())
+            {
+                _contentIndexUpdate.wait();
+            }
+
             GameActions::ClearQueue();
             network_close();
             window_close_all();
@@ -331,6 +375,7 @@ namespace OpenRCT2
                 throw std::runtime_error("Context already initialised.");
             }
             _initialised = true;
+            _startupTime = std::chrono::steady_clock::now();
 
             crash_init();
 
@@ -374,22 +419,9 @@ namespace OpenRCT2
             }
 #endif
 
-            try
-            {
-                _localisationService->OpenLanguage(gConfigGeneral.language, *_objectManager);
-            }
-            catch (const std::exception& e)
+            if (!RunStartupStage("OpenLanguage", [this]() { return OpenLanguage(); }))
             {
-                log_error("Failed to open configured language: %s", e.what());
-                try
-                {
-                    _localisationService->OpenLanguage(LANGUAGE_ENGLISH_UK, *_objectManager);
-                }
-                catch (const std::exception&)
-                {
-                    log_fatal("Failed to open fallback language: %s", e.what());
-                    return false;
-                }
+                return false;
             }
 
             if (platform_process_is_elevated())
@@ -420,46 +452,85 @@ namespace OpenRCT2
 
             if (!gOpenRCT2Headless)
             {
-                _uiContext->CreateWindow();
+                RunStartupStage("CreateWindow", [this]() { _uiContext->CreateWindow(); });
             }
 
             EnsureUserContentDirectoriesExist();
 
+            // Copied files, such as landscapes, are picked up by the scans below, so the copy has to finish first
+            RunStartupStage("CopyOriginalUserFiles", [this]() { CopyOriginalUserFilesOver(); });
+
+            // The repository scans only read files from disk and the open language, so they run on worker threads while
+            // this thread sets up audio, the network and the base graphics. Track designs of the older ride types look
+            // up their vehicle object, so that scan has to follow the object repository. Anything that can show a
+            // message box stays on this thread.
+            auto language = _localisationService->GetCurrentLanguage();
+            JobPool scanJobs;
+            std::exception_ptr scanException;
+            std::mutex scanExceptionMutex;
+            auto addScanTask = [&](std::function<void()> fn) {
+                scanJobs.AddTask([fn, &scanException, &scanExceptionMutex]() {
+                    try
+                    {
+                        fn();
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(scanExceptionMutex);
+                        scanException = std::current_exception();
+                    }
+                });
+            };
+
             // TODO Ideally we want to delay this until we show the title so that we can
             //      still open the game window and draw a progress screen for the creation
             //      of the object cache.
-            _objectRepository->LoadOrConstruct(_localisationService->GetCurrentLanguage());
-
-            // TODO Like objects, this can take a while if there are a lot of track designs
-            //      its also really something really we might want to do in the background
-            //      as its not required until the player wants to place a new ride.
-            _trackDesignRepository->Scan(_localisationService->GetCurrentLanguage());
-
-            _scenarioRepository->Scan(_localisationService->GetCurrentLanguage());
-            TitleSequenceManager::Scan();
+            addScanTask([this, language]() {
+                RunStartupStage("LoadObjectRepository", [&]() { _objectRepository->LoadOrConstruct(language); });
+                RunStartupStage("ScanTrackDesigns", [&]() { _trackDesignRepository->Scan(language); });
+            });
+            addScanTask([this, language]() {
+                RunStartupStage("ScanScenarios", [&]() { _scenarioRepository->Scan(language); });
+            });
+            addScanTask([this]() { RunStartupStage("ScanTitleSequences", []() { TitleSequenceManager::Scan(); }); });
 
             if (!gOpenRCT2Headless)
             {
-                audio_init();
-                audio_populate_devices();
-                audio_init_ride_sounds_and_info();
-                gGameSoundsOff = !gConfigSound.master_sound_enabled;
+                RunStartupStage("InitialiseAudio", []() {
+                    audio_init();
+                    audio_populate_devices();
+                    audio_init_ride_sounds_and_info();
+                    gGameSoundsOff = !gConfigSound.master_sound_enabled;
+                });
             }
 
-            network_set_env(_env);
-            chat_init();
-            CopyOriginalUserFilesOver();
-
+            RunStartupStage("InitialiseNetwork", [this]() {
+                network_set_env(_env);
+                chat_init();
+            });
+            bool graphicsLoaded = true;
             if (!gOpenRCT2NoGraphics)
             {
-                if (!LoadBaseGraphics())
-                {
-                    return false;
-                }
+                graphicsLoaded = RunStartupStage("LoadBaseGraphics", [this]() { return LoadBaseGraphics(); });
+            }
+
+            scanJobs.Join();
+            if (scanException != nullptr)
+            {
+                std::rethrow_exception(scanException);
+            }
+            if (!graphicsLoaded)
+            {
+                WriteStartupTrace();
+                return false;
+            }
+
 #ifdef __ENABLE_LIGHTFX__
+            if (!gOpenRCT2NoGraphics)
+            {
                 lightfx_init();
-#endif
             }
+#endif
 
             gScenarioTicks = 0;
             input_reset_place_obj_modifier();
@@ -470,6 +541,9 @@ namespace OpenRCT2
 
             _titleScreen = std::make_unique<TitleScreen>(*_gameState);
             _uiContext->Initialise();
+
+            WatchUserContentDirectories();
+            WriteStartupTrace();
             return true;
         }
 
@@ -709,6 +783,107 @@ namespace OpenRCT2
             return result;
         }
 
+        bool OpenLanguage()
+        {
+            try
+            {
+                _localisationService->OpenLanguage(gConfigGeneral.language, *_objectManager);
+            }
+            catch (const std::exception& e)
+            {
+                log_error("Failed to open configured language: %s", e.what());
+                try
+                {
+                    _localisationService->OpenLanguage(LANGUAGE_ENGLISH_UK, *_objectManager);
+                }
+                catch (const std::exception&)
+                {
+                    log_fatal("Failed to open fallback language: %s", e.what());
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Runs a stage of Initialise and records how long it took on which thread for the startup trace.
+         */
+        template<typename TFn> std::invoke_result_t<TFn> RunStartupStage(const char* name, TFn&& fn)
+        {
+            auto start = std::chrono::steady_clock::now();
+            if constexpr (std::is_void_v<std::invoke_result_t<TFn>>)
+            {
+                fn();
+                RecordStartupStage(name, start);
+            }
+            else
+            {
+                auto result = fn();
+                RecordStartupStage(name, start);
+                return result;
+            }
+        }
+
+        void RecordStartupStage(const char* name, std::chrono::steady_clock::time_point start)
+        {
+            auto end = std::chrono::steady_clock::now();
+            std::lock_guard<std::mutex> lock(_startupStagesMutex);
+            _startupStages.push_back({ name, std::this_thread::get_id(), start, end });
+        }
+
+        /**
+         * Writes the recorded startup stages to the file given by --startup-trace in the Chrome trace event format,
+         * which can be opened in chrome://tracing or Perfetto.
+         */
+        void WriteStartupTrace()
+        {
+            if (String::IsNullOrEmpty(gStartupTracePath))
+            {
+                return;
+            }
+
+            using namespace std::chrono;
+            auto toMicroseconds = [](steady_clock::duration duration) {
+                return static_cast<json_int_t>(duration_cast<microseconds>(duration).count());
+            };
+
+            // Number the threads in the order they started a stage, so the thread initialising the context is 0
+            std::vector<std::thread::id> threadIds;
+            json_t* jsonEvents = json_array();
+            for (const auto& stage : _startupStages)
+            {
+                auto threadIt = std::find(threadIds.begin(), threadIds.end(), stage.ThreadId);
+                if (threadIt == threadIds.end())
+                {
+                    threadIt = threadIds.insert(threadIds.end(), stage.ThreadId);
+                }
+
+                json_t* jsonEvent = json_object();
+                json_object_set_new(jsonEvent, "name", json_string(stage.Name.c_str()));
+                json_object_set_new(jsonEvent, "cat", json_string("startup"));
+                json_object_set_new(jsonEvent, "ph", json_string("X"));
+                json_object_set_new(jsonEvent, "ts", json_integer(toMicroseconds(stage.Start - _startupTime)));
+                json_object_set_new(jsonEvent, "dur", json_integer(toMicroseconds(stage.End - stage.Start)));
+                json_object_set_new(jsonEvent, "pid", json_integer(0));
+                json_object_set_new(jsonEvent, "tid", json_integer(std::distance(threadIds.begin(), threadIt)));
+                json_array_append_new(jsonEvents, jsonEvent);
+            }
+
+            json_t* jsonTrace = json_object();
+            json_object_set_new(jsonTrace, "traceEvents", jsonEvents);
+            json_object_set_new(jsonTrace, "displayTimeUnit", json_string("ms"));
+            try
+            {
+                Json::WriteToFile(gStartupTracePath, jsonTrace, JSON_INDENT(2));
+                Console::WriteLine("Startup trace written to %s", gStartupTracePath);
+            }
+            catch (const std::exception& e)
+            {
+                log_error("Unable to write startup trace: %s", e.what());
+            }
+            json_decref(jsonTrace);
+        }
+
         bool LoadBaseGraphics()
         {
             if (!gfx_load_g1(*_env))
@@ -945,6 +1120,7 @@ namespace OpenRCT2
                 _drawingEngine->BeginDraw();
                 _painter->Paint(*_drawingEngine);
                 _drawingEngine->EndDraw();
+                gfx_object_evict_image_data();
                 _drawingEngine->UpdateWindows();
             }
         }
@@ -990,6 +1166,7 @@ namespace OpenRCT2
                 _drawingEngine->BeginDraw();
                 _painter->Paint(*_drawingEngine);
                 _drawingEngine->EndDraw();
+                gfx_object_evict_image_data();
 
                 sprite_position_tween_restore();
 
@@ -1036,6 +1213,7 @@ namespace OpenRCT2
 #endif
 
             chat_update();
+            UpdateContentIndexes();
 #ifdef ENABLE_SCRIPTING
             _scriptEngine.Update();
 #endif
@@ -1043,6 +1221,112 @@ namespace OpenRCT2
             _uiContext->Update();
         }
 
+        void WatchUserContentDirectories()
+        {
+            WatchUserContentDirectory(DIRID::OBJECT, CONTENT_OBJECTS);
+            WatchUserContentDirectory(DIRID::TRACK, CONTENT_TRACK_DESIGNS);
+            WatchUserContentDirectory(DIRID::SCENARIO, CONTENT_SCENARIOS);
+        }
+
+        void WatchUserContentDirectory(DIRID dirId, uint8_t content)
+        {
+            auto path = _env->GetDirectoryPath(DIRBASE::USER, dirId);
+            try
+            {
+                auto watcher = std::make_unique<FileWatcher>(path);
+                watcher->OnFileChanged = [this, content](const std::string&) {
+                    std::lock_guard<std::mutex> lock(_changedContentMutex);
+                    _changedContent |= content;
+                    _lastContentChangeTick = platform_get_ticks();
+                };
+                _contentWatchers.push_back(std::move(watcher));
+            }
+            catch (const std::exception& e)
+            {
+                log_verbose("Unable to watch '%s' for changes: %s", path.c_str(), e.what());
+            }
+        }
+
+        /**
+         * Updates the indexes of the content that changed on disk. The files are indexed on a background thread, then
+         * the new items are swapped in here on the main thread once no window is showing the old ones.
+         */
+        void UpdateContentIndexes()
+        {
+            if (_contentIndexUpdate.valid())
+            {
+                if (_contentIndexUpdate.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                {
+                    return;
+                }
+                _contentIndexUpdatesToApply |= _contentIndexUpdate.get();
+            }
+
+            if ((_contentIndexUpdatesToApply & CONTENT_OBJECTS)
+                && window_find_by_class(WC_EDITOR_OBJECT_SELECTION) == nullptr)
+            {
+                _objectRepository->ApplyIndexUpdate();
+                _contentIndexUpdatesToApply &= ~CONTENT_OBJECTS;
+            }
+            if (_contentIndexUpdatesToApply & CONTENT_TRACK_DESIGNS)
+            {
+                _trackDesignRepository->ApplyIndexUpdate();
+                _contentIndexUpdatesToApply &= ~CONTENT_TRACK_DESIGNS;
+            }
+            if ((_contentIndexUpdatesToApply & CONTENT_SCENARIOS)
+                && window_find_by_class(WC_SCENARIO_SELECT) == nullptr)
+            {
+                _scenarioRepository->ApplyIndexUpdate();
+                _contentIndexUpdatesToApply &= ~CONTENT_SCENARIOS;
+            }
+
+            // Wait for the files to settle, and for the previous update to be applied, before indexing again
+            uint8_t changedContent;
+            {
+                std::lock_guard<std::mutex> lock(_changedContentMutex);
+                if (_changedContent == 0 || _contentIndexUpdatesToApply != 0
+                    || platform_get_ticks() - _lastContentChangeTick < 1000)
+                {
+                    return;
+                }
+                changedContent = _changedContent;
+                _changedContent = 0;
+
+                // Track designs are resolved against the object index, so they wait for its update to be applied
+                if ((changedContent & CONTENT_OBJECTS) && (changedContent & CONTENT_TRACK_DESIGNS))
+                {
+                    changedContent &= ~CONTENT_TRACK_DESIGNS;
+                    _changedContent |= CONTENT_TRACK_DESIGNS;
+                }
+            }
+
+            if (changedContent & CONTENT_OBJECTS)
+            {
+                _objectRepository->PrepareIndexUpdate();
+            }
+            if (changedContent & CONTENT_TRACK_DESIGNS)
+            {
+                _trackDesignRepository->PrepareIndexUpdate();
+            }
+
+            auto language = _localisationService->GetCurrentLanguage();
+            _contentIndexUpdate = std::async(std::launch::async, [this, changedContent, language]() {
+                if (changedContent & CONTENT_OBJECTS)
+                {
+                    _objectRepository->UpdateIndex(language);
+                }
+                if (changedContent & CONTENT_TRACK_DESIGNS)
+                {
+                    _trackDesignRepository->UpdateIndex(language);
+                }
+                if (changedContent & CONTENT_SCENARIOS)
+                {
+                    _scenarioRepository->UpdateIndex(language);
+                }
+                return changedContent;
+            });
+        }
+
         /**
          * Ensure that the custom user content folders are present
          */
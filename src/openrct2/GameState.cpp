@@ -156,6 +156,10 @@ void GameState::Update()
             network_process_pending();
 
             GameActions::ProcessQueue();
+
+            // Actions run while paused release tile element runs too, make them available again without waiting
+            // for the next tick
+            map_recycle_tile_elements();
         }
     }
 
@@ -227,6 +231,11 @@ void GameState::Update()
 
 void GameState::UpdateLogic()
 {
+#ifdef ENABLE_SCRIPTING
+    auto& scriptEngine = GetContext()->GetScriptEngine();
+    scriptEngine.BeginTick();
+#endif
+
     gScreenAge++;
     if (gScreenAge == 0)
         gScreenAge--;
@@ -280,6 +289,9 @@ void GameState::UpdateLogic()
 
     scenario_update();
     climate_update();
+    // Runs released by last tick's inserts can now be reused
+    map_recycle_tile_elements();
+    map_compact_tile_elements();
     map_update_tiles();
     // Temporarily remove provisional paths to prevent peep from interacting with them
     map_remove_provisional_elements();
@@ -325,13 +337,15 @@ void GameState::UpdateLogic()
     gSavedAge++;
 
 #ifdef ENABLE_SCRIPTING
-    auto& hookEngine = GetContext()->GetScriptEngine().GetHookEngine();
+    auto& hookEngine = scriptEngine.GetHookEngine();
     hookEngine.Call(HOOK_TYPE::INTERVAL_TICK, true);
 
     if (day != _date.GetDay())
     {
         hookEngine.Call(HOOK_TYPE::INTERVAL_DAY, true);
     }
+
+    scriptEngine.EndTick();
 #endif
 }
 
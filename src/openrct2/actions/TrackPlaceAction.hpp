@@ -617,6 +617,8 @@ public:
             {
                 tileElement->SetGhost(true);
             }
+            // The element was inserted before it became track, make sure track lookups see it
+            map_mark_tile_elements_changed(mapLoc);
 
             switch (_trackType)
             {
@@ -447,6 +447,7 @@ public:
                 footpath_remove_edges_at(mapLoc, tileElement);
             }
             tile_element_remove(tileElement);
+            map_mark_tile_elements_changed(mapLoc);
             sub_6CB945(ride);
             if (!(GetFlags() & GAME_COMMAND_FLAG_GHOST))
             {
@@ -0,0 +1,159 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../Context.h"
+#    include "../OpenRCT2.h"
+#    include "../core/Console.hpp"
+#    include "../localisation/Language.h"
+#    include "../localisation/Localisation.h"
+#    include "../platform/platform.h"
+
+#    include <benchmark/benchmark.h>
+#    include <cstring>
+#    include <vector>
+
+// Zeroed arguments are valid for every format code: numbers format as 0, string ids as string 0 and
+// string pointers as null. The buffer only needs to be large enough for the hungriest string.
+static uint8_t _benchFormatArgs[256];
+
+static std::vector<rct_string_id> GetCompiledStringIds()
+{
+    std::vector<rct_string_id> stringIds;
+    for (rct_string_id stringId = 0; stringId < USER_STRING_START; stringId++)
+    {
+        if (language_get_format_program(stringId) != nullptr)
+        {
+            stringIds.push_back(stringId);
+        }
+    }
+    return stringIds;
+}
+
+static size_t CountMismatches(const std::vector<rct_string_id>& stringIds)
+{
+    size_t mismatches = 0;
+    char compiled[512];
+    char raw[512];
+    for (auto stringId : stringIds)
+    {
+        format_string(compiled, sizeof(compiled), stringId, _benchFormatArgs);
+        format_string_raw(raw, sizeof(raw), language_get_string(stringId), _benchFormatArgs);
+        if (std::strcmp(compiled, raw) != 0)
+        {
+            Console::Error::WriteLine("String %u formats differently: \"%s\" != \"%s\"", stringId, compiled, raw);
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+static void BM_format_string_raw(benchmark::State& state, const std::vector<rct_string_id>& stringIds)
+{
+    char buffer[512];
+    for (auto _ : state)
+    {
+        for (auto stringId : stringIds)
+        {
+            format_string_raw(buffer, sizeof(buffer), language_get_string(stringId), _benchFormatArgs);
+            benchmark::DoNotOptimize(buffer);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * stringIds.size());
+}
+
+static void BM_format_string_compiled(benchmark::State& state, const std::vector<rct_string_id>& stringIds)
+{
+    char buffer[512];
+    for (auto _ : state)
+    {
+        for (auto stringId : stringIds)
+        {
+            format_string(buffer, sizeof(buffer), stringId, _benchFormatArgs);
+            benchmark::DoNotOptimize(buffer);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * stringIds.size());
+}
+
+static int cmdline_for_bench_format_string(int argc, const char** argv)
+{
+    core_init();
+    gOpenRCT2Headless = true;
+    auto context = OpenRCT2::CreateContext();
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Unable to initialise context.");
+        return -1;
+    }
+
+    auto stringIds = GetCompiledStringIds();
+    Console::WriteLine("Benchmarking %zu compiled strings.", stringIds.size());
+    auto mismatches = CountMismatches(stringIds);
+    if (mismatches != 0)
+    {
+        Console::Error::WriteLine("%zu strings format differently when compiled.", mismatches);
+        return -1;
+    }
+
+    benchmark::RegisterBenchmark("format_string_raw", BM_format_string_raw, stringIds);
+    benchmark::RegisterBenchmark("format_string_compiled", BM_format_string_compiled, stringIds);
+
+    // Google benchmark reorders argv, so present a copy of the pointers with a dummy binary name.
+    std::vector<char*> argv_for_benchmark;
+    argv_for_benchmark.push_back(nullptr);
+    for (int i = 0; i < argc; i++)
+    {
+        argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+    }
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchFormatString(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = cmdline_for_bench_format_string(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchFormatString(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchFormatStringCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "[--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchFormatString),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchFormatString), CommandTableEnd
+#endif // USE_BENCHMARK
+};
@@ -0,0 +1,210 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../Context.h"
+#    include "../Intro.h"
+#    include "../OpenRCT2.h"
+#    include "../platform/Platform2.h"
+#    include "../ride/Track.h"
+#    include "../ride/Vehicle.h"
+#    include "../ride/VehicleSubpositionData.h"
+#    include "../world/Sprite.h"
+
+#    include <benchmark/benchmark.h>
+#    include <cstdint>
+#    include <memory>
+#    include <string>
+#    include <utility>
+#    include <vector>
+
+using namespace OpenRCT2;
+
+static std::unique_ptr<IContext> _context;
+
+static bool load_park(const std::string& parkFileName)
+{
+    if (!_context->LoadParkFromFile(parkFileName))
+    {
+        return false;
+    }
+    gIntroState = IntroState::None;
+    gScreenFlags = SCREEN_FLAGS_PLAYING;
+    return true;
+}
+
+/**
+ * Walks every subposition of the given track pieces from start to end, the same lookups cars make while they step
+ * along the track.
+ */
+static void BM_vehicle_move_info(
+    benchmark::State& state, const std::vector<std::pair<VehicleTrackSubposition, int32_t>> trackPieces)
+{
+    int64_t lookups = 0;
+    for (auto _ : state)
+    {
+        for (const auto& [trackSubposition, typeAndDirection] : trackPieces)
+        {
+            auto list = vehicle_get_packed_move_info(trackSubposition, typeAndDirection);
+            for (uint16_t i = 0; i < list.size; i++)
+            {
+                auto moveInfo = list.info[i].Unpack();
+                benchmark::DoNotOptimize(moveInfo);
+            }
+            lookups += list.size;
+        }
+    }
+    state.SetItemsProcessed(lookups);
+}
+
+static void BM_vehicle_update_all(benchmark::State& state, const std::string parkFileName)
+{
+    if (!load_park(parkFileName))
+    {
+        state.SkipWithError("Failed to load park!");
+        return;
+    }
+
+    size_t numCars = 0;
+    for (auto train : EntityList<Vehicle>(EntityListId::TrainHead))
+    {
+        for (auto car = train; car != nullptr; car = GetEntity<Vehicle>(car->next_vehicle_on_train))
+        {
+            numCars++;
+        }
+    }
+
+    for (auto _ : state)
+    {
+        vehicle_update_all();
+    }
+    state.SetItemsProcessed(state.iterations() * numCars);
+}
+
+static std::vector<std::pair<VehicleTrackSubposition, int32_t>> get_all_track_pieces()
+{
+    std::vector<std::pair<VehicleTrackSubposition, int32_t>> trackPieces;
+    for (int32_t trackType = 0; trackType < TRACK_ELEM_COUNT; trackType++)
+    {
+        for (int32_t direction = 0; direction < NumOrthogonalDirections; direction++)
+        {
+            trackPieces.emplace_back(VehicleTrackSubposition::Default, (trackType << 2) | direction);
+        }
+    }
+    return trackPieces;
+}
+
+static std::vector<std::pair<VehicleTrackSubposition, int32_t>> get_park_track_pieces()
+{
+    std::vector<std::pair<VehicleTrackSubposition, int32_t>> trackPieces;
+    for (auto train : EntityList<Vehicle>(EntityListId::TrainHead))
+    {
+        for (auto car = train; car != nullptr; car = GetEntity<Vehicle>(car->next_vehicle_on_train))
+        {
+            trackPieces.emplace_back(car->TrackSubposition, car->track_type);
+        }
+    }
+    return trackPieces;
+}
+
+static int cmdline_for_bench_vehicle_motion(int argc, const char** argv)
+{
+    // Register a park independent benchmark walking every piece of regular track
+    benchmark::RegisterBenchmark("move_info/all_track", BM_vehicle_move_info, get_all_track_pieces());
+
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+
+    core_init();
+    gOpenRCT2Headless = true;
+    _context = CreateContext();
+    if (!_context->Initialise())
+    {
+        log_error("Failed to initialise context!");
+        _context = nullptr;
+        return -1;
+    }
+
+    // Extract file names from argument list. If there is no such file, consider it benchmark option.
+    for (int i = 0; i < argc; i++)
+    {
+        if (Platform::FileExists(argv[i]))
+        {
+            // Register benchmarks for the park if it loads
+            if (load_park(argv[i]))
+            {
+                auto name = std::string(argv[i]);
+                benchmark::RegisterBenchmark(
+                    ("move_info/" + name).c_str(), BM_vehicle_move_info, get_park_track_pieces());
+                benchmark::RegisterBenchmark(("vehicle_update_all/" + name).c_str(), BM_vehicle_update_all, name);
+            }
+            else
+            {
+                log_error("Failed to load park %s", argv[i]);
+            }
+        }
+        else
+        {
+            argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+        }
+    }
+    // Update argc with all the changes made
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+    {
+        _context = nullptr;
+        return -1;
+    }
+    ::benchmark::RunSpecifiedBenchmarks();
+    _context = nullptr;
+    return 0;
+}
+
+static exitcode_t HandleBenchVehicleMotion(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = cmdline_for_bench_vehicle_motion(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchVehicleMotion(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchVehicleMotionCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "[<file>]... [--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchVehicleMotion),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchVehicleMotion), CommandTableEnd
+#endif // USE_BENCHMARK
+};
@@ -57,6 +57,7 @@ static utf8* _userDataPath = nullptr;
 static utf8* _openrct2DataPath = nullptr;
 static utf8* _rct1DataPath = nullptr;
 static utf8* _rct2DataPath = nullptr;
+static utf8* _startupTracePath = nullptr;
 static bool _silentBreakpad = false;
 
 // clang-format off
@@ -78,6 +79,7 @@ static constexpr const CommandLineOptionDefinition StandardOptions[]
     { CMDLINE_TYPE_STRING,  &_openrct2DataPath, NAC, "openrct2-data-path", "path to the OpenRCT2 data directory (containing languages)" },
     { CMDLINE_TYPE_STRING,  &_rct1DataPath,     NAC, "rct1-data-path",     "path to the RollerCoaster Tycoon 1 data directory (containing data/csg1.dat)" },
     { CMDLINE_TYPE_STRING,  &_rct2DataPath,     NAC, "rct2-data-path",     "path to the RollerCoaster Tycoon 2 data directory (containing data/g1.dat)" },
+    { CMDLINE_TYPE_STRING,  &_startupTracePath, NAC, "startup-trace",      "write the timings of the startup stages to a Chrome trace file" },
 #ifdef USE_BREAKPAD
     { CMDLINE_TYPE_SWITCH,  &_silentBreakpad,  NAC, "silent-breakpad",   "make breakpad crash reporting silent"                       },
 #endif // USE_BREAKPAD
@@ -140,6 +142,8 @@ const CommandLineCommand CommandLine::RootCommands[]
     DefineSubCommand("sprite",          CommandLine::SpriteCommands           ),
     DefineSubCommand("benchgfx",        CommandLine::BenchGfxCommands         ),
     DefineSubCommand("benchspritesort", CommandLine::BenchSpriteSortCommands  ),
+    DefineSubCommand("benchformatstring", CommandLine::BenchFormatStringCommands),
+    DefineSubCommand("benchvehiclemotion", CommandLine::BenchVehicleMotionCommands),
     DefineSubCommand("simulate",        CommandLine::SimulateCommands         ),
     CommandTableEnd
 };
@@ -224,6 +228,14 @@ exitcode_t CommandLine::HandleCommandDefault()
         Memory::Free(_rct2DataPath);
     }
 
+    if (_startupTracePath != nullptr)
+    {
+        utf8 absolutePath[MAX_PATH]{};
+        Path::GetAbsolute(absolutePath, std::size(absolutePath), _startupTracePath);
+        String::Set(gStartupTracePath, std::size(gStartupTracePath), absolutePath);
+        Memory::Free(_startupTracePath);
+    }
+
     if (_password != nullptr)
     {
         String::Set(gCustomPassword, std::size(gCustomPassword), _password);
@@ -25,16 +25,19 @@ static constexpr const CommandLineOptionDefinition ScreenshotOptionsDef[]
     { CMDLINE_TYPE_SWITCH,  &_options.remove_litter, NAC, "remove-litter", "remove litter for the screenshot" },
     { CMDLINE_TYPE_SWITCH,  &_options.tidy_up_park,  NAC, "tidy-up-park",  "clear grass, water plants, fix vandalism and remove litter" },
     { CMDLINE_TYPE_SWITCH,  &_options.transparent,   NAC, "transparent",   "make the background transparent" },
+    { CMDLINE_TYPE_INTEGER, &_options.compression_level, NAC, "compression-level", "PNG compression level (0 = uncompressed, 1 = fastest, ..., 9 = smallest)" },
     OptionTableEnd
 };
 
 static exitcode_t HandleScreenshot(CommandLineArgEnumerator *argEnumerator);
+static exitcode_t HandleScreenshotBatch(CommandLineArgEnumerator *argEnumerator);
 
 const CommandLineCommand CommandLine::ScreenshotCommands[]
 {
     // Main commands
     DefineCommand("", "<file> <output_image> <width> <height> [<x> <y> <zoom> <rotation>]", ScreenshotOptionsDef, HandleScreenshot),
     DefineCommand("", "<file> <output_image> giant <zoom> <rotation>",                      ScreenshotOptionsDef, HandleScreenshot),
+    DefineCommand("batch", "[<job_file>]",                                                  ScreenshotOptionsDef, HandleScreenshotBatch),
     CommandTableEnd
 };
 // clang-format on
@@ -50,3 +53,15 @@ static exitcode_t HandleScreenshot(CommandLineArgEnumerator* argEnumerator)
     }
     return EXITCODE_OK;
 }
+
+static exitcode_t HandleScreenshotBatch(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = cmdline_for_screenshot_batch(argv, argc, &_options);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
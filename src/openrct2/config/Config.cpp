@@ -213,6 +213,7 @@ namespace Config
             model->show_real_names_of_guests = reader->GetBoolean("show_real_names_of_guests", true);
             model->allow_early_completion = reader->GetBoolean("allow_early_completion", false);
             model->transparent_screenshot = reader->GetBoolean("transparent_screenshot", true);
+            model->screenshot_compression_level = reader->GetInt32("screenshot_compression_level", 6);
         }
     }
 
@@ -288,6 +289,7 @@ namespace Config
         writer->WriteBoolean("allow_early_completion", model->allow_early_completion);
         writer->WriteEnum<int32_t>("virtual_floor_style", model->virtual_floor_style, Enum_VirtualFloorStyle);
         writer->WriteBoolean("transparent_screenshot", model->transparent_screenshot);
+        writer->WriteInt32("screenshot_compression_level", model->screenshot_compression_level);
     }
 
     static void ReadInterface(IIniReader* reader)
@@ -528,6 +530,8 @@ namespace Config
         {
             auto model = &gConfigPlugin;
             model->enable_hot_reloading = reader->GetBoolean("enable_hot_reloading", false);
+            model->tick_budget = reader->GetInt32("tick_budget", 0);
+            model->stop_plugins_over_budget = reader->GetBoolean("stop_plugins_over_budget", false);
         }
     }
 
@@ -536,6 +540,8 @@ namespace Config
         auto model = &gConfigPlugin;
         writer->WriteSection("plugin");
         writer->WriteBoolean("enable_hot_reloading", model->enable_hot_reloading);
+        writer->WriteInt32("tick_budget", model->tick_budget);
+        writer->WriteBoolean("stop_plugins_over_budget", model->stop_plugins_over_budget);
     }
 
     static bool SetDefaults()
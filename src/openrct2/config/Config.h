@@ -52,6 +52,7 @@ struct GeneralConfiguration
     bool disable_lightning_effect;
     bool show_guest_purchases;
     bool transparent_screenshot;
+    int32_t screenshot_compression_level;
 
     // Localisation
     int32_t language;
@@ -198,6 +199,8 @@ struct FontConfiguration
 struct PluginConfiguration
 {
     bool enable_hot_reloading;
+    int32_t tick_budget;
+    bool stop_plugins_over_budget;
 };
 
 enum SORT
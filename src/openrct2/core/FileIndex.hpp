@@ -15,37 +15,39 @@
 #include "FileScanner.h"
 #include "FileStream.hpp"
 #include "JobPool.hpp"
+#include "MemoryStream.h"
 #include "Path.hpp"
 
+#include <atomic>
 #include <chrono>
-#include <list>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 template<typename TItem> class FileIndex
 {
 private:
-    struct DirectoryStats
+    struct FileRecord
     {
-        uint32_t TotalFiles = 0;
-        uint64_t TotalFileSize = 0;
-        uint32_t FileDateModifiedChecksum = 0;
-        uint32_t PathChecksum = 0;
+        std::string Path;
+        uint64_t Size = 0;
+        uint64_t LastModified = 0;
+        uint64_t ContentHash = 0;
     };
 
-    struct ScanResult
+    struct IndexEntry
     {
-        DirectoryStats const Stats;
-        std::vector<std::string> const Files;
-
-        ScanResult(DirectoryStats stats, std::vector<std::string> files)
-            : Stats(stats)
-            , Files(files)
-        {
-        }
+        FileRecord File;
+        std::optional<TItem> Item;
+        // Content hash of the indexed record of a file that may only have been touched, its item is kept in Item
+        std::optional<uint64_t> IndexedContentHash;
     };
 
+    using IndexedFiles = std::unordered_map<std::string, IndexEntry>;
+
     struct FileIndexHeader
     {
         uint32_t HeaderSize = sizeof(FileIndexHeader);
@@ -53,12 +55,11 @@ private:
         uint8_t VersionA = 0;
         uint8_t VersionB = 0;
         uint16_t LanguageId = 0;
-        DirectoryStats Stats;
-        uint32_t NumItems = 0;
+        uint32_t NumFiles = 0;
     };
 
     // Index file format version which when incremented forces a rebuild
-    static constexpr uint8_t FILE_INDEX_VERSION = 4;
+    static constexpr uint8_t FILE_INDEX_VERSION = 5;
 
     std::string const _name;
     uint32_t const _magicNumber;
@@ -94,32 +95,24 @@ public:
     virtual ~FileIndex() = default;
 
     /**
-     * Queries and directories and loads the index header. If the index is up to date,
-     * the items are loaded from the index and returned, otherwise the index is rebuilt.
+     * Queries the directories and loads the index. Items of files that are unchanged since the index was written are
+     * taken from the index, only files that were added or modified are loaded again and removed files are dropped.
      */
     std::vector<TItem> LoadOrBuild(int32_t language) const
     {
-        std::vector<TItem> items;
-        auto scanResult = Scan();
-        auto readIndexResult = ReadIndexFile(language, scanResult.Stats);
-        if (std::get<0>(readIndexResult))
-        {
-            // Index was loaded
-            items = std::get<1>(readIndexResult);
-        }
-        else
-        {
-            // Index was not loaded
-            items = Build(language, scanResult);
-        }
-        return items;
+        auto files = Scan();
+        auto indexedFiles = ReadIndexFile(language);
+        return Build(language, files, indexedFiles);
     }
 
+    /**
+     * Loads every file again, regardless of whether it has changed since the index was written.
+     */
     std::vector<TItem> Rebuild(int32_t language) const
     {
-        auto scanResult = Scan();
-        auto items = Build(language, scanResult);
-        return items;
+        auto files = Scan();
+        IndexedFiles indexedFiles;
+        return Build(language, files, indexedFiles);
     }
 
 protected:
@@ -129,6 +122,16 @@ protected:
      */
     virtual std::tuple<bool, TItem> Create(int32_t language, const std::string& path) const abstract;
 
+    /**
+     * Creates the item from the contents of the file, which the index has already read to hash them. Override this
+     * when the item can be read from a stream so that the file is not read twice.
+     */
+    virtual std::tuple<bool, TItem> Create(
+        int32_t language, const std::string& path, [[maybe_unused]] OpenRCT2::IStream* stream) const
+    {
+        return Create(language, path);
+    }
+
     /**
      * Serialises an index item to the given stream.
      */
@@ -140,10 +143,9 @@ protected:
     virtual TItem Deserialise(OpenRCT2::IStream* stream) const abstract;
 
 private:
-    ScanResult Scan() const
+    std::vector<FileRecord> Scan() const
     {
-        DirectoryStats stats{};
-        std::vector<std::string> files;
+        std::vector<FileRecord> files;
         for (const auto& directory : SearchPaths)
         {
             auto absoluteDirectory = Path::GetAbsolute(directory);
@@ -154,30 +156,26 @@ private:
             while (scanner->Next())
             {
                 auto fileInfo = scanner->GetFileInfo();
-                auto path = std::string(scanner->GetPath());
 
-                files.push_back(path);
-
-                stats.TotalFiles++;
-                stats.TotalFileSize += fileInfo->Size;
-                stats.FileDateModifiedChecksum ^= static_cast<uint32_t>(fileInfo->LastModified >> 32)
-                    ^ static_cast<uint32_t>(fileInfo->LastModified & 0xFFFFFFFF);
-                stats.FileDateModifiedChecksum = ror32(stats.FileDateModifiedChecksum, 5);
-                stats.PathChecksum += GetPathChecksum(path);
+                FileRecord file;
+                file.Path = std::string(scanner->GetPath());
+                file.Size = fileInfo->Size;
+                file.LastModified = fileInfo->LastModified;
+                files.push_back(std::move(file));
             }
             delete scanner;
         }
-        return ScanResult(stats, files);
+        return files;
     }
 
     void BuildRange(
-        int32_t language, const ScanResult& scanResult, size_t rangeStart, size_t rangeEnd, std::vector<TItem>& items,
-        std::atomic<size_t>& processed, std::mutex& printLock) const
+        int32_t language, std::vector<IndexEntry>& entries, const std::vector<size_t>& entryIndices, size_t rangeStart,
+        size_t rangeEnd, std::atomic<size_t>& processed, std::atomic<size_t>& numUnchanged, std::mutex& printLock) const
     {
-        items.reserve(rangeEnd - rangeStart);
         for (size_t i = rangeStart; i < rangeEnd; i++)
         {
-            const auto& filePath = scanResult.Files.at(i);
+            auto& entry = entries[entryIndices[i]];
+            const auto& filePath = entry.File.Path;
 
             if (_log_levels[static_cast<uint8_t>(DiagnosticLevel::Verbose)])
             {
@@ -185,31 +183,93 @@ private:
                 log_verbose("FileIndex:Indexing '%s'", filePath.c_str());
             }
 
-            auto item = Create(language, filePath);
-            if (std::get<0>(item))
+            // The file is read once, both to hash it and to create its item
+            std::vector<uint8_t> data;
+            bool isReadable = true;
+            try
+            {
+                data = File::ReadAllBytes(filePath);
+            }
+            catch (const std::exception&)
+            {
+                isReadable = false;
+            }
+            entry.File.ContentHash = isReadable ? GetContentHash(data) : 0;
+
+            // A file that was only touched, or copied over with the same contents, keeps its indexed item
+            if (entry.IndexedContentHash == entry.File.ContentHash)
+            {
+                numUnchanged++;
+            }
+            else
             {
-                items.push_back(std::get<1>(item));
+                entry.Item.reset();
+                auto ms = OpenRCT2::MemoryStream(data.data(), data.size());
+                auto item = isReadable ? Create(language, filePath, &ms) : Create(language, filePath);
+                if (std::get<0>(item))
+                {
+                    entry.Item = std::move(std::get<1>(item));
+                }
             }
 
             processed++;
         }
     }
 
-    std::vector<TItem> Build(int32_t language, const ScanResult& scanResult) const
+    std::vector<TItem> Build(int32_t language, const std::vector<FileRecord>& files, IndexedFiles& indexedFiles) const
     {
-        std::vector<TItem> allItems;
-        Console::WriteLine("Building %s (%zu items)", _name.c_str(), scanResult.Files.size());
-
         auto startTime = std::chrono::high_resolution_clock::now();
 
-        const size_t totalCount = scanResult.Files.size();
+        // Take over the entries of unchanged files from the index and collect the files that need to be loaded
+        std::vector<IndexEntry> entries(files.size());
+        std::vector<size_t> changedEntries;
+        size_t numReused = 0;
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            auto& entry = entries[i];
+            entry.File = files[i];
+
+            auto indexedFile = indexedFiles.find(entry.File.Path);
+            if (indexedFile != indexedFiles.end() && entry.File.Size == indexedFile->second.File.Size)
+            {
+                entry.Item = std::move(indexedFile->second.Item);
+                numReused++;
+                if (entry.File.LastModified == indexedFile->second.File.LastModified)
+                {
+                    entry.File.ContentHash = indexedFile->second.File.ContentHash;
+                    continue;
+                }
+
+                // Only touched if the contents hash the same, which is checked along with the changed files
+                entry.IndexedContentHash = indexedFile->second.File.ContentHash;
+            }
+            changedEntries.push_back(i);
+        }
+        const size_t numRemoved = indexedFiles.size() - numReused;
+
+        if (changedEntries.empty() && numRemoved == 0)
+        {
+            // Directory is the same, just use the saved items
+            return GetItems(entries);
+        }
+
+        if (indexedFiles.empty())
+        {
+            Console::WriteLine("Building %s (%zu items)", _name.c_str(), changedEntries.size());
+        }
+        else
+        {
+            Console::WriteLine(
+                "Updating %s (%zu added or modified, %zu removed)", _name.c_str(), changedEntries.size(), numRemoved);
+        }
+
+        const size_t totalCount = changedEntries.size();
+        std::atomic<size_t> numUnchanged = ATOMIC_VAR_INIT(0);
         if (totalCount > 0)
         {
             JobPool jobPool;
             std::mutex printLock; // For verbose prints.
 
-            std::list<std::vector<TItem>> containers;
-
             size_t stepSize = 100; // Handpicked, seems to work well with 4/8 cores.
 
             std::atomic<size_t> processed = ATOMIC_VAR_INIT(0);
@@ -226,36 +286,44 @@ private:
                     stepSize = totalCount - rangeStart;
                 }
 
-                auto& items = containers.emplace_back();
-
                 jobPool.AddTask(std::bind(
-                    &FileIndex<TItem>::BuildRange, this, language, std::cref(scanResult), rangeStart, rangeStart + stepSize,
-                    std::ref(items), std::ref(processed), std::ref(printLock)));
+                    &FileIndex<TItem>::BuildRange, this, language, std::ref(entries), std::cref(changedEntries),
+                    rangeStart, rangeStart + stepSize, std::ref(processed), std::ref(numUnchanged), std::ref(printLock)));
 
                 reportProgress();
             }
 
             jobPool.Join(reportProgress);
-
-            for (auto&& itr : containers)
-            {
-                allItems.insert(allItems.end(), itr.begin(), itr.end());
-            }
         }
 
-        WriteIndexFile(language, scanResult.Stats, allItems);
+        WriteIndexFile(language, entries);
 
         auto endTime = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration<float>(endTime - startTime);
-        Console::WriteLine("Finished building %s in %.2f seconds.", _name.c_str(), duration.count());
+        Console::WriteLine(
+            "Finished building %s in %.2f seconds (%zu files only touched).", _name.c_str(), duration.count(),
+            numUnchanged.load());
 
-        return allItems;
+        return GetItems(entries);
     }
 
-    std::tuple<bool, std::vector<TItem>> ReadIndexFile(int32_t language, const DirectoryStats& stats) const
+    static std::vector<TItem> GetItems(std::vector<IndexEntry>& entries)
     {
-        bool loadedItems = false;
         std::vector<TItem> items;
+        items.reserve(entries.size());
+        for (auto& entry : entries)
+        {
+            if (entry.Item)
+            {
+                items.push_back(std::move(*entry.Item));
+            }
+        }
+        return items;
+    }
+
+    IndexedFiles ReadIndexFile(int32_t language) const
+    {
+        IndexedFiles indexedFiles;
         if (File::Exists(_indexPath))
         {
             try
@@ -263,22 +331,27 @@ private:
                 log_verbose("FileIndex:Loading index: '%s'", _indexPath.c_str());
                 auto fs = OpenRCT2::FileStream(_indexPath, OpenRCT2::FILE_MODE_OPEN);
 
-                // Read header, check if we need to re-scan
+                // Read header, a different format or language requires every file to be loaded again
                 auto header = fs.ReadValue<FileIndexHeader>();
                 if (header.HeaderSize == sizeof(FileIndexHeader) && header.MagicNumber == _magicNumber
-                    && header.VersionA == FILE_INDEX_VERSION && header.VersionB == _version && header.LanguageId == language
-                    && header.Stats.TotalFiles == stats.TotalFiles && header.Stats.TotalFileSize == stats.TotalFileSize
-                    && header.Stats.FileDateModifiedChecksum == stats.FileDateModifiedChecksum
-                    && header.Stats.PathChecksum == stats.PathChecksum)
+                    && header.VersionA == FILE_INDEX_VERSION && header.VersionB == _version
+                    && header.LanguageId == language)
                 {
-                    items.reserve(header.NumItems);
-                    // Directory is the same, just read the saved items
-                    for (uint32_t i = 0; i < header.NumItems; i++)
+                    indexedFiles.reserve(header.NumFiles);
+                    for (uint32_t i = 0; i < header.NumFiles; i++)
                     {
-                        auto item = Deserialise(&fs);
-                        items.push_back(item);
+                        IndexEntry entry;
+                        entry.File.Path = fs.ReadStdString();
+                        entry.File.Size = fs.ReadValue<uint64_t>();
+                        entry.File.LastModified = fs.ReadValue<uint64_t>();
+                        entry.File.ContentHash = fs.ReadValue<uint64_t>();
+                        if (fs.ReadValue<uint8_t>() != 0)
+                        {
+                            entry.Item = Deserialise(&fs);
+                        }
+                        auto path = entry.File.Path;
+                        indexedFiles.emplace(std::move(path), std::move(entry));
                     }
-                    loadedItems = true;
                 }
                 else
                 {
@@ -289,12 +362,13 @@ private:
             {
                 Console::Error::WriteLine("Unable to load index: '%s'.", _indexPath.c_str());
                 Console::Error::WriteLine("%s", e.what());
+                indexedFiles.clear();
             }
         }
-        return std::make_tuple(loadedItems, items);
+        return indexedFiles;
     }
 
-    void WriteIndexFile(int32_t language, const DirectoryStats& stats, const std::vector<TItem>& items) const
+    void WriteIndexFile(int32_t language, const std::vector<IndexEntry>& entries) const
     {
         try
         {
@@ -308,14 +382,21 @@ private:
             header.VersionA = FILE_INDEX_VERSION;
             header.VersionB = _version;
             header.LanguageId = language;
-            header.Stats = stats;
-            header.NumItems = static_cast<uint32_t>(items.size());
+            header.NumFiles = static_cast<uint32_t>(entries.size());
             fs.WriteValue(header);
 
-            // Write items
-            for (const auto& item : items)
+            // Write a record for every file, including those without an item so they are not loaded again
+            for (const auto& entry : entries)
             {
-                Serialise(&fs, item);
+                fs.WriteString(entry.File.Path);
+                fs.WriteValue<uint64_t>(entry.File.Size);
+                fs.WriteValue<uint64_t>(entry.File.LastModified);
+                fs.WriteValue<uint64_t>(entry.File.ContentHash);
+                fs.WriteValue<uint8_t>(entry.Item ? 1 : 0);
+                if (entry.Item)
+                {
+                    Serialise(&fs, *entry.Item);
+                }
             }
         }
         catch (const std::exception& e)
@@ -325,18 +406,17 @@ private:
         }
     }
 
-    static uint32_t GetPathChecksum(const std::string& path)
+    /**
+     * Gets the FNV-1a hash of the contents of a file.
+     */
+    static uint64_t GetContentHash(const std::vector<uint8_t>& data)
     {
-        uint32_t hash = 0xD8430DED;
-        for (const utf8* ch = path.c_str(); *ch != '\0'; ch++)
+        uint64_t hash = 0xCBF29CE484222325;
+        for (auto b : data)
         {
-            hash += (*ch);
-            hash += (hash << 10);
-            hash ^= (hash >> 6);
+            hash ^= b;
+            hash *= 0x100000001B3;
         }
-        hash += (hash << 3);
-        hash ^= (hash >> 11);
-        hash += (hash << 15);
         return hash;
     }
 };
@@ -60,7 +60,7 @@ void FileWatcher::FileDescriptor::Close()
 
 FileWatcher::WatchDescriptor::WatchDescriptor(int fd, const std::string& path)
     : Fd(fd)
-    , Wd(inotify_add_watch(fd, path.c_str(), IN_CLOSE_WRITE))
+    , Wd(inotify_add_watch(fd, path.c_str(), IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE))
     , Path(path)
 {
     if (Wd >= 0)
@@ -79,6 +79,41 @@ FileWatcher::WatchDescriptor::~WatchDescriptor()
     inotify_rm_watch(Fd, Wd);
     log_verbose("FileWatcher: inotify watch removed");
 }
+
+void FileWatcher::AddWatches(const std::string& directoryPath)
+{
+    _watchDescs.emplace_back(_fileDesc.Fd, directoryPath);
+    for (auto& p : fs::recursive_directory_iterator(directoryPath))
+    {
+        if (p.status().type() == fs::file_type::directory)
+        {
+            _watchDescs.emplace_back(_fileDesc.Fd, p.path().string());
+        }
+    }
+}
+
+/**
+ * inotify does not watch new sub directories by itself, so watch them now and report the files that were put in them
+ * before the watches were added.
+ */
+void FileWatcher::OnDirectoryAdded(const std::string& directoryPath)
+{
+    try
+    {
+        AddWatches(directoryPath);
+        for (auto& p : fs::recursive_directory_iterator(directoryPath))
+        {
+            if (p.status().type() == fs::file_type::regular)
+            {
+                OnFileChanged(p.path().string());
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        log_verbose("FileWatcher: unable to watch %s: %s", directoryPath.c_str(), e.what());
+    }
+}
 #endif
 
 FileWatcher::FileWatcher(const std::string& directoryPath)
@@ -94,14 +129,7 @@ FileWatcher::FileWatcher(const std::string& directoryPath)
     }
 #elif defined(__linux__)
     _fileDesc.Initialise();
-    _watchDescs.emplace_back(_fileDesc.Fd, directoryPath);
-    for (auto& p : fs::recursive_directory_iterator(directoryPath))
-    {
-        if (p.status().type() == fs::file_type::directory)
-        {
-            _watchDescs.emplace_back(_fileDesc.Fd, p.path().string());
-        }
-    }
+    AddWatches(directoryPath);
 #else
     throw std::runtime_error("FileWatcher not supported on this platform.");
 #endif
@@ -134,7 +162,8 @@ void FileWatcher::WatchDirectory()
     std::array<char, 1024> eventData;
     DWORD bytesReturned;
     while (ReadDirectoryChangesW(
-        _directoryHandle, eventData.data(), (DWORD)eventData.size(), TRUE, FILE_NOTIFY_CHANGE_LAST_WRITE, &bytesReturned,
+        _directoryHandle, eventData.data(), (DWORD)eventData.size(), TRUE,
+        FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME, &bytesReturned,
         nullptr, nullptr))
     {
         auto onFileChanged = OnFileChanged;
@@ -170,7 +199,11 @@ void FileWatcher::WatchDirectory()
                 while (offset < length)
                 {
                     auto e = reinterpret_cast<inotify_event*>(eventData.data() + offset);
-                    if ((e->mask & IN_CLOSE_WRITE) && !(e->mask & IN_ISDIR))
+                    // A created file is reported once it has been written and closed
+                    bool isFileEvent = !(e->mask & IN_ISDIR)
+                        && (e->mask & (IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE));
+                    bool isDirectoryAdded = (e->mask & IN_ISDIR) && (e->mask & (IN_CREATE | IN_MOVED_TO));
+                    if (isFileEvent || isDirectoryAdded)
                     {
                         log_verbose("FileWatcher: inotify event received for %s", e->name);
 
@@ -183,7 +216,14 @@ void FileWatcher::WatchDirectory()
                         {
                             auto directory = findResult->Path;
                             auto path = fs::path(directory) / fs::path(e->name);
-                            onFileChanged(path);
+                            if (isDirectoryAdded)
+                            {
+                                OnDirectoryAdded(path.string());
+                            }
+                            else
+                            {
+                                onFileChanged(path);
+                            }
                         }
                     }
                     offset += sizeof(inotify_event) + e->len;
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <functional>
+#include <list>
 #include <string>
 #include <thread>
 #include <vector>
@@ -19,7 +20,7 @@ typedef void* HANDLE;
 #endif
 
 /**
- * Creates a new thread that watches a directory tree for file modifications.
+ * Creates a new thread that watches a directory tree for files being written, created, renamed or deleted.
  */
 class FileWatcher
 {
@@ -49,7 +50,7 @@ private:
     };
 
     FileDescriptor _fileDesc;
-    std::vector<WatchDescriptor> _watchDescs;
+    std::list<WatchDescriptor> _watchDescs;
 #endif
 
 public:
@@ -64,4 +65,8 @@ private:
 #endif
 
     void WatchDirectory();
+#if defined(__linux__)
+    void AddWatches(const std::string& directoryPath);
+    void OnDirectoryAdded(const std::string& directoryPath);
+#endif
 };
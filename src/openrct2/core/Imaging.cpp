@@ -15,14 +15,20 @@
 #include "../drawing/Drawing.h"
 #include "Guard.hpp"
 #include "IStream.hpp"
+#include "JobPool.hpp"
 #include "Memory.hpp"
 #include "String.hpp"
 
 #include <algorithm>
+#include <condition_variable>
+#include <cstring>
 #include <fstream>
+#include <limits>
+#include <mutex>
 #include <png.h>
 #include <stdexcept>
 #include <unordered_map>
+#include <zlib.h>
 
 namespace Imaging
 {
@@ -36,28 +42,6 @@ namespace Imaging
         istream->read(reinterpret_cast<char*>(data), length);
     }
 
-    static void PngWriteData(png_structp png_ptr, png_bytep data, png_size_t length)
-    {
-        auto ostream = static_cast<std::ostream*>(png_get_io_ptr(png_ptr));
-        ostream->write(reinterpret_cast<const char*>(data), length);
-    }
-
-    static void PngFlush(png_structp png_ptr)
-    {
-        auto ostream = static_cast<std::ostream*>(png_get_io_ptr(png_ptr));
-        ostream->flush();
-    }
-
-    static void PngWarning(png_structp, const char* b)
-    {
-        log_warning(b);
-    }
-
-    static void PngError(png_structp, const char* b)
-    {
-        log_error(b);
-    }
-
     static Image ReadPng(std::istream& istream, bool expandTo32)
     {
         png_structp png_ptr;
@@ -162,92 +146,411 @@ namespace Imaging
         }
     }
 
-    static void WritePng(std::ostream& ostream, const Image& image)
+    // Uncompressed input per deflate job, similar to the block size used by pigz.
+    constexpr size_t PNG_DEFLATE_CHUNK_SIZE = 256 * 1024;
+    constexpr size_t PNG_DEFLATE_WINDOW_SIZE = 32 * 1024;
+    constexpr uint8_t PNG_SIGNATURE[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+    enum : uint8_t
     {
-        png_structp png_ptr = nullptr;
-        png_colorp png_palette = nullptr;
-        try
+        PNG_ROW_FILTER_NONE,
+        PNG_ROW_FILTER_SUB,
+        PNG_ROW_FILTER_UP,
+        PNG_ROW_FILTER_AVERAGE,
+        PNG_ROW_FILTER_PAETH,
+        PNG_ROW_FILTER_COUNT,
+    };
+
+    struct PngDeflateChunk
+    {
+        uint32_t StartRow{};
+        uint32_t NumRows{};
+        uLong Length{};
+        uLong Adler{};
+        std::vector<uint8_t> Compressed;
+        std::string Error;
+    };
+
+    /**
+     * Writes a single PNG chunk, the length has to be known before any data is written.
+     */
+    class PngChunkWriter
+    {
+    private:
+        std::ostream& _stream;
+        uLong _crc{};
+
+    public:
+        PngChunkWriter(std::ostream& stream, const char* type, size_t length)
+            : _stream(stream)
         {
-            png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, PngError, PngWarning);
-            if (png_ptr == nullptr)
+            WriteUInt32(static_cast<uint32_t>(length));
+            _crc = crc32(0, nullptr, 0);
+            Write(type, 4);
+        }
+
+        void Write(const void* data, size_t length)
+        {
+            _stream.write(static_cast<const char*>(data), length);
+            _crc = crc32(_crc, static_cast<const Bytef*>(data), static_cast<uInt>(length));
+        }
+
+        void WriteUInt32(uint32_t value)
+        {
+            uint8_t buffer[] = { static_cast<uint8_t>(value >> 24), static_cast<uint8_t>(value >> 16),
+                                 static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value) };
+            Write(buffer, sizeof(buffer));
+        }
+
+        void End()
+        {
+            auto crc = static_cast<uint32_t>(_crc);
+            uint8_t buffer[] = { static_cast<uint8_t>(crc >> 24), static_cast<uint8_t>(crc >> 16),
+                                 static_cast<uint8_t>(crc >> 8), static_cast<uint8_t>(crc) };
+            _stream.write(reinterpret_cast<const char*>(buffer), sizeof(buffer));
+        }
+    };
+
+    static uint8_t PngPaethPredictor(int32_t a, int32_t b, int32_t c)
+    {
+        int32_t p = a + b - c;
+        int32_t pa = std::abs(p - a);
+        int32_t pb = std::abs(p - b);
+        int32_t pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc)
+            return static_cast<uint8_t>(a);
+        if (pb <= pc)
+            return static_cast<uint8_t>(b);
+        return static_cast<uint8_t>(c);
+    }
+
+    static void PngFilterRow(
+        uint8_t filter, const uint8_t* row, const uint8_t* prevRow, size_t rowBytes, size_t bpp, uint8_t* dst)
+    {
+        for (size_t i = 0; i < rowBytes; i++)
+        {
+            int32_t a = i >= bpp ? row[i - bpp] : 0;
+            int32_t b = prevRow != nullptr ? prevRow[i] : 0;
+            int32_t c = (i >= bpp && prevRow != nullptr) ? prevRow[i - bpp] : 0;
+            switch (filter)
             {
-                throw std::runtime_error("png_create_write_struct failed.");
+                case PNG_ROW_FILTER_SUB:
+                    dst[i] = static_cast<uint8_t>(row[i] - a);
+                    break;
+                case PNG_ROW_FILTER_UP:
+                    dst[i] = static_cast<uint8_t>(row[i] - b);
+                    break;
+                case PNG_ROW_FILTER_AVERAGE:
+                    dst[i] = static_cast<uint8_t>(row[i] - ((a + b) / 2));
+                    break;
+                case PNG_ROW_FILTER_PAETH:
+                    dst[i] = static_cast<uint8_t>(row[i] - PngPaethPredictor(a, b, c));
+                    break;
+                default:
+                    dst[i] = row[i];
+                    break;
             }
+        }
+    }
 
-            png_text text_ptr[1];
-            text_ptr[0].key = const_cast<char*>("Software");
-            text_ptr[0].text = const_cast<char*>(gVersionInfoFull);
-            text_ptr[0].compression = PNG_TEXT_COMPRESSION_zTXt;
+    /**
+     * Filters a range of rows into dst, each row is prefixed with its filter type. Paletted images and uncompressed
+     * output never use a filter, otherwise the filter is chosen per row using the minimum sum of absolute
+     * differences heuristic, the same as libpng does.
+     */
+    static void PngFilterRows(
+        const Image& image, uint32_t startRow, uint32_t numRows, bool adaptive, std::vector<uint8_t>& dst)
+    {
+        const size_t bpp = image.Depth / 8;
+        const size_t rowBytes = image.Width * bpp;
+        dst.resize(numRows * (rowBytes + 1));
 
-            auto info_ptr = png_create_info_struct(png_ptr);
-            if (info_ptr == nullptr)
+        std::vector<uint8_t> candidates;
+        if (adaptive)
+        {
+            candidates.resize(PNG_ROW_FILTER_COUNT * rowBytes);
+        }
+
+        auto out = dst.data();
+        for (uint32_t y = startRow; y < startRow + numRows; y++)
+        {
+            auto row = image.Pixels.data() + (static_cast<size_t>(y) * image.Stride);
+            auto prevRow = y > 0 ? row - image.Stride : nullptr;
+            if (!adaptive)
             {
-                throw std::runtime_error("png_create_info_struct failed.");
+                *out++ = PNG_ROW_FILTER_NONE;
+                std::copy_n(row, rowBytes, out);
             }
-
-            if (image.Depth == 8)
+            else
             {
-                if (image.Palette == nullptr)
+                uint8_t bestFilter = PNG_ROW_FILTER_NONE;
+                uint64_t bestSum = std::numeric_limits<uint64_t>::max();
+                for (uint8_t filter = PNG_ROW_FILTER_NONE; filter < PNG_ROW_FILTER_COUNT; filter++)
                 {
-                    throw std::runtime_error("Expected a palette for 8-bit image.");
-                }
+                    auto candidate = candidates.data() + (filter * rowBytes);
+                    PngFilterRow(filter, row, prevRow, rowBytes, bpp, candidate);
 
-                // Set the palette
-                png_palette = static_cast<png_colorp>(png_malloc(png_ptr, PNG_MAX_PALETTE_LENGTH * sizeof(png_color)));
-                if (png_palette == nullptr)
-                {
-                    throw std::runtime_error("png_malloc failed.");
+                    uint64_t sum = 0;
+                    for (size_t i = 0; i < rowBytes; i++)
+                    {
+                        sum += std::abs(static_cast<int8_t>(candidate[i]));
+                    }
+                    if (sum < bestSum)
+                    {
+                        bestSum = sum;
+                        bestFilter = filter;
+                    }
                 }
-                for (size_t i = 0; i < PNG_MAX_PALETTE_LENGTH; i++)
+                *out++ = bestFilter;
+                std::copy_n(candidates.data() + (bestFilter * rowBytes), rowBytes, out);
+            }
+            out += rowBytes;
+        }
+    }
+
+    /**
+     * Compresses a chunk of rows into a raw deflate stream. Every chunk apart from the last ends with a sync flush so
+     * that the streams can be concatenated. The dictionary is primed with the tail of the previous chunk so that the
+     * compression ratio is close to a single stream.
+     */
+    static void PngDeflateRows(const Image& image, int32_t level, bool lastChunk, PngDeflateChunk& chunk)
+    {
+        bool adaptive = image.Depth != 8 && level != 0;
+
+        std::vector<uint8_t> input;
+        PngFilterRows(image, chunk.StartRow, chunk.NumRows, adaptive, input);
+        chunk.Length = static_cast<uLong>(input.size());
+        chunk.Adler = adler32(adler32(0, nullptr, 0), input.data(), static_cast<uInt>(input.size()));
+
+        z_stream strm{};
+        if (deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            chunk.Error = "deflateInit2 failed.";
+            return;
+        }
+
+        // Growing the buffers can throw, the stream has to be freed either way
+        try
+        {
+            if (chunk.StartRow > 0 && level != 0)
+            {
+                const size_t rowBytes = (image.Width * (image.Depth / 8)) + 1;
+                auto dictionaryRows = static_cast<uint32_t>(
+                    std::min<size_t>(chunk.StartRow, (PNG_DEFLATE_WINDOW_SIZE + rowBytes - 1) / rowBytes));
+                std::vector<uint8_t> dictionary;
+                PngFilterRows(image, chunk.StartRow - dictionaryRows, dictionaryRows, adaptive, dictionary);
+                auto dictionaryLength = std::min(dictionary.size(), PNG_DEFLATE_WINDOW_SIZE);
+                deflateSetDictionary(
+                    &strm, dictionary.data() + (dictionary.size() - dictionaryLength), static_cast<uInt>(dictionaryLength));
+            }
+
+            chunk.Compressed.resize(deflateBound(&strm, chunk.Length) + 16);
+            strm.next_in = input.data();
+            strm.avail_in = static_cast<uInt>(input.size());
+            strm.next_out = chunk.Compressed.data();
+            strm.avail_out = static_cast<uInt>(chunk.Compressed.size());
+
+            int32_t flush = lastChunk ? Z_FINISH : Z_SYNC_FLUSH;
+            int32_t ret;
+            do
+            {
+                if (strm.avail_out == 0)
                 {
-                    const auto& entry = (*image.Palette)[static_cast<uint16_t>(i)];
-                    png_palette[i].blue = entry.Blue;
-                    png_palette[i].green = entry.Green;
-                    png_palette[i].red = entry.Red;
+                    auto used = chunk.Compressed.size();
+                    chunk.Compressed.resize(used * 2);
+                    strm.next_out = chunk.Compressed.data() + used;
+                    strm.avail_out = static_cast<uInt>(chunk.Compressed.size() - used);
                 }
-                png_set_PLTE(png_ptr, info_ptr, png_palette, PNG_MAX_PALETTE_LENGTH);
+                ret = deflate(&strm, flush);
+            } while (ret == Z_OK && (lastChunk || strm.avail_out == 0));
+
+            if (lastChunk ? ret != Z_STREAM_END : (ret != Z_OK && ret != Z_BUF_ERROR))
+            {
+                chunk.Error = "deflate failed.";
             }
+            chunk.Compressed.resize(strm.total_out);
+        }
+        catch (...)
+        {
+            deflateEnd(&strm);
+            throw;
+        }
+        deflateEnd(&strm);
+    }
+
+    static JobPool& GetDeflateJobPool()
+    {
+        static JobPool jobPool;
+        return jobPool;
+    }
 
-            png_set_write_fn(png_ptr, &ostream, PngWriteData, PngFlush);
+    static std::vector<PngDeflateChunk> PngDeflateImage(const Image& image, int32_t level)
+    {
+        const size_t rowBytes = (image.Width * (image.Depth / 8)) + 1;
+        const auto rowsPerChunk = static_cast<uint32_t>(std::max<size_t>(1, PNG_DEFLATE_CHUNK_SIZE / rowBytes));
 
-            // Set error handler
-            if (setjmp(png_jmpbuf(png_ptr)))
+        std::vector<PngDeflateChunk> chunks;
+        for (uint32_t y = 0; y < image.Height; y += rowsPerChunk)
+        {
+            auto& chunk = chunks.emplace_back();
+            chunk.StartRow = y;
+            chunk.NumRows = std::min(rowsPerChunk, image.Height - y);
+        }
+
+        if (chunks.size() == 1)
+        {
+            PngDeflateRows(image, level, true, chunks[0]);
+        }
+        else
+        {
+            // Only wait for the chunks of this image, other images may be written concurrently using the same pool
+            std::mutex mutex;
+            std::condition_variable condition;
+            size_t remaining = chunks.size();
+            auto& jobPool = GetDeflateJobPool();
+            for (size_t i = 0; i < chunks.size(); i++)
             {
-                throw std::runtime_error("PNG ERROR");
+                auto chunk = &chunks[i];
+                auto lastChunk = i == chunks.size() - 1;
+                jobPool.AddDetachedTask([&image, &mutex, &condition, &remaining, level, lastChunk, chunk]() {
+                    // Nothing can catch an exception thrown on the pool's thread, so it is reported like a zlib error
+                    try
+                    {
+                        PngDeflateRows(image, level, lastChunk, *chunk);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        chunk->Error = e.what();
+                    }
+                    std::lock_guard<std::mutex> lock(mutex);
+                    remaining--;
+                    condition.notify_one();
+                });
             }
 
-            // Write header
-            auto colourType = PNG_COLOR_TYPE_RGB_ALPHA;
-            if (image.Depth == 8)
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&remaining]() { return remaining == 0; });
+        }
+
+        for (const auto& chunk : chunks)
+        {
+            if (!chunk.Error.empty())
             {
-                png_byte transparentIndex = 0;
-                png_set_tRNS(png_ptr, info_ptr, &transparentIndex, 1, nullptr);
-                colourType = PNG_COLOR_TYPE_PALETTE;
+                throw std::runtime_error(chunk.Error);
             }
-            png_set_text(png_ptr, info_ptr, text_ptr, 1);
-            png_set_IHDR(
-                png_ptr, info_ptr, image.Width, image.Height, 8, colourType, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
-                PNG_FILTER_TYPE_DEFAULT);
-            png_write_info(png_ptr, info_ptr);
-
-            // Write pixels
-            auto pixels = image.Pixels.data();
-            for (uint32_t y = 0; y < image.Height; y++)
+        }
+        return chunks;
+    }
+
+    /**
+     * Writes a PNG image, the image data is split into chunks of rows which are filtered and deflated concurrently and
+     * then stitched together into a single zlib stream.
+     */
+    static void WritePng(std::ostream& ostream, const Image& image, const ImageWriteOptions& options)
+    {
+        if (image.Depth != 8 && image.Depth != 32)
+        {
+            throw std::runtime_error("Unsupported bit depth.");
+        }
+        if (image.Depth == 8 && image.Palette == nullptr)
+        {
+            throw std::runtime_error("Expected a palette for 8-bit image.");
+        }
+        if (image.Width == 0 || image.Height == 0)
+        {
+            throw std::runtime_error("Image has no pixels.");
+        }
+
+        auto level = options.CompressionLevel;
+        if (level < Z_NO_COMPRESSION || level > Z_BEST_COMPRESSION)
+        {
+            level = Z_DEFAULT_COMPRESSION;
+        }
+        auto chunks = PngDeflateImage(image, level);
+
+        ostream.write(reinterpret_cast<const char*>(PNG_SIGNATURE), sizeof(PNG_SIGNATURE));
+
+        // Header
+        {
+            PngChunkWriter writer(ostream, "IHDR", 13);
+            writer.WriteUInt32(image.Width);
+            writer.WriteUInt32(image.Height);
+            // Bit depth, colour type (palette or RGBA), compression, filter and interlace method
+            uint8_t header[] = { 8, static_cast<uint8_t>(image.Depth == 8 ? 3 : 6), 0, 0, 0 };
+            writer.Write(header, sizeof(header));
+            writer.End();
+        }
+
+        if (image.Depth == 8)
+        {
+            uint8_t palette[256 * 3];
+            for (size_t i = 0; i < 256; i++)
             {
-                png_write_row(png_ptr, const_cast<png_byte*>(pixels));
-                pixels += image.Stride;
+                const auto& entry = (*image.Palette)[static_cast<uint16_t>(i)];
+                palette[(i * 3) + 0] = entry.Red;
+                palette[(i * 3) + 1] = entry.Green;
+                palette[(i * 3) + 2] = entry.Blue;
             }
+            PngChunkWriter paletteWriter(ostream, "PLTE", sizeof(palette));
+            paletteWriter.Write(palette, sizeof(palette));
+            paletteWriter.End();
+
+            // Palette index 0 is transparent
+            uint8_t transparency = 0;
+            PngChunkWriter transparencyWriter(ostream, "tRNS", 1);
+            transparencyWriter.Write(&transparency, 1);
+            transparencyWriter.End();
+        }
 
-            png_write_end(png_ptr, nullptr);
-            png_destroy_info_struct(png_ptr, &info_ptr);
-            png_free(png_ptr, png_palette);
-            png_destroy_write_struct(&png_ptr, nullptr);
+        // Software
+        {
+            constexpr char key[] = "Software";
+            auto textLength = std::strlen(gVersionInfoFull);
+            PngChunkWriter writer(ostream, "tEXt", sizeof(key) + textLength);
+            writer.Write(key, sizeof(key));
+            writer.Write(gVersionInfoFull, textLength);
+            writer.End();
         }
-        catch (const std::exception&)
+
+        // Image data, one IDAT chunk per deflate chunk with the zlib header and trailer added to the first and last
+        uint8_t flevel = 2;
+        if (level == Z_NO_COMPRESSION || level == Z_BEST_SPEED)
+            flevel = 0;
+        else if (level >= 2 && level <= 5)
+            flevel = 1;
+        else if (level >= 7)
+            flevel = 3;
+        uint8_t zlibHeader[] = { 0x78, static_cast<uint8_t>(flevel << 6) };
+        zlibHeader[1] += 31 - (((zlibHeader[0] << 8) | zlibHeader[1]) % 31);
+
+        auto adler = adler32(0, nullptr, 0);
+        for (size_t i = 0; i < chunks.size(); i++)
         {
-            png_free(png_ptr, png_palette);
-            png_destroy_write_struct(&png_ptr, nullptr);
-            throw;
+            const auto& chunk = chunks[i];
+            adler = adler32_combine(adler, chunk.Adler, chunk.Length);
+
+            auto firstChunk = i == 0;
+            auto lastChunk = i == chunks.size() - 1;
+            auto length = chunk.Compressed.size() + (firstChunk ? sizeof(zlibHeader) : 0) + (lastChunk ? 4 : 0);
+            PngChunkWriter writer(ostream, "IDAT", length);
+            if (firstChunk)
+            {
+                writer.Write(zlibHeader, sizeof(zlibHeader));
+            }
+            writer.Write(chunk.Compressed.data(), chunk.Compressed.size());
+            if (lastChunk)
+            {
+                writer.WriteUInt32(static_cast<uint32_t>(adler));
+            }
+            writer.End();
+        }
+
+        PngChunkWriter endWriter(ostream, "IEND", 0);
+        endWriter.End();
+
+        if (!ostream)
+        {
+            throw std::runtime_error("Unable to write PNG data.");
         }
     }
 
@@ -329,14 +632,15 @@ namespace Imaging
         return ReadFromStream(istream, format);
     }
 
-    void WriteToFile(const std::string_view& path, const Image& image, IMAGE_FORMAT format)
+    void WriteToFile(const std::string_view& path, const Image& image, IMAGE_FORMAT format, const ImageWriteOptions& options)
     {
         switch (format)
         {
             case IMAGE_FORMAT::AUTOMATIC:
-                WriteToFile(path, image, GetImageFormatFromPath(path));
+                WriteToFile(path, image, GetImageFormatFromPath(path), options);
                 break;
             case IMAGE_FORMAT::PNG:
+            case IMAGE_FORMAT::PNG_32:
             {
 #if defined(_WIN32) && !defined(__MINGW32__)
                 auto pathW = String::ToWideChar(path);
@@ -344,7 +648,7 @@ namespace Imaging
 #else
                 std::ofstream fs(path.data(), std::ios::binary);
 #endif
-                WritePng(fs, image);
+                WritePng(fs, image, options);
                 break;
             }
             default:
@@ -42,6 +42,13 @@ struct Image
     uint32_t Stride{};
 };
 
+struct ImageWriteOptions
+{
+    // zlib compression level, 0 stores the image data uncompressed which is the fastest option.
+    // -1 selects the zlib default.
+    int32_t CompressionLevel = -1;
+};
+
 using ImageReaderFunc = std::function<Image(std::istream&, IMAGE_FORMAT)>;
 
 namespace Imaging
@@ -49,7 +56,9 @@ namespace Imaging
     IMAGE_FORMAT GetImageFormatFromPath(const std::string_view& path);
     Image ReadFromFile(const std::string_view& path, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC);
     Image ReadFromBuffer(const std::vector<uint8_t>& buffer, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC);
-    void WriteToFile(const std::string_view& path, const Image& image, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC);
+    void WriteToFile(
+        const std::string_view& path, const Image& image, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC,
+        const ImageWriteOptions& options = {});
 
     void SetReader(IMAGE_FORMAT format, ImageReaderFunc impl);
 } // namespace Imaging
@@ -26,10 +26,12 @@ private:
     {
         const std::function<void()> WorkFn;
         const std::function<void()> CompletionFn;
+        const bool Detached;
 
-        TaskData(std::function<void()> workFn, std::function<void()> completionFn)
+        TaskData(std::function<void()> workFn, std::function<void()> completionFn, bool detached = false)
             : WorkFn(workFn)
             , CompletionFn(completionFn)
+            , Detached(detached)
         {
         }
     };
@@ -77,6 +79,17 @@ public:
         _condPending.notify_one();
     }
 
+    /**
+     * Adds a task that is not reported to Join. For pools that live for the whole process and are shared by callers
+     * that wait for their own tasks to finish.
+     */
+    void AddDetachedTask(std::function<void()> workFn)
+    {
+        unique_lock lock(_mutex);
+        _pending.emplace_back(workFn, nullptr, true);
+        _condPending.notify_one();
+    }
+
     void Join(std::function<void()> reportFn = nullptr)
     {
         unique_lock lock(_mutex);
@@ -145,7 +158,10 @@ private:
 
                 lock.lock();
 
-                _completed.push_back(taskData);
+                if (!taskData.Detached)
+                {
+                    _completed.push_back(taskData);
+                }
 
                 _processing--;
                 _condComplete.notify_one();
@@ -706,6 +706,7 @@ const rct_g1_element* gfx_get_g1_element(int32_t image_id)
         size_t idx = offset - SPR_IMAGE_LIST_BEGIN;
         if (idx < _imageListElements.size())
         {
+            gfx_object_load_image_data(static_cast<uint32_t>(offset));
             return &_imageListElements[idx];
         }
     }
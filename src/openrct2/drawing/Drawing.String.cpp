@@ -536,13 +536,13 @@ static void ttf_draw_string_raw_ttf(rct_drawpixelinfo* dpi, const utf8* text, te
 
     if (info->flags & TEXT_DRAW_FLAG_NO_DRAW)
     {
-        info->x += ttf_getwidth_cache_get_or_add(fontDesc->font, text);
+        info->x += ttf_get_width(fontDesc->font, text);
         return;
     }
     else
     {
         uint8_t colour = info->palette[1];
-        TTFSurface* surface = ttf_surface_cache_get_or_add(fontDesc->font, text);
+        const TTFSurface* surface = ttf_render_surface(fontDesc->font, text);
         if (surface == nullptr)
             return;
 
@@ -624,8 +624,24 @@ const rct_g1_element* gfx_get_g1_element(ImageId imageId);
 const rct_g1_element* gfx_get_g1_element(int32_t image_id);
 void gfx_set_g1_element(int32_t imageId, const rct_g1_element* g1);
 bool is_csg_loaded();
-uint32_t gfx_object_allocate_images(const rct_g1_element* images, uint32_t count);
+/**
+ * Provides the data of object images that is only read once one of the images is drawn.
+ */
+struct IImageDataSource
+{
+    virtual ~IImageDataSource() = default;
+
+    // Loads the data the images given to gfx_object_allocate_images point to, must not fail
+    virtual void LoadImageData() abstract;
+    virtual void UnloadImageData() abstract;
+    virtual size_t GetImageDataSize() const abstract;
+};
+
+uint32_t gfx_object_allocate_images(
+    const rct_g1_element* images, uint32_t count, IImageDataSource* dataSource = nullptr);
 void gfx_object_free_images(uint32_t baseImageId, uint32_t count);
+void gfx_object_load_image_data(uint32_t imageId);
+void gfx_object_evict_image_data();
 void gfx_object_check_all_images_freed();
 size_t ImageListGetUsedCount();
 size_t ImageListGetMaximum();
@@ -695,6 +711,7 @@ void ttf_draw_string(rct_drawpixelinfo* dpi, const_utf8string text, int32_t colo
 // scrolling text
 void scrolling_text_initialise_bitmaps();
 void scrolling_text_invalidate();
+void scrolling_text_invalidate_strips();
 
 class Formatter;
 
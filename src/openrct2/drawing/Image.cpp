@@ -14,7 +14,10 @@
 #include "Drawing.h"
 
 #include <algorithm>
+#include <atomic>
 #include <list>
+#include <map>
+#include <mutex>
 
 constexpr uint32_t BASE_IMAGE_ID = SPR_IMAGE_LIST_BEGIN;
 constexpr uint32_t MAX_IMAGES = SPR_IMAGE_LIST_END - BASE_IMAGE_ID;
@@ -26,10 +29,30 @@ struct ImageList
     uint32_t Count;
 };
 
+// Image data of objects loaded on demand is evicted, least recently loaded first, once it exceeds this size
+constexpr size_t MAX_ON_DEMAND_IMAGE_DATA_SIZE = 256 * 1024 * 1024;
+
+struct OnDemandImageList
+{
+    const rct_g1_element* Images;
+    uint32_t Count;
+    IImageDataSource* DataSource;
+    bool IsLoaded;
+};
+
 static bool _initialised = false;
 static std::list<ImageList> _freeLists;
 static uint32_t _allocatedImageCount;
 
+// Image lists by base image id, loading can happen on any of the threads painting the viewports
+static std::mutex _onDemandImageListsMutex;
+static std::map<uint32_t, OnDemandImageList> _onDemandImageLists;
+static std::list<uint32_t> _loadedOnDemandImageLists;
+static size_t _loadedOnDemandImageDataSize;
+
+// Whether the data of each image is still to be loaded, read without the lock before the image's element is used
+static std::atomic<bool> _imageDataMissing[MAX_IMAGES];
+
 #ifdef DEBUG
 static std::list<ImageList> _allocatedLists;
 
@@ -187,7 +210,34 @@ static void FreeImageList(uint32_t baseImageId, uint32_t count)
     _freeLists.push_back({ baseImageId, count });
 }
 
-uint32_t gfx_object_allocate_images(const rct_g1_element* images, uint32_t count)
+/**
+ * Sets the elements of an image list whose data is loaded on demand. Images are marked as loaded only after their
+ * elements have been written, so that a thread that sees them loaded without holding the lock also sees the elements.
+ */
+static void SetOnDemandImageElements(uint32_t baseImageId, const OnDemandImageList& imageList)
+{
+    auto* dataMissing = &_imageDataMissing[baseImageId - BASE_IMAGE_ID];
+    if (!imageList.IsLoaded)
+    {
+        for (uint32_t i = 0; i < imageList.Count; i++)
+        {
+            dataMissing[i].store(true, std::memory_order_relaxed);
+        }
+    }
+    for (uint32_t i = 0; i < imageList.Count; i++)
+    {
+        gfx_set_g1_element(baseImageId + i, &imageList.Images[i]);
+    }
+    if (imageList.IsLoaded)
+    {
+        for (uint32_t i = 0; i < imageList.Count; i++)
+        {
+            dataMissing[i].store(false, std::memory_order_release);
+        }
+    }
+}
+
+uint32_t gfx_object_allocate_images(const rct_g1_element* images, uint32_t count, IImageDataSource* dataSource)
 {
     if (count == 0 || gOpenRCT2NoGraphics)
     {
@@ -201,6 +251,19 @@ uint32_t gfx_object_allocate_images(const rct_g1_element* images, uint32_t count
         return INVALID_IMAGE_ID;
     }
 
+    if (dataSource != nullptr)
+    {
+        std::lock_guard<std::mutex> lock(_onDemandImageListsMutex);
+        auto& imageList = _onDemandImageLists[baseImageId];
+        imageList = { images, count, dataSource, false };
+        SetOnDemandImageElements(baseImageId, imageList);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            drawing_engine_invalidate_image(baseImageId + i);
+        }
+        return baseImageId;
+    }
+
     uint32_t imageId = baseImageId;
     for (uint32_t i = 0; i < count; i++)
     {
@@ -212,10 +275,79 @@ uint32_t gfx_object_allocate_images(const rct_g1_element* images, uint32_t count
     return baseImageId;
 }
 
+/**
+ * Loads the data of the image list containing the given image if it has not been loaded yet, called before an image
+ * of an image list is used.
+ */
+void gfx_object_load_image_data(uint32_t imageId)
+{
+    if (imageId < BASE_IMAGE_ID || imageId >= SPR_IMAGE_LIST_END
+        || !_imageDataMissing[imageId - BASE_IMAGE_ID].load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    // Another thread may have loaded the data meanwhile, which is checked again while holding the lock
+    std::lock_guard<std::mutex> lock(_onDemandImageListsMutex);
+    auto it = _onDemandImageLists.upper_bound(imageId);
+    if (it == _onDemandImageLists.begin())
+    {
+        return;
+    }
+    it--;
+
+    auto baseImageId = it->first;
+    auto& imageList = it->second;
+    if (imageList.IsLoaded || imageId >= baseImageId + imageList.Count)
+    {
+        return;
+    }
+
+    imageList.DataSource->LoadImageData();
+    imageList.IsLoaded = true;
+    _loadedOnDemandImageLists.push_back(baseImageId);
+    _loadedOnDemandImageDataSize += imageList.DataSource->GetImageDataSize();
+    SetOnDemandImageElements(baseImageId, imageList);
+}
+
+/**
+ * Unloads image data loaded on demand while it takes more memory than allowed. Must be called between frames, when
+ * no image is being drawn.
+ */
+void gfx_object_evict_image_data()
+{
+    std::lock_guard<std::mutex> lock(_onDemandImageListsMutex);
+    while (_loadedOnDemandImageDataSize > MAX_ON_DEMAND_IMAGE_DATA_SIZE && !_loadedOnDemandImageLists.empty())
+    {
+        auto baseImageId = _loadedOnDemandImageLists.front();
+        _loadedOnDemandImageLists.pop_front();
+
+        auto& imageList = _onDemandImageLists.at(baseImageId);
+        _loadedOnDemandImageDataSize -= imageList.DataSource->GetImageDataSize();
+        imageList.DataSource->UnloadImageData();
+        imageList.IsLoaded = false;
+        SetOnDemandImageElements(baseImageId, imageList);
+    }
+}
+
 void gfx_object_free_images(uint32_t baseImageId, uint32_t count)
 {
     if (baseImageId != 0 && baseImageId != INVALID_IMAGE_ID)
     {
+        {
+            std::lock_guard<std::mutex> lock(_onDemandImageListsMutex);
+            auto it = _onDemandImageLists.find(baseImageId);
+            if (it != _onDemandImageLists.end())
+            {
+                if (it->second.IsLoaded)
+                {
+                    _loadedOnDemandImageLists.remove(baseImageId);
+                    _loadedOnDemandImageDataSize -= it->second.DataSource->GetImageDataSize();
+                }
+                _onDemandImageLists.erase(it);
+            }
+        }
+
         // Zero the G1 elements so we don't have invalid pointers
         // and data lying about
         for (uint32_t i = 0; i < count; i++)
@@ -223,6 +355,7 @@ void gfx_object_free_images(uint32_t baseImageId, uint32_t count)
             uint32_t imageId = baseImageId + i;
             rct_g1_element g1 = {};
             gfx_set_g1_element(imageId, &g1);
+            _imageDataMissing[imageId - BASE_IMAGE_ID].store(false, std::memory_order_relaxed);
             drawing_engine_invalidate_image(imageId);
         }
 
@@ -18,6 +18,9 @@
 
 #include <algorithm>
 #include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 struct rct_draw_scroll_text
 {
@@ -30,17 +33,67 @@ struct rct_draw_scroll_text
     uint8_t bitmap[64 * 40];
 };
 
+/**
+ * One pixel column of a pre-rendered scrolling text strip. Each bit is a row, starting at the top of the text.
+ */
+struct scrolling_text_strip_column
+{
+    colour_t colour;
+    // Rows drawn in the full text colour
+    uint8_t solid;
+    // Rows blended with the background (TrueType hinting)
+    uint8_t blend;
+};
+
+/**
+ * The whole text rendered once as a strip of columns. Scrolling just indexes into the strip, once the end is
+ * reached it continues from loop_start. This is not always 0 as the sprite font carries the last colour code
+ * of the text over into the next repetition.
+ */
+struct scrolling_text_strip
+{
+    std::vector<scrolling_text_strip_column> columns;
+    size_t loop_start;
+    uint32_t last_used;
+};
+
+struct scrolling_text_strip_key
+{
+    std::string text;
+    colour_t colour;
+    bool ttf;
+    bool hinting;
+
+    bool operator==(const scrolling_text_strip_key& other) const
+    {
+        return text == other.text && colour == other.colour && ttf == other.ttf && hinting == other.hinting;
+    }
+};
+
+struct scrolling_text_strip_key_hash
+{
+    size_t operator()(const scrolling_text_strip_key& key) const
+    {
+        size_t flags = (key.colour << 2) | (key.ttf << 1) | key.hinting;
+        return std::hash<std::string>()(key.text) * 31 + flags;
+    }
+};
+
 constexpr int32_t MAX_SCROLLING_TEXT_ENTRIES = 32;
+constexpr size_t MAX_SCROLLING_TEXT_STRIPS = 1024;
 
 static rct_draw_scroll_text _drawScrollTextList[MAX_SCROLLING_TEXT_ENTRIES];
 static uint8_t _characterBitmaps[FONT_SPRITE_GLYPH_COUNT + SPR_G2_GLYPH_COUNT][8];
 static uint32_t _drawSCrollNextIndex = 0;
 static std::mutex _scrollingTextMutex;
+using scrolling_text_strip_map
+    = std::unordered_map<scrolling_text_strip_key, scrolling_text_strip, scrolling_text_strip_key_hash>;
+static scrolling_text_strip_map _scrollingTextStrips;
 
-static void scrolling_text_set_bitmap_for_sprite(
-    utf8* text, int32_t scroll, uint8_t* bitmap, const int16_t* scrollPositionOffsets, colour_t colour);
-static void scrolling_text_set_bitmap_for_ttf(
-    utf8* text, int32_t scroll, uint8_t* bitmap, const int16_t* scrollPositionOffsets, colour_t colour);
+static void scrolling_text_build_strip_for_sprite(const utf8* text, colour_t colour, scrolling_text_strip& strip);
+static void scrolling_text_build_strip_for_ttf(utf8* text, colour_t colour, scrolling_text_strip& strip);
+static void scrolling_text_draw_strip(
+    const scrolling_text_strip& strip, int32_t scroll, uint8_t* bitmap, const int16_t* scrollPositionOffsets);
 
 void scrolling_text_initialise_bitmaps()
 {
@@ -112,6 +165,9 @@ void scrolling_text_initialise_bitmaps()
             gfx_set_g1_element(imageId, &g1);
         }
     }
+
+    // Strips were rendered from the old glyph bitmaps
+    scrolling_text_invalidate_strips();
 }
 
 static uint8_t* font_sprite_get_codepoint_bitmap(int32_t codepoint)
@@ -1433,6 +1489,8 @@ static constexpr const int16_t* _scrollPositions[MAX_SCROLLING_TEXT_MODES] = {
 
 void scrolling_text_invalidate()
 {
+    std::scoped_lock<std::mutex> lock(_scrollingTextMutex);
+
     for (int32_t i = 0; i < MAX_SCROLLING_TEXT_ENTRIES; i++)
     {
         rct_draw_scroll_text& scrollText = _drawScrollTextList[i];
@@ -1441,6 +1499,54 @@ void scrolling_text_invalidate()
     }
 }
 
+/**
+ * Discards the pre-rendered strips as well as the scrolling text, only needed when the fonts change. Renaming does
+ * not need this as strips are keyed by the formatted text.
+ */
+void scrolling_text_invalidate_strips()
+{
+    scrolling_text_invalidate();
+
+    std::scoped_lock<std::mutex> lock(_scrollingTextMutex);
+    _scrollingTextStrips.clear();
+}
+
+/**
+ * Gets the pre-rendered strip for the given text, rendering it if it is not already cached. Strips are keyed by
+ * the formatted text rather than the string id and arguments as arguments can point to text that changes.
+ */
+static const scrolling_text_strip& scrolling_text_get_strip(utf8* text, colour_t colour)
+{
+    bool useTrueTypeFont = LocalisationService_UseTrueTypeFont();
+    scrolling_text_strip_key key{ text, colour, useTrueTypeFont, useTrueTypeFont && gConfigFonts.enable_hinting };
+    auto it = _scrollingTextStrips.find(key);
+    if (it != _scrollingTextStrips.end())
+    {
+        it->second.last_used = _drawSCrollNextIndex;
+        return it->second;
+    }
+
+    if (_scrollingTextStrips.size() >= MAX_SCROLLING_TEXT_STRIPS)
+    {
+        auto oldest = std::min_element(
+            _scrollingTextStrips.begin(), _scrollingTextStrips.end(),
+            [](const auto& a, const auto& b) { return a.second.last_used < b.second.last_used; });
+        _scrollingTextStrips.erase(oldest);
+    }
+
+    scrolling_text_strip strip{};
+    strip.last_used = _drawSCrollNextIndex;
+    if (useTrueTypeFont)
+    {
+        scrolling_text_build_strip_for_ttf(text, colour, strip);
+    }
+    else
+    {
+        scrolling_text_build_strip_for_sprite(text, colour, strip);
+    }
+    return _scrollingTextStrips.emplace(std::move(key), std::move(strip)).first->second;
+}
+
 int32_t scrolling_text_setup(
     paint_session* session, rct_string_id stringId, Formatter& ft, uint16_t scroll, uint16_t scrollingMode, colour_t colour)
 {
@@ -1475,92 +1581,63 @@ int32_t scrolling_text_setup(
     const int16_t* scrollingModePositions = _scrollPositions[scrollingMode];
 
     std::fill_n(scrollText->bitmap, 320 * 8, 0x00);
-    if (LocalisationService_UseTrueTypeFont())
-    {
-        scrolling_text_set_bitmap_for_ttf(scrollString, scroll, scrollText->bitmap, scrollingModePositions, colour);
-    }
-    else
-    {
-        scrolling_text_set_bitmap_for_sprite(scrollString, scroll, scrollText->bitmap, scrollingModePositions, colour);
-    }
+    const auto& strip = scrolling_text_get_strip(scrollString, colour);
+    scrolling_text_draw_strip(strip, scroll, scrollText->bitmap, scrollingModePositions);
 
     uint32_t imageId = SPR_SCROLLING_TEXT_START + scrollIndex;
     drawing_engine_invalidate_image(imageId);
     return imageId;
 }
 
-static void scrolling_text_set_bitmap_for_sprite(
-    utf8* text, int32_t scroll, uint8_t* bitmap, const int16_t* scrollPositionOffsets, colour_t colour)
+static void scrolling_text_build_strip_for_sprite(const utf8* text, colour_t colour, scrolling_text_strip& strip)
 {
     auto characterColour = colour;
 
-    utf8* ch = text;
-    while (true)
+    // Render the text twice, the colour at the end of the first pass carries over into every later repetition
+    for (int32_t pass = 0; pass < 2; pass++)
     {
-        uint32_t codepoint = utf8_get_next(ch, const_cast<const utf8**>(&ch));
-
-        // If at the end of the string loop back to the start
-        if (codepoint == 0)
+        const utf8* ch = text;
+        uint32_t codepoint;
+        while ((codepoint = utf8_get_next(ch, &ch)) != 0)
         {
-            ch = text;
-            continue;
-        }
-
-        // Set any change in colour
-        if (codepoint <= FORMAT_COLOUR_CODE_END && codepoint >= FORMAT_COLOUR_CODE_START)
-        {
-            codepoint -= FORMAT_COLOUR_CODE_START;
-            const rct_g1_element* g1 = gfx_get_g1_element(SPR_TEXT_PALETTE);
-            if (g1 != nullptr)
+            // Set any change in colour
+            if (codepoint <= FORMAT_COLOUR_CODE_END && codepoint >= FORMAT_COLOUR_CODE_START)
             {
-                characterColour = g1->offset[codepoint * 4];
+                codepoint -= FORMAT_COLOUR_CODE_START;
+                const rct_g1_element* g1 = gfx_get_g1_element(SPR_TEXT_PALETTE);
+                if (g1 != nullptr)
+                {
+                    characterColour = g1->offset[codepoint * 4];
+                }
+                continue;
             }
-            continue;
-        }
 
-        // If another type of control character ignore
-        if (codepoint < 32)
-            continue;
-
-        int32_t characterWidth = font_sprite_get_codepoint_width(FONT_SPRITE_BASE_TINY, codepoint);
-        uint8_t* characterBitmap = font_sprite_get_codepoint_bitmap(codepoint);
-        for (; characterWidth != 0; characterWidth--, characterBitmap++)
-        {
-            // Skip any non-displayed columns
-            if (scroll != 0)
-            {
-                scroll--;
+            // If another type of control character ignore
+            if (codepoint < 32)
                 continue;
-            }
 
-            int16_t scrollPosition = *scrollPositionOffsets;
-            if (scrollPosition == -1)
-                return;
-            if (scrollPosition > -1)
+            int32_t characterWidth = font_sprite_get_codepoint_width(FONT_SPRITE_BASE_TINY, codepoint);
+            const uint8_t* characterBitmap = font_sprite_get_codepoint_bitmap(codepoint);
+            for (; characterWidth != 0; characterWidth--, characterBitmap++)
             {
-                uint8_t* dst = &bitmap[scrollPosition];
-                for (uint8_t char_bitmap = *characterBitmap; char_bitmap != 0; char_bitmap >>= 1)
-                {
-                    if (char_bitmap & 1)
-                        *dst = characterColour;
-
-                    // Jump to next row
-                    dst += 64;
-                }
+                strip.columns.push_back({ characterColour, *characterBitmap, 0 });
             }
-            scrollPositionOffsets++;
+        }
+
+        if (pass == 0)
+        {
+            strip.loop_start = strip.columns.size();
         }
     }
 }
 
-static void scrolling_text_set_bitmap_for_ttf(
-    utf8* text, int32_t scroll, uint8_t* bitmap, const int16_t* scrollPositionOffsets, colour_t colour)
+static void scrolling_text_build_strip_for_ttf(utf8* text, colour_t colour, scrolling_text_strip& strip)
 {
 #ifndef NO_TTF
     TTFFontDescriptor* fontDesc = ttf_get_font_from_sprite_base(FONT_SPRITE_BASE_TINY);
     if (fontDesc->font == nullptr)
     {
-        scrolling_text_set_bitmap_for_sprite(text, scroll, bitmap, scrollPositionOffsets, colour);
+        scrolling_text_build_strip_for_sprite(text, colour, strip);
         return;
     }
 
@@ -1588,7 +1665,9 @@ static void scrolling_text_set_bitmap_for_ttf(
     }
     *dstCh = 0;
 
-    TTFSurface* surface = ttf_surface_cache_get_or_add(fontDesc->font, text);
+    strip.loop_start = 0;
+
+    const TTFSurface* surface = ttf_render_surface(fontDesc->font, text);
     if (surface == nullptr)
     {
         return;
@@ -1607,46 +1686,75 @@ static void scrolling_text_set_bitmap_for_ttf(
 
     bool use_hinting = gConfigFonts.enable_hinting && fontDesc->hinting_threshold > 0;
 
-    for (int32_t x = 0;; x++)
+    strip.columns.resize(width);
+    for (int32_t x = 0; x < width; x++)
     {
-        if (x >= width)
-            x = 0;
-
-        // Skip any non-displayed columns
-        if (scroll == 0)
+        auto& column = strip.columns[x];
+        column.colour = colour;
+        for (int32_t y = min_vpos; y < max_vpos; y++)
         {
-            int16_t scrollPosition = *scrollPositionOffsets;
-            if (scrollPosition == -1)
-                return;
-
-            if (scrollPosition > -1)
+            uint8_t row = 1 << (y - min_vpos);
+            uint8_t src_pixel = src[y * pitch + x];
+            if ((!use_hinting && src_pixel != 0) || src_pixel > 140)
+            {
+                // Centre of the glyph: use full colour.
+                column.solid |= row;
+            }
+            else if (use_hinting && src_pixel > fontDesc->hinting_threshold)
             {
-                uint8_t* dst = &bitmap[scrollPosition];
+                // Simulate font hinting by shading the background colour instead.
+                column.blend |= row;
+            }
+        }
+    }
+#endif // NO_TTF
+}
 
-                for (int32_t y = min_vpos; y < max_vpos; y++)
-                {
-                    uint8_t src_pixel = src[y * pitch + x];
-                    if ((!use_hinting && src_pixel != 0) || src_pixel > 140)
-                    {
-                        // Centre of the glyph: use full colour.
-                        *dst = colour;
-                    }
-                    else if (use_hinting && src_pixel > fontDesc->hinting_threshold)
-                    {
-                        // Simulate font hinting by shading the background colour instead.
-                        *dst = blendColours(colour, *dst);
-                    }
+static void scrolling_text_draw_strip(
+    const scrolling_text_strip& strip, int32_t scroll, uint8_t* bitmap, const int16_t* scrollPositionOffsets)
+{
+    size_t numColumns = strip.columns.size();
+    if (numColumns == 0 || strip.loop_start >= numColumns)
+    {
+        return;
+    }
 
-                    // Jump to next row
-                    dst += 64;
+    // Skip any non-displayed columns
+    size_t column = static_cast<size_t>(scroll);
+    if (column >= numColumns)
+    {
+        column = strip.loop_start + (column - strip.loop_start) % (numColumns - strip.loop_start);
+    }
+
+    for (; *scrollPositionOffsets != -1; scrollPositionOffsets++)
+    {
+        int16_t scrollPosition = *scrollPositionOffsets;
+        if (scrollPosition > -1)
+        {
+            const auto& stripColumn = strip.columns[column];
+            uint8_t* dst = &bitmap[scrollPosition];
+            uint8_t solid = stripColumn.solid;
+            uint8_t blend = stripColumn.blend;
+            for (; (solid | blend) != 0; solid >>= 1, blend >>= 1)
+            {
+                if (solid & 1)
+                {
+                    *dst = stripColumn.colour;
                 }
+                else if (blend & 1)
+                {
+                    *dst = blendColours(stripColumn.colour, *dst);
+                }
+
+                // Jump to next row
+                dst += 64;
             }
-            scrollPositionOffsets++;
         }
-        else
+
+        column++;
+        if (column == numColumns)
         {
-            scroll--;
+            column = strip.loop_start;
         }
     }
-#endif // NO_TTF
 }
@@ -11,6 +11,8 @@
 
 #include "Font.h"
 
+#include <vector>
+
 bool ttf_initialise();
 void ttf_dispose();
 
@@ -26,18 +28,16 @@ struct TTFSurface
 
 TTFFontDescriptor* ttf_get_font_from_sprite_base(uint16_t spriteBase);
 void ttf_toggle_hinting();
-TTFSurface* ttf_surface_cache_get_or_add(TTF_Font* font, const utf8* text);
-uint32_t ttf_getwidth_cache_get_or_add(TTF_Font* font, const utf8* text);
+const TTFSurface* ttf_render_surface(TTF_Font* font, const utf8* text);
+uint32_t ttf_get_width(TTF_Font* font, const utf8* text);
 bool ttf_provides_glyph(const TTF_Font* font, codepoint_t codepoint);
-void ttf_free_surface(TTFSurface* surface);
 
 // TTF_SDLPORT
 int TTF_Init(void);
 TTF_Font* TTF_OpenFont(const char* file, int ptsize);
 int TTF_GlyphIsProvided(const TTF_Font* font, codepoint_t ch);
 int TTF_SizeUTF8(TTF_Font* font, const char* text, int* w, int* h);
-TTFSurface* TTF_RenderUTF8_Solid(TTF_Font* font, const char* text, uint32_t colour);
-TTFSurface* TTF_RenderUTF8_Shaded(TTF_Font* font, const char* text, uint32_t fg, uint32_t bg);
+bool TTF_RenderUTF8(TTF_Font* font, const char* text, std::vector<uint8_t>& pixels, TTFSurface* surface);
 void TTF_CloseFont(TTF_Font* font);
 void TTF_SetFontHinting(TTF_Font* font, int hinting);
 int TTF_GetFontHinting(const TTF_Font* font);
@@ -32,11 +32,16 @@ misrepresented as being the original software.
 */
 
 #    include <algorithm>
+#    include <atomic>
 #    include <cmath>
 #    include <cstring>
+#    include <mutex>
+#    include <shared_mutex>
 #    include <stdio.h>
 #    include <stdlib.h>
 #    include <string.h>
+#    include <unordered_map>
+#    include <vector>
 
 #    pragma clang diagnostic push
 #    pragma clang diagnostic ignored "-Wdocumentation"
@@ -98,6 +103,26 @@ struct c_glyph
     uint16_t cached;
 };
 
+/* Glyphs shared between threads, a glyph is immutable once it has been published */
+struct c_glyph_page
+{
+    std::atomic<const c_glyph*> glyphs[256];
+};
+
+struct c_glyph_atlas
+{
+    std::atomic<c_glyph_page*> pages[256];
+
+    /* Guards the FreeType face and the single glyph cache which are not thread safe */
+    std::mutex load_mutex;
+
+    /* Glyphs that were replaced by a glyph with more formats, freed when the atlas is flushed */
+    std::vector<const c_glyph*> retired;
+
+    std::shared_mutex kerning_mutex;
+    std::unordered_map<uint64_t, int> kerning;
+};
+
 /* The structure used to hold internal font information */
 struct _TTF_Font
 {
@@ -130,6 +155,9 @@ struct _TTF_Font
     c_glyph* current;
     c_glyph cache[257]; /* 257 is a prime */
 
+    /* Lock-free glyph lookup used for measuring and rendering text */
+    c_glyph_atlas* atlas;
+
     /* We are responsible for closing the font stream */
     FILE* src;
     int freesrc;
@@ -396,6 +424,18 @@ static TTF_Font* TTF_OpenFontIndexRW(FILE* src, int freesrc, int ptsize, long in
     }
     std::fill_n(reinterpret_cast<uint8_t*>(font), sizeof(*font), 0x00);
 
+    font->atlas = new (std::nothrow) c_glyph_atlas();
+    if (font->atlas == NULL)
+    {
+        TTF_SetError("Out of memory");
+        free(font);
+        if (freesrc)
+        {
+            fclose(src);
+        }
+        return NULL;
+    }
+
     font->src = src;
     font->freesrc = freesrc;
 
@@ -981,10 +1021,148 @@ static FT_Error Find_Glyph(TTF_Font* font, uint16_t ch, int want)
     return retval;
 }
 
+static void Free_Atlas_Glyph(const c_glyph* glyph)
+{
+    free(glyph->bitmap.buffer);
+    free(glyph->pixmap.buffer);
+    delete glyph;
+}
+
+static void Copy_Bitmap(FT_Bitmap* dst, const FT_Bitmap* src)
+{
+    *dst = *src;
+    dst->buffer = NULL;
+    if (src->buffer != NULL)
+    {
+        size_t size = static_cast<size_t>(std::abs(src->pitch)) * src->rows;
+        dst->buffer = static_cast<unsigned char*>(malloc(size));
+        if (dst->buffer != NULL)
+        {
+            std::memcpy(dst->buffer, src->buffer, size);
+        }
+    }
+}
+
+/* Frees every glyph in the atlas, must not be called while text is being measured or rendered on another thread */
+static void Flush_Atlas(TTF_Font* font)
+{
+    c_glyph_atlas* atlas = font->atlas;
+    if (atlas == NULL)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(atlas->load_mutex);
+    for (auto& pageSlot : atlas->pages)
+    {
+        c_glyph_page* page = pageSlot.exchange(NULL);
+        if (page != NULL)
+        {
+            for (auto& glyphSlot : page->glyphs)
+            {
+                const c_glyph* glyph = glyphSlot.load();
+                if (glyph != NULL)
+                {
+                    Free_Atlas_Glyph(glyph);
+                }
+            }
+            delete page;
+        }
+    }
+    for (const c_glyph* glyph : atlas->retired)
+    {
+        Free_Atlas_Glyph(glyph);
+    }
+    atlas->retired.clear();
+
+    std::unique_lock<std::shared_mutex> kerningLock(atlas->kerning_mutex);
+    atlas->kerning.clear();
+}
+
+/* Gets a glyph from the atlas without taking a lock, on a miss the glyph is loaded through the
+   single glyph cache and published as an immutable copy. */
+static const c_glyph* Find_Atlas_Glyph(TTF_Font* font, uint16_t ch, int want)
+{
+    c_glyph_atlas* atlas = font->atlas;
+    std::atomic<c_glyph_page*>& pageSlot = atlas->pages[ch >> 8];
+    c_glyph_page* page = pageSlot.load(std::memory_order_acquire);
+    if (page != NULL)
+    {
+        const c_glyph* glyph = page->glyphs[ch & 0xFF].load(std::memory_order_acquire);
+        if (glyph != NULL && (glyph->stored & want) == want)
+        {
+            return glyph;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(atlas->load_mutex);
+    page = pageSlot.load(std::memory_order_relaxed);
+    if (page == NULL)
+    {
+        page = new c_glyph_page();
+        pageSlot.store(page, std::memory_order_release);
+    }
+
+    std::atomic<const c_glyph*>& glyphSlot = page->glyphs[ch & 0xFF];
+    const c_glyph* existing = glyphSlot.load(std::memory_order_relaxed);
+    if (existing != NULL)
+    {
+        if ((existing->stored & want) == want)
+        {
+            return existing;
+        }
+        want |= existing->stored;
+    }
+
+    if (Find_Glyph(font, ch, want) != 0)
+    {
+        return NULL;
+    }
+
+    c_glyph* glyph = new c_glyph(*font->current);
+    Copy_Bitmap(&glyph->bitmap, &font->current->bitmap);
+    Copy_Bitmap(&glyph->pixmap, &font->current->pixmap);
+    glyphSlot.store(glyph, std::memory_order_release);
+
+    if (existing != NULL)
+    {
+        /* Other threads may still be reading the old glyph */
+        atlas->retired.push_back(existing);
+    }
+    return glyph;
+}
+
+static int Get_Kerning(TTF_Font* font, FT_UInt prev_index, FT_UInt index)
+{
+    c_glyph_atlas* atlas = font->atlas;
+    uint64_t key = (static_cast<uint64_t>(prev_index) << 32) | index;
+    {
+        std::shared_lock<std::shared_mutex> lock(atlas->kerning_mutex);
+        auto it = atlas->kerning.find(key);
+        if (it != atlas->kerning.end())
+        {
+            return it->second;
+        }
+    }
+
+    FT_Vector delta;
+    {
+        std::lock_guard<std::mutex> lock(atlas->load_mutex);
+        FT_Get_Kerning(font->face, prev_index, index, ft_kerning_default, &delta);
+    }
+
+    int kerning = delta.x >> 6;
+    std::unique_lock<std::shared_mutex> lock(atlas->kerning_mutex);
+    atlas->kerning.emplace(key, kerning);
+    return kerning;
+}
+
 void TTF_CloseFont(TTF_Font* font)
 {
     if (font)
     {
+        Flush_Atlas(font);
+        delete font->atlas;
         Flush_Cache(font);
         if (font->face)
         {
@@ -1128,8 +1306,7 @@ int TTF_SizeUTF8(TTF_Font* font, const char* text, int* w, int* h)
     int x, z;
     int minx, maxx;
     int miny, maxy;
-    c_glyph* glyph;
-    FT_Error error;
+    const c_glyph* glyph;
     FT_Long use_kerning;
     FT_UInt prev_index = 0;
     int outline_delta = 0;
@@ -1162,20 +1339,17 @@ int TTF_SizeUTF8(TTF_Font* font, const char* text, int* w, int* h)
             continue;
         }
 
-        error = Find_Glyph(font, c, CACHED_METRICS);
-        if (error)
+        glyph = Find_Atlas_Glyph(font, c, CACHED_METRICS);
+        if (glyph == NULL)
         {
-            TTF_SetFTError("Couldn't find glyph", error);
+            TTF_SetError("Couldn't find glyph");
             return -1;
         }
-        glyph = font->current;
 
         /* handle kerning */
         if (use_kerning && prev_index && glyph->index)
         {
-            FT_Vector delta;
-            FT_Get_Kerning(font->face, prev_index, glyph->index, ft_kerning_default, &delta);
-            x += delta.x >> 6;
+            x += Get_Kerning(font, prev_index, glyph->index);
         }
 
 #    if 0
@@ -1259,181 +1433,47 @@ int TTF_SizeUTF8(TTF_Font* font, const char* text, int* w, int* h)
     return status;
 }
 
-TTFSurface* TTF_RenderUTF8_Solid(TTF_Font* font, const char* text, [[maybe_unused]] uint32_t colour)
+bool TTF_RenderUTF8(TTF_Font* font, const char* text, std::vector<uint8_t>& pixels, TTFSurface* textbuf)
 {
     bool first;
+    bool mono;
+    int want;
     int xstart;
     int width;
     int height;
-    TTFSurface* textbuf;
-    uint8_t* src;
+    const uint8_t* src;
     uint8_t* dst;
     uint8_t* dst_check;
     unsigned int row, col;
-    c_glyph* glyph;
-
-    FT_Bitmap* current;
-    FT_Error error;
+    const FT_Bitmap* current;
+    const c_glyph* glyph;
     FT_Long use_kerning;
     FT_UInt prev_index = 0;
     size_t textlen;
 
-    TTF_CHECKPOINTER(text, NULL);
+    TTF_CHECKPOINTER(text, false);
 
     /* Get the dimensions of the text surface */
     if ((TTF_SizeUTF8(font, text, &width, &height) < 0) || !width)
     {
         TTF_SetError("Text has zero width");
-        return NULL;
-    }
-
-    /* Create the target surface */
-    textbuf = static_cast<TTFSurface*>(calloc(1, sizeof(TTFSurface)));
-    if (textbuf == NULL)
-    {
-        return NULL;
-    }
-    textbuf->w = width;
-    textbuf->h = height;
-    textbuf->pitch = width;
-    textbuf->pixels = calloc(1, width * height);
-
-    /* Adding bound checking to avoid all kinds of memory corruption errors
-    that may occur. */
-    dst_check = const_cast<uint8_t*>(static_cast<const uint8_t*>(textbuf->pixels)) + textbuf->pitch * textbuf->h;
-
-    /* check kerning */
-    use_kerning = FT_HAS_KERNING(font->face) && font->kerning;
-
-    /* Load and render each character */
-    textlen = strlen(text);
-    first = true;
-    xstart = 0;
-    while (textlen > 0)
-    {
-        uint16_t c = UTF8_getch(&text, &textlen);
-        if (c == UNICODE_BOM_NATIVE || c == UNICODE_BOM_SWAPPED)
-        {
-            continue;
-        }
-
-        error = Find_Glyph(font, c, CACHED_METRICS | CACHED_BITMAP);
-        if (error)
-        {
-            TTF_SetFTError("Couldn't find glyph", error);
-            ttf_free_surface(textbuf);
-            return NULL;
-        }
-        glyph = font->current;
-        current = &glyph->bitmap;
-        /* Ensure the width of the pixmap is correct. On some cases,
-         * freetype may report a larger pixmap than possible.*/
-        width = current->width;
-        if (font->outline <= 0 && width > glyph->maxx - glyph->minx)
-        {
-            width = glyph->maxx - glyph->minx;
-        }
-        /* do kerning, if possible AC-Patch */
-        if (use_kerning && prev_index && glyph->index)
-        {
-            FT_Vector delta;
-            FT_Get_Kerning(font->face, prev_index, glyph->index, ft_kerning_default, &delta);
-            xstart += delta.x >> 6;
-        }
-        /* Compensate for wrap around bug with negative minx's */
-        if (first && (glyph->minx < 0))
-        {
-            xstart -= glyph->minx;
-        }
-        first = false;
-
-        for (row = 0; row < current->rows; ++row)
-        {
-            /* Make sure we don't go either over, or under the
-             * limit */
-            if (static_cast<signed>(row) + glyph->yoffset < 0)
-            {
-                continue;
-            }
-            if (static_cast<signed>(row) + glyph->yoffset >= textbuf->h)
-            {
-                continue;
-            }
-            dst = const_cast<uint8_t*>(static_cast<const uint8_t*>(textbuf->pixels)) + (row + glyph->yoffset) * textbuf->pitch
-                + xstart + glyph->minx;
-            src = current->buffer + row * current->pitch;
-
-            for (col = width; col > 0 && dst < dst_check; --col)
-            {
-                *dst++ |= *src++;
-            }
-        }
-
-        xstart += glyph->advance;
-        if (TTF_HANDLE_STYLE_BOLD(font))
-        {
-            xstart += font->glyph_overhang;
-        }
-        prev_index = glyph->index;
-    }
-
-    /* Handle the underline style */
-    if (TTF_HANDLE_STYLE_UNDERLINE(font))
-    {
-        row = TTF_underline_top_row(font);
-        TTF_drawLine_Solid(font, textbuf, row);
+        return false;
     }
 
-    /* Handle the strikethrough style */
-    if (TTF_HANDLE_STYLE_STRIKETHROUGH(font))
-    {
-        row = TTF_strikethrough_top_row(font);
-        TTF_drawLine_Solid(font, textbuf, row);
-    }
-    return textbuf;
-}
-
-TTFSurface* TTF_RenderUTF8_Shaded(TTF_Font* font, const char* text, [[maybe_unused]] uint32_t fg, [[maybe_unused]] uint32_t bg)
-{
-    bool first;
-    int xstart;
-    int width;
-    int height;
-    TTFSurface* textbuf;
-    uint8_t* src;
-    uint8_t* dst;
-    uint8_t* dst_check;
-    unsigned int row, col;
-    FT_Bitmap* current;
-    c_glyph* glyph;
-    FT_Error error;
-    FT_Long use_kerning;
-    FT_UInt prev_index = 0;
-    size_t textlen;
-
-    TTF_CHECKPOINTER(text, NULL);
-
-    /* Get the dimensions of the text surface */
-    if ((TTF_SizeUTF8(font, text, &width, &height) < 0) || !width)
-    {
-        TTF_SetError("Text has zero width");
-        return NULL;
-    }
+    /* Hinted fonts are rendered shaded, otherwise solid */
+    mono = font->hinting == 0;
+    want = CACHED_METRICS | (mono ? CACHED_BITMAP : CACHED_PIXMAP);
 
     /* Create the target surface */
-    textbuf = static_cast<TTFSurface*>(calloc(1, sizeof(TTFSurface)));
-    if (textbuf == NULL)
-    {
-        return NULL;
-    }
+    pixels.assign(static_cast<size_t>(width) * height, 0);
     textbuf->w = width;
     textbuf->h = height;
     textbuf->pitch = width;
-    textbuf->pixels = calloc(1, width * height);
+    textbuf->pixels = pixels.data();
 
     /* Adding bound checking to avoid all kinds of memory corruption errors
        that may occur. */
-    dst_check = const_cast<uint8_t*>(static_cast<const uint8_t*>(textbuf->pixels)) + textbuf->pitch * textbuf->h;
+    dst_check = pixels.data() + textbuf->pitch * textbuf->h;
 
     /* check kerning */
     use_kerning = FT_HAS_KERNING(font->face) && font->kerning;
@@ -1450,19 +1490,17 @@ TTFSurface* TTF_RenderUTF8_Shaded(TTF_Font* font, const char* text, [[maybe_unus
             continue;
         }
 
-        error = Find_Glyph(font, c, CACHED_METRICS | CACHED_PIXMAP);
-        if (error)
+        glyph = Find_Atlas_Glyph(font, c, want);
+        if (glyph == NULL)
         {
-            TTF_SetFTError("Couldn't find glyph", error);
-            ttf_free_surface(textbuf);
-            return NULL;
+            TTF_SetError("Couldn't find glyph");
+            return false;
         }
 
-        glyph = font->current;
-
+        current = mono ? &glyph->bitmap : &glyph->pixmap;
         /* Ensure the width of the pixmap is correct. On some cases,
          * freetype may report a larger pixmap than possible.*/
-        width = glyph->pixmap.width;
+        width = current->width;
         if (font->outline <= 0 && width > glyph->maxx - glyph->minx)
         {
             width = glyph->maxx - glyph->minx;
@@ -1471,9 +1509,7 @@ TTFSurface* TTF_RenderUTF8_Shaded(TTF_Font* font, const char* text, [[maybe_unus
         /* do kerning, if possible AC-Patch */
         if (use_kerning && prev_index && glyph->index)
         {
-            FT_Vector delta;
-            FT_Get_Kerning(font->face, prev_index, glyph->index, ft_kerning_default, &delta);
-            xstart += delta.x >> 6;
+            xstart += Get_Kerning(font, prev_index, glyph->index);
         }
 
         /* Compensate for the wrap around with negative minx's */
@@ -1483,7 +1519,6 @@ TTFSurface* TTF_RenderUTF8_Shaded(TTF_Font* font, const char* text, [[maybe_unus
         }
         first = false;
 
-        current = &glyph->pixmap;
         for (row = 0; row < current->rows; ++row)
         {
             /* Make sure we don't go either over, or under the
@@ -1497,8 +1532,7 @@ TTFSurface* TTF_RenderUTF8_Shaded(TTF_Font* font, const char* text, [[maybe_unus
                 continue;
             }
 
-            dst = const_cast<uint8_t*>(static_cast<const uint8_t*>(textbuf->pixels)) + (row + glyph->yoffset) * textbuf->pitch
-                + xstart + glyph->minx;
+            dst = pixels.data() + (row + glyph->yoffset) * textbuf->pitch + xstart + glyph->minx;
             src = current->buffer + row * current->pitch;
 
             for (col = width; col > 0 && dst < dst_check; --col)
@@ -1519,16 +1553,22 @@ TTFSurface* TTF_RenderUTF8_Shaded(TTF_Font* font, const char* text, [[maybe_unus
     if (TTF_HANDLE_STYLE_UNDERLINE(font))
     {
         row = TTF_underline_top_row(font);
-        TTF_drawLine_Shaded(font, textbuf, row);
+        if (mono)
+            TTF_drawLine_Solid(font, textbuf, row);
+        else
+            TTF_drawLine_Shaded(font, textbuf, row);
     }
 
     /* Handle the strikethrough style */
     if (TTF_HANDLE_STYLE_STRIKETHROUGH(font))
     {
         row = TTF_strikethrough_top_row(font);
-        TTF_drawLine_Shaded(font, textbuf, row);
+        if (mono)
+            TTF_drawLine_Solid(font, textbuf, row);
+        else
+            TTF_drawLine_Shaded(font, textbuf, row);
     }
-    return textbuf;
+    return true;
 }
 
 void TTF_SetFontHinting(TTF_Font* font, int hinting)
@@ -1542,6 +1582,7 @@ void TTF_SetFontHinting(TTF_Font* font, int hinting)
     else
         font->hinting = 0;
 
+    Flush_Atlas(font);
     Flush_Cache(font);
 }
 
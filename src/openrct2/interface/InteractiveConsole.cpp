@@ -61,6 +61,10 @@
 #include <thread>
 #include <vector>
 
+#ifdef ENABLE_SCRIPTING
+#    include "../scripting/ScriptEngine.h"
+#endif
+
 #ifndef NO_TTF
 #    include "../drawing/TTF.h"
 #endif
@@ -1216,8 +1220,7 @@ static int32_t cc_remove_park_fences(InteractiveConsole& console, [[maybe_unused
 
 static int32_t cc_show_limits(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
 {
-    map_reorganise_elements();
-    int32_t tileElementCount = gNextFreeTileElement - gTileElements - 1;
+    int32_t tileElementCount = map_get_tile_element_count();
 
     int32_t rideCount = ride_get_count();
     int32_t spriteCount = 0;
@@ -1254,6 +1257,57 @@ static int32_t cc_show_limits(InteractiveConsole& console, [[maybe_unused]] cons
     return 0;
 }
 
+static int32_t cc_show_tile_element_storage(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
+{
+    auto stats = map_get_tile_element_storage_stats();
+    console.WriteFormatLine(
+        "Chunks: %zu (%u released, %zu spare)", stats.Chunks, stats.ChunksReleased, stats.SpareChunks);
+    console.WriteFormatLine("Elements: %zu used, %zu allocated, %zu capacity", stats.Used, stats.Allocated, stats.Capacity);
+    console.WriteFormatLine("Fragmentation: %.1f%%", stats.GetFragmentation() * 100);
+    console.WriteFormatLine(
+        "Compactor: pass %u at %.0f%%, %llu tiles relocated%s", stats.CompactPasses + 1, stats.CompactProgress * 100,
+        static_cast<unsigned long long>(stats.Relocations), stats.IsEvacuatingChunk ? ", evacuating a chunk" : "");
+    return 0;
+}
+
+static int32_t cc_plugin_stats(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
+{
+#ifdef ENABLE_SCRIPTING
+    auto& profiler = GetContext()->GetScriptEngine().GetProfiler();
+    if (!argv.empty() && argv[0] == "reset")
+    {
+        profiler.Reset();
+        console.WriteLine("Plugin stats reset.");
+        return 0;
+    }
+
+    const auto& stats = profiler.GetStats();
+    if (stats.empty())
+    {
+        console.WriteLine("No plugin calls recorded.");
+        return 0;
+    }
+
+    for (const auto& [pluginName, pluginStats] : stats)
+    {
+        console.WriteFormatLine(
+            "%s: max tick %.2f ms, %u ticks over budget", pluginName.c_str(), pluginStats.MaxTickTime / 1000.0,
+            pluginStats.TicksOverBudget);
+        for (const auto& [callType, callStats] : pluginStats.Calls)
+        {
+            auto averageTime = callStats.CallCount != 0 ? callStats.TotalTime / static_cast<double>(callStats.CallCount) : 0;
+            console.WriteFormatLine(
+                "    %s: %llu calls, total %.2f ms, avg %.3f ms, max %.3f ms, %llu allocations", callType.c_str(),
+                static_cast<unsigned long long>(callStats.CallCount), callStats.TotalTime / 1000.0, averageTime / 1000.0,
+                callStats.MaxTime / 1000.0, static_cast<unsigned long long>(callStats.Allocations));
+        }
+    }
+#else
+    console.WriteLineError("Scripting is not enabled in this build.");
+#endif
+    return 0;
+}
+
 static int32_t cc_for_date([[maybe_unused]] InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
 {
     int32_t year = 0;
@@ -1758,6 +1812,7 @@ static constexpr const console_command console_command_table[] = {
     { "load_park", cc_load_park, "Load park from save directory or by absolute path", "load_park <filename>" },
     { "object_count", cc_object_count, "Shows the number of objects of each type in the scenario.", "object_count" },
     { "open", cc_open, "Opens the window with the give name.", "open <window>." },
+    { "plugin_stats", cc_plugin_stats, "Shows the time spent in the callbacks of each plugin.", "plugin_stats [reset]" },
     { "quit", cc_close, "Closes the console.", "quit" },
     { "remove_park_fences", cc_remove_park_fences, "Removes all park fences from the surface", "remove_park_fences" },
     { "remove_unused_objects", cc_remove_unused_objects, "Removes all the unused objects from the object selection.", "remove_unused_objects" },
@@ -1767,6 +1822,7 @@ static constexpr const console_command console_command_table[] = {
     { "say", cc_say, "Say to other players.", "say <message>" },
     { "set", cc_set, "Sets the variable to the specified value.", "set <variable> <value>" },
     { "show_limits", cc_show_limits, "Shows the map data counts and limits.", "show_limits" },
+    { "show_tile_element_storage", cc_show_tile_element_storage, "Shows the tile element storage usage and compactor progress.", "show_tile_element_storage" },
     { "staff", cc_staff, "Staff management.", "staff <subcommand>" },
     { "terminate", cc_terminate, "Calls std::terminate(), for testing purposes only.", "terminate" },
     { "variables", cc_variables, "Lists all the variables that can be used with get and sometimes set.", "variables" },
@@ -17,6 +17,8 @@
 #include "../audio/audio.h"
 #include "../core/Console.hpp"
 #include "../core/Imaging.h"
+#include "../core/JobPool.hpp"
+#include "../core/String.hpp"
 #include "../drawing/Drawing.h"
 #include "../drawing/X8DrawingEngine.h"
 #include "../localisation/Localisation.h"
@@ -30,10 +32,15 @@
 
 #include <cctype>
 #include <chrono>
+#include <condition_variable>
 #include <cstdlib>
+#include <fstream>
+#include <iostream>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <vector>
 
 using namespace std::literals::string_literals;
 using namespace OpenRCT2;
@@ -41,7 +48,16 @@ using namespace OpenRCT2::Drawing;
 
 uint8_t gScreenshotCountdown = 0;
 
-static bool WriteDpiToFile(const std::string_view& path, const rct_drawpixelinfo* dpi, const GamePalette& palette)
+static ImageWriteOptions GetScreenshotWriteOptions(std::optional<int32_t> compressionLevel = std::nullopt)
+{
+    ImageWriteOptions options;
+    options.CompressionLevel = compressionLevel.value_or(gConfigGeneral.screenshot_compression_level);
+    return options;
+}
+
+static bool WriteDpiToFile(
+    const std::string_view& path, const rct_drawpixelinfo* dpi, const GamePalette& palette,
+    const ImageWriteOptions& options = GetScreenshotWriteOptions())
 {
     auto const pixels8 = dpi->bits;
     auto const pixelsLen = (dpi->width + dpi->pitch) * dpi->height;
@@ -54,7 +70,7 @@ static bool WriteDpiToFile(const std::string_view& path, const rct_drawpixelinfo
         image.Stride = dpi->width + dpi->pitch;
         image.Palette = std::make_unique<GamePalette>(palette);
         image.Pixels = std::vector<uint8_t>(pixels8, pixels8 + pixelsLen);
-        Imaging::WriteToFile(path, image, IMAGE_FORMAT::PNG);
+        Imaging::WriteToFile(path, image, IMAGE_FORMAT::PNG, options);
         return true;
     }
     catch (const std::exception& e)
@@ -195,7 +211,7 @@ std::string screenshot_dump_png_32bpp(int32_t width, int32_t height, const void*
         image.Depth = 32;
         image.Stride = width * 4;
         image.Pixels = std::vector<uint8_t>(pixels8, pixels8 + pixelsLen);
-        Imaging::WriteToFile(path->c_str(), image, IMAGE_FORMAT::PNG_32);
+        Imaging::WriteToFile(path->c_str(), image, IMAGE_FORMAT::PNG_32, GetScreenshotWriteOptions());
         return *path;
     }
     catch (const std::exception& e)
@@ -548,6 +564,24 @@ int32_t cmdline_for_gfxbench(const char** argv, int32_t argc)
     return 1;
 }
 
+static void ApplyViewportOptions(const ScreenshotOptions* options, rct_viewport& viewport)
+{
+    if (options->hide_guests)
+    {
+        viewport.flags |= VIEWPORT_FLAG_INVISIBLE_PEEPS;
+    }
+
+    if (options->hide_sprites)
+    {
+        viewport.flags |= VIEWPORT_FLAG_INVISIBLE_SPRITES;
+    }
+
+    if (options->transparent || gConfigGeneral.transparent_screenshot)
+    {
+        viewport.flags |= VIEWPORT_FLAG_TRANSPARENT_BACKGROUND;
+    }
+}
+
 static void ApplyOptions(const ScreenshotOptions* options, rct_viewport& viewport)
 {
     if (options->weather != 0)
@@ -561,15 +595,7 @@ static void ApplyOptions(const ScreenshotOptions* options, rct_viewport& viewpor
         climate_force_weather(customWeather);
     }
 
-    if (options->hide_guests)
-    {
-        viewport.flags |= VIEWPORT_FLAG_INVISIBLE_PEEPS;
-    }
-
-    if (options->hide_sprites)
-    {
-        viewport.flags |= VIEWPORT_FLAG_INVISIBLE_SPRITES;
-    }
+    ApplyViewportOptions(options, viewport);
 
     if (options->mowed_grass)
     {
@@ -595,11 +621,106 @@ static void ApplyOptions(const ScreenshotOptions* options, rct_viewport& viewpor
     {
         CheatsSet(CheatType::RemoveLitter);
     }
+}
 
-    if (options->transparent || gConfigGeneral.transparent_screenshot)
+static bool IsScreenshotArgCountValid(const char** argv, int32_t argc)
+{
+    bool giantScreenshot = (argc == 5) && _stricmp(argv[2], "giant") == 0;
+    return argc == 4 || argc == 8 || giantScreenshot;
+}
+
+/**
+ * Creates the viewport for the screenshot command arguments, argv[0] and argv[1] are the park and output paths.
+ * The park must already be loaded as the viewport depends on the map size and the saved view.
+ */
+static rct_viewport GetScreenshotViewport(const char** argv, int32_t argc)
+{
+    bool customLocation = false;
+    bool centreMapX = false;
+    bool centreMapY = false;
+
+    rct_viewport viewport{};
+    bool giantScreenshot = (argc == 5) && _stricmp(argv[2], "giant") == 0;
+    if (giantScreenshot)
     {
-        viewport.flags |= VIEWPORT_FLAG_TRANSPARENT_BACKGROUND;
+        auto zoom = std::atoi(argv[3]);
+        auto rotation = std::atoi(argv[4]) & 3;
+        viewport = GetGiantViewport(gMapSize, rotation, zoom);
+        gCurrentRotation = rotation;
     }
+    else
+    {
+        int32_t resolutionWidth = std::atoi(argv[2]);
+        int32_t resolutionHeight = std::atoi(argv[3]);
+        int32_t customX = 0;
+        int32_t customY = 0;
+        int32_t customZoom = 0;
+        int32_t customRotation = 0;
+        if (argc == 8)
+        {
+            customLocation = true;
+            if (argv[4][0] == 'c')
+                centreMapX = true;
+            else
+                customX = std::atoi(argv[4]);
+
+            if (argv[5][0] == 'c')
+                centreMapY = true;
+            else
+                customY = std::atoi(argv[5]);
+
+            customZoom = std::atoi(argv[6]);
+            customRotation = std::atoi(argv[7]) & 3;
+        }
+
+        int32_t mapSize = gMapSize;
+        if (resolutionWidth == 0 || resolutionHeight == 0)
+        {
+            resolutionWidth = (mapSize * 32 * 2) >> customZoom;
+            resolutionHeight = (mapSize * 32 * 1) >> customZoom;
+
+            resolutionWidth += 8;
+            resolutionHeight += 128;
+        }
+
+        viewport.width = resolutionWidth;
+        viewport.height = resolutionHeight;
+        viewport.view_width = viewport.width;
+        viewport.view_height = viewport.height;
+        if (customLocation)
+        {
+            if (centreMapX)
+                customX = (mapSize / 2) * 32 + 16;
+            if (centreMapY)
+                customY = (mapSize / 2) * 32 + 16;
+
+            int32_t z = tile_element_height({ customX, customY });
+            CoordsXYZ coords3d = { customX, customY, z };
+
+            auto coords2d = translate_3d_to_2d_with_z(customRotation, coords3d);
+
+            viewport.viewPos = { coords2d.x - ((viewport.view_width << customZoom) / 2),
+                                 coords2d.y - ((viewport.view_height << customZoom) / 2) };
+            viewport.zoom = customZoom;
+            gCurrentRotation = customRotation;
+        }
+        else
+        {
+            viewport.viewPos = { gSavedView - ScreenCoordsXY{ (viewport.view_width / 2), (viewport.view_height / 2) } };
+            viewport.zoom = gSavedViewZoom;
+            gCurrentRotation = gSavedViewRotation;
+        }
+    }
+    return viewport;
+}
+
+static std::optional<int32_t> GetScreenshotCompressionLevel(const ScreenshotOptions* options)
+{
+    if (options->compression_level >= 0)
+    {
+        return options->compression_level;
+    }
+    return std::nullopt;
 }
 
 int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOptions* options)
@@ -615,8 +736,7 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
         }
     }
 
-    bool giantScreenshot = (argc == 5) && _stricmp(argv[2], "giant") == 0;
-    if (argc != 4 && argc != 8 && !giantScreenshot)
+    if (!IsScreenshotArgCountValid(argv, argc))
     {
         std::printf("Usage: openrct2 screenshot <file> <output_image> <width> <height> [<x> <y> <zoom> <rotation>]\n");
         std::printf("Usage: openrct2 screenshot <file> <output_image> giant <zoom> <rotation>\n");
@@ -628,9 +748,6 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
     try
     {
         core_init();
-        bool customLocation = false;
-        bool centreMapX = false;
-        bool centreMapY = false;
 
         const char* inputPath = argv[0];
         const char* outputPath = argv[1];
@@ -652,92 +769,305 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
         gIntroState = IntroState::None;
         gScreenFlags = SCREEN_FLAGS_PLAYING;
 
-        rct_viewport viewport{};
-        if (giantScreenshot)
+        auto viewport = GetScreenshotViewport(argv, argc);
+        ApplyOptions(options, viewport);
+
+        dpi = CreateDPI(viewport);
+
+        RenderViewport(nullptr, viewport, dpi);
+        WriteDpiToFile(outputPath, &dpi, gPalette, GetScreenshotWriteOptions(GetScreenshotCompressionLevel(options)));
+    }
+    catch (const std::exception& e)
+    {
+        std::printf("%s\n", e.what());
+        exitCode = -1;
+    }
+    ReleaseDPI(dpi);
+
+    drawing_engine_dispose();
+
+    return exitCode;
+}
+
+/**
+ * Splits a batch screenshot job line into arguments, arguments containing spaces can be enclosed in double quotes.
+ */
+static std::vector<std::string> SplitScreenshotJob(const std::string& line)
+{
+    std::vector<std::string> args;
+    std::string arg;
+    bool inArg = false;
+    bool inQuotes = false;
+    for (auto c : line)
+    {
+        if (c == '"')
         {
-            auto zoom = std::atoi(argv[3]);
-            auto rotation = std::atoi(argv[4]) & 3;
-            viewport = GetGiantViewport(gMapSize, rotation, zoom);
-            gCurrentRotation = rotation;
+            inQuotes = !inQuotes;
+            inArg = true;
         }
-        else
+        else if (!inQuotes && std::isspace(static_cast<unsigned char>(c)))
         {
-            int32_t resolutionWidth = std::atoi(argv[2]);
-            int32_t resolutionHeight = std::atoi(argv[3]);
-            int32_t customX = 0;
-            int32_t customY = 0;
-            int32_t customZoom = 0;
-            int32_t customRotation = 0;
-            if (argc == 8)
+            if (inArg)
             {
-                customLocation = true;
-                if (argv[4][0] == 'c')
-                    centreMapX = true;
-                else
-                    customX = std::atoi(argv[4]);
-
-                if (argv[5][0] == 'c')
-                    centreMapY = true;
-                else
-                    customY = std::atoi(argv[5]);
-
-                customZoom = std::atoi(argv[6]);
-                customRotation = std::atoi(argv[7]) & 3;
+                args.push_back(std::move(arg));
+                arg.clear();
+                inArg = false;
             }
+        }
+        else
+        {
+            arg.push_back(c);
+            inArg = true;
+        }
+    }
+    if (inArg)
+    {
+        args.push_back(std::move(arg));
+    }
+    return args;
+}
+
+/**
+ * Reads the options at the end of a batch screenshot job into options, which start as the options given to the batch
+ * command. Options take the same form as on the command line, e.g. --weather 3 or --weather=3. Options must start with
+ * two dashes as coordinates can be negative. Returns the number of arguments before the options.
+ */
+static int32_t ParseScreenshotJobOptions(const std::vector<std::string>& args, ScreenshotOptions& options)
+{
+    auto argc = static_cast<int32_t>(args.size());
+    for (int32_t i = 0; i < argc; i++)
+    {
+        if (String::StartsWith(args[i], "--"))
+        {
+            argc = i;
+            break;
+        }
+    }
+
+    for (size_t i = argc; i < args.size(); i++)
+    {
+        auto name = args[i].substr(2);
+        std::optional<std::string> value;
+        auto equals = name.find('=');
+        if (equals != std::string::npos)
+        {
+            value = name.substr(equals + 1);
+            name = name.substr(0, equals);
+        }
 
-            int32_t mapSize = gMapSize;
-            if (resolutionWidth == 0 || resolutionHeight == 0)
+        auto readInteger = [&]() {
+            if (!value.has_value())
             {
-                resolutionWidth = (mapSize * 32 * 2) >> customZoom;
-                resolutionHeight = (mapSize * 32 * 1) >> customZoom;
+                if (i + 1 >= args.size())
+                {
+                    throw std::runtime_error("Expected a value for --" + name);
+                }
+                value = args[++i];
+            }
+            return std::atoi(value->c_str());
+        };
+
+        if (name == "weather")
+            options.weather = readInteger();
+        else if (name == "compression-level")
+            options.compression_level = readInteger();
+        else if (name == "no-peeps")
+            options.hide_guests = true;
+        else if (name == "no-sprites")
+            options.hide_sprites = true;
+        else if (name == "clear-grass")
+            options.clear_grass = true;
+        else if (name == "mowed-grass")
+            options.mowed_grass = true;
+        else if (name == "water-plants")
+            options.water_plants = true;
+        else if (name == "fix-vandalism")
+            options.fix_vandalism = true;
+        else if (name == "remove-litter")
+            options.remove_litter = true;
+        else if (name == "tidy-up-park")
+            options.tidy_up_park = true;
+        else if (name == "transparent")
+            options.transparent = true;
+        else
+            throw std::runtime_error("Unknown option: --" + name);
+    }
+    return argc;
+}
+
+/**
+ * Whether two sets of options change the loaded park in the same way, a park changed by a previous job's options
+ * has to be reloaded before it can be rendered with different ones.
+ */
+static bool ScreenshotOptionsChangeParkEqual(const ScreenshotOptions& a, const ScreenshotOptions& b)
+{
+    return a.weather == b.weather && a.clear_grass == b.clear_grass && a.mowed_grass == b.mowed_grass
+        && a.water_plants == b.water_plants && a.fix_vandalism == b.fix_vandalism && a.remove_litter == b.remove_litter
+        && a.tidy_up_park == b.tidy_up_park;
+}
+
+int32_t cmdline_for_screenshot_batch(const char** argv, int32_t argc, ScreenshotOptions* options)
+{
+    const char* jobPath = nullptr;
+    if (argc >= 1 && argv[0][0] != '-')
+    {
+        jobPath = argv[0];
+    }
+
+    std::ifstream jobFile;
+    if (jobPath != nullptr)
+    {
+        jobFile.open(jobPath);
+        if (!jobFile.is_open())
+        {
+            std::fprintf(stderr, "Unable to open job file: %s\n", jobPath);
+            return -1;
+        }
+    }
+    std::istream& jobStream = jobPath != nullptr ? static_cast<std::istream&>(jobFile) : std::cin;
 
-                resolutionWidth += 8;
-                resolutionHeight += 128;
+    core_init();
+    gOpenRCT2Headless = true;
+    auto context = CreateContext();
+    if (!context->Initialise())
+    {
+        std::fprintf(stderr, "Failed to initialize context.\n");
+        return -1;
+    }
+
+    drawing_engine_init();
+
+    // Painting is split over all cores, while the previous image is encoded in the background. The user's setting is
+    // left as it is, the configuration is not ours to change.
+    viewport_set_force_multithreading(true);
+
+    // Keep the number of images held in memory bounded
+    constexpr size_t MAX_PENDING_IMAGES = 2;
+    JobPool encodeJobs(MAX_PENDING_IMAGES);
+    std::mutex outputMutex;
+    std::mutex pendingMutex;
+    std::condition_variable pendingCondition;
+    size_t numPendingImages = 0;
+
+    int32_t exitCode = 1;
+    std::string loadedParkPath;
+    ScreenshotOptions loadedParkOptions;
+    std::string line;
+    while (std::getline(jobStream, line))
+    {
+        auto args = SplitScreenshotJob(line);
+        if (args.empty() || args[0][0] == '#')
+        {
+            continue;
+        }
+
+        rct_drawpixelinfo dpi{};
+        try
+        {
+            auto jobOptions = *options;
+            auto jobArgc = ParseScreenshotJobOptions(args, jobOptions);
+
+            std::vector<const char*> jobArgv;
+            for (int32_t i = 0; i < jobArgc; i++)
+            {
+                jobArgv.push_back(args[i].c_str());
             }
 
-            viewport.width = resolutionWidth;
-            viewport.height = resolutionHeight;
-            viewport.view_width = viewport.width;
-            viewport.view_height = viewport.height;
-            if (customLocation)
+            if (!IsScreenshotArgCountValid(jobArgv.data(), jobArgc))
             {
-                if (centreMapX)
-                    customX = (mapSize / 2) * 32 + 16;
-                if (centreMapY)
-                    customY = (mapSize / 2) * 32 + 16;
+                throw std::runtime_error("Invalid job, expected: <file> <output_image> <width> <height> [<x> <y> <zoom> "
+                                         "<rotation>] or <file> <output_image> giant <zoom> <rotation> [<options>]");
+            }
 
-                int32_t z = tile_element_height({ customX, customY });
-                CoordsXYZ coords3d = { customX, customY, z };
+            // Consecutive jobs for the same park do not reload it, objects shared between parks stay loaded. Options
+            // that change the park (weather, cheats) are only applied to a freshly loaded park.
+            bool reloadPark = args[0] != loadedParkPath || !ScreenshotOptionsChangeParkEqual(jobOptions, loadedParkOptions);
+            if (reloadPark)
+            {
+                loadedParkPath.clear();
+                if (!context->LoadParkFromFile(args[0]))
+                {
+                    throw std::runtime_error("Failed to load park.");
+                }
+                loadedParkPath = args[0];
+                loadedParkOptions = jobOptions;
 
-                auto coords2d = translate_3d_to_2d_with_z(customRotation, coords3d);
+                gIntroState = IntroState::None;
+                gScreenFlags = SCREEN_FLAGS_PLAYING;
+            }
 
-                viewport.viewPos = { coords2d.x - ((viewport.view_width << customZoom) / 2),
-                                     coords2d.y - ((viewport.view_height << customZoom) / 2) };
-                viewport.zoom = customZoom;
-                gCurrentRotation = customRotation;
+            auto viewport = GetScreenshotViewport(jobArgv.data(), jobArgc);
+            if (reloadPark)
+            {
+                ApplyOptions(&jobOptions, viewport);
             }
             else
             {
-                viewport.viewPos = { gSavedView - ScreenCoordsXY{ (viewport.view_width / 2), (viewport.view_height / 2) } };
-                viewport.zoom = gSavedViewZoom;
-                gCurrentRotation = gSavedViewRotation;
+                ApplyViewportOptions(&jobOptions, viewport);
             }
-        }
+            auto writeOptions = GetScreenshotWriteOptions(GetScreenshotCompressionLevel(&jobOptions));
 
-        ApplyOptions(options, viewport);
+            // Wait for an encode to finish before rendering another image
+            {
+                std::unique_lock<std::mutex> lock(pendingMutex);
+                pendingCondition.wait(lock, [&numPendingImages]() { return numPendingImages < MAX_PENDING_IMAGES; });
+            }
 
-        dpi = CreateDPI(viewport);
+            dpi = CreateDPI(viewport);
+            RenderViewport(nullptr, viewport, dpi);
 
-        RenderViewport(nullptr, viewport, dpi);
-        WriteDpiToFile(outputPath, &dpi, gPalette);
-    }
-    catch (const std::exception& e)
-    {
-        std::printf("%s\n", e.what());
-        exitCode = -1;
+            auto image = std::make_shared<Image>();
+            image->Width = dpi.width;
+            image->Height = dpi.height;
+            image->Depth = 8;
+            image->Stride = dpi.width + dpi.pitch;
+            image->Palette = std::make_unique<GamePalette>(gPalette);
+            image->Pixels = std::vector<uint8_t>(dpi.bits, dpi.bits + (image->Stride * image->Height));
+            ReleaseDPI(dpi);
+
+            {
+                std::lock_guard<std::mutex> lock(pendingMutex);
+                numPendingImages++;
+            }
+
+            auto outputPath = args[1];
+            encodeJobs.AddTask([image, outputPath, writeOptions, &outputMutex, &exitCode, &pendingMutex, &pendingCondition,
+                                &numPendingImages]() mutable {
+                try
+                {
+                    Imaging::WriteToFile(outputPath, *image, IMAGE_FORMAT::PNG, writeOptions);
+
+                    std::lock_guard<std::mutex> lock(outputMutex);
+                    std::printf("OK %s\n", outputPath.c_str());
+                }
+                catch (const std::exception& e)
+                {
+                    std::lock_guard<std::mutex> lock(outputMutex);
+                    std::printf("FAIL %s: %s\n", outputPath.c_str(), e.what());
+                    exitCode = -1;
+                }
+                std::fflush(stdout);
+
+                // Free the pixels before letting the next image be rendered
+                image = nullptr;
+                std::lock_guard<std::mutex> lock(pendingMutex);
+                numPendingImages--;
+                pendingCondition.notify_one();
+            });
+        }
+        catch (const std::exception& e)
+        {
+            ReleaseDPI(dpi);
+
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::printf("FAIL %s: %s\n", args.size() >= 2 ? args[1].c_str() : line.c_str(), e.what());
+            std::fflush(stdout);
+            exitCode = -1;
+        }
     }
-    ReleaseDPI(dpi);
 
+    encodeJobs.Join();
+    viewport_set_force_multithreading(false);
     drawing_engine_dispose();
 
     return exitCode;
@@ -822,7 +1152,7 @@ void CaptureImage(const CaptureOptions& options)
     auto outputPath = ResolveFilenameForCapture(options.Filename);
     auto dpi = CreateDPI(viewport);
     RenderViewport(nullptr, viewport, dpi);
-    WriteDpiToFile(outputPath, &dpi, gPalette);
+    WriteDpiToFile(outputPath, &dpi, gPalette, GetScreenshotWriteOptions(options.CompressionLevel));
     ReleaseDPI(dpi);
 
     gCurrentRotation = backupRotation;
@@ -33,6 +33,7 @@ struct ScreenshotOptions
     bool remove_litter = false;
     bool tidy_up_park = false;
     bool transparent = false;
+    int32_t compression_level = -1;
 };
 
 struct CaptureView
@@ -48,6 +49,7 @@ struct CaptureOptions
     std::optional<CaptureView> View;
     ZoomLevel Zoom;
     uint8_t Rotation{};
+    std::optional<int32_t> CompressionLevel;
 };
 
 void screenshot_check();
@@ -57,6 +59,7 @@ std::string screenshot_dump_png_32bpp(int32_t width, int32_t height, const void*
 
 void screenshot_giant();
 int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOptions* options);
+int32_t cmdline_for_screenshot_batch(const char** argv, int32_t argc, ScreenshotOptions* options);
 int32_t cmdline_for_gfxbench(const char** argv, int32_t argc);
 
 void CaptureImage(const CaptureOptions& options);
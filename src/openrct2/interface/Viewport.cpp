@@ -44,6 +44,7 @@ rct_viewport g_viewport_list[MAX_VIEWPORT_COUNT];
 rct_viewport* g_music_tracking_viewport;
 
 static std::unique_ptr<JobPool> _paintJobs;
+static bool _forceMultithreading = false;
 
 ScreenCoordsXY gSavedView;
 ZoomLevel gSavedViewZoom;
@@ -778,6 +779,20 @@ void viewport_update_smart_vehicle_follow(rct_window* window)
     window->viewport_target_sprite = window->viewport_focus_sprite.sprite_id;
 }
 
+/**
+ * Paints on all cores regardless of the user's multithreading setting, used by headless rendering which must not
+ * change the configuration.
+ */
+void viewport_set_force_multithreading(bool force)
+{
+    _forceMultithreading = force;
+}
+
+bool viewport_is_multithreaded()
+{
+    return _forceMultithreading || gConfigGeneral.multithreading;
+}
+
 /**
  *
  *  rct2: 0x00685C02
@@ -945,7 +960,7 @@ void viewport_paint(
 
     std::vector<paint_session*> columns;
 
-    bool useMultithreading = gConfigGeneral.multithreading;
+    bool useMultithreading = viewport_is_multithreaded();
     if (useMultithreading && _paintJobs == nullptr)
     {
         _paintJobs = std::make_unique<JobPool>();
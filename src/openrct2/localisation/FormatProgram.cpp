@@ -0,0 +1,96 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "FormatProgram.h"
+
+#include "FormatCodes.h"
+#include "Language.h"
+
+#include <cstring>
+
+/**
+ * Number of raw argument bytes that follow an inline control code, mirroring format_string_part_from_raw.
+ */
+static size_t GetControlCodeArgumentLength(uint32_t code)
+{
+    if (code <= 4)
+        return 1;
+    if (code <= 16)
+        return 0;
+    if (code <= 22)
+        return 2;
+    return 4;
+}
+
+static bool IsFormatCode(uint32_t code)
+{
+    return code > 'z' && (code < FORMAT_COLOUR_CODE_START || code == FORMAT_COMMA1DP16);
+}
+
+FormatProgram FormatProgram::Compile(const utf8* source)
+{
+    FormatProgram program;
+    if (source == nullptr)
+    {
+        return program;
+    }
+
+    const utf8* ch = source;
+    const utf8* runStart = source;
+    auto flushRun = [&](const utf8* runEnd) {
+        if (runEnd > runStart)
+        {
+            program.Tokens.push_back(
+                { 0, static_cast<uint32_t>(runStart - source), static_cast<uint32_t>(runEnd - runStart) });
+        }
+    };
+
+    for (;;)
+    {
+        const utf8* next;
+        uint32_t code = utf8_get_next(ch, &next);
+        if (code == 0)
+        {
+            break;
+        }
+
+        // Literal runs are copied verbatim, which is only equivalent to the raw formatter if decoding and
+        // re-encoding the codepoint gives back the exact same bytes.
+        utf8 encoded[8];
+        auto encodedLength = static_cast<size_t>(utf8_write_codepoint(encoded, code) - encoded);
+        if (encodedLength != static_cast<size_t>(next - ch) || std::memcmp(encoded, ch, encodedLength) != 0)
+        {
+            return {};
+        }
+
+        if (code < ' ')
+        {
+            auto argLength = GetControlCodeArgumentLength(code);
+            for (size_t i = 0; i < argLength; i++)
+            {
+                if (next[i] == '\0')
+                {
+                    return {};
+                }
+            }
+            next += argLength;
+        }
+        else if (IsFormatCode(code))
+        {
+            flushRun(ch);
+            program.Tokens.push_back({ code, static_cast<uint32_t>(ch - source), static_cast<uint32_t>(next - ch) });
+            runStart = next;
+        }
+        ch = next;
+    }
+    flushRun(ch);
+
+    program.Source = source;
+    return program;
+}
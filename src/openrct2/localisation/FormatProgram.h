@@ -0,0 +1,48 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+
+#include <vector>
+
+/**
+ * A single step of a compiled format string. A token is either a run of bytes that is copied verbatim to the
+ * output or a format code (e.g. FORMAT_COMMA16) that consumes arguments.
+ */
+struct FormatToken
+{
+    // FORMAT_* code to execute, or 0 for a literal run
+    uint32_t Code;
+    uint32_t Offset;
+    uint32_t Length;
+};
+
+/**
+ * A language string pre-parsed into literal runs and format codes so that formatting does not need to decode
+ * the UTF-8 source one codepoint at a time. Literal runs point into Source, so a program is only valid while
+ * the string it was compiled from is alive and unchanged.
+ */
+struct FormatProgram
+{
+    const utf8* Source = nullptr;
+    std::vector<FormatToken> Tokens;
+
+    bool IsValid() const
+    {
+        return Source != nullptr;
+    }
+
+    /**
+     * Compiles the given string. Returns an invalid program if the string is not something the compiled path
+     * can reproduce byte for byte (e.g. malformed UTF-8), in which case the string should be formatted raw.
+     */
+    static FormatProgram Compile(const utf8* source);
+};
@@ -93,6 +93,12 @@ const char* language_get_string(rct_string_id id)
     return localisationService.GetString(id);
 }
 
+const FormatProgram* language_get_format_program(rct_string_id id)
+{
+    const auto& localisationService = OpenRCT2::GetContext()->GetLocalisationService();
+    return localisationService.GetFormatProgram(id);
+}
+
 bool language_open(int32_t id)
 {
     auto context = OpenRCT2::GetContext();
@@ -15,6 +15,7 @@
 #include "../core/String.hpp"
 #include "../core/StringBuilder.hpp"
 #include "../core/StringReader.hpp"
+#include "FormatProgram.h"
 #include "Language.h"
 #include "Localisation.h"
 
@@ -58,6 +59,7 @@ class LanguagePack final : public ILanguagePack
 private:
     uint16_t const _id;
     std::vector<std::string> _strings;
+    std::vector<FormatProgram> _programs;
     std::vector<ObjectOverride> _objectOverrides;
     std::vector<ScenarioOverride> _scenarioOverrides;
 
@@ -123,6 +125,13 @@ public:
         _currentGroup = std::string();
         _currentObjectOverride = nullptr;
         _currentScenarioOverride = nullptr;
+
+        // Compile every string up front so formatting never has to parse the raw text
+        _programs.resize(_strings.size());
+        for (size_t i = 0; i < _strings.size(); i++)
+        {
+            CompileString(static_cast<rct_string_id>(i));
+        }
     }
 
     uint16_t GetId() const override
@@ -140,6 +149,7 @@ public:
         if (_strings.size() >= static_cast<size_t>(stringId))
         {
             _strings[stringId] = std::string();
+            CompileString(stringId);
         }
     }
 
@@ -148,6 +158,7 @@ public:
         if (_strings.size() >= static_cast<size_t>(stringId))
         {
             _strings[stringId] = str;
+            CompileString(stringId);
         }
     }
 
@@ -198,6 +209,17 @@ public:
         }
     }
 
+    const FormatProgram* GetFormatProgram(rct_string_id stringId) const override
+    {
+        // Object and scenario overrides are rarely formatted, so they are left to the raw formatter
+        if (stringId < ObjectOverrideBase && _programs.size() > static_cast<size_t>(stringId)
+            && _programs[stringId].IsValid())
+        {
+            return &_programs[stringId];
+        }
+        return nullptr;
+    }
+
     rct_string_id GetObjectOverrideStringId(const std::string_view& legacyIdentifier, uint8_t index) override
     {
         Guard::Assert(index < ObjectOverrideMaxStringCount);
@@ -242,6 +264,15 @@ public:
     }
 
 private:
+    void CompileString(rct_string_id stringId)
+    {
+        if (_programs.size() > static_cast<size_t>(stringId))
+        {
+            const auto& str = _strings[stringId];
+            _programs[stringId] = str.empty() ? FormatProgram() : FormatProgram::Compile(str.c_str());
+        }
+    }
+
     ObjectOverride* GetObjectOverride(const std::string& objectIdentifier)
     {
         for (auto& oo : _objectOverrides)
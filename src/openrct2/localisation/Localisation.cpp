@@ -27,6 +27,7 @@
 #include "../ride/Ride.h"
 #include "../util/Util.h"
 #include "Date.h"
+#include "FormatProgram.h"
 #include "Localisation.h"
 
 #include <algorithm>
@@ -1222,6 +1223,34 @@ static void format_string_part_from_raw(utf8** dest, size_t* size, const utf8* s
     }
 }
 
+static void format_string_part_from_program(utf8** dest, size_t* size, const FormatProgram& program, char** args)
+{
+    for (const auto& token : program.Tokens)
+    {
+        if (*size <= 1)
+        {
+            return;
+        }
+
+        if (token.Code != 0)
+        {
+            format_string_code(token.Code, dest, size, args);
+        }
+        else if (*size > token.Length)
+        {
+            std::memcpy(*dest, program.Source + token.Offset, token.Length);
+            *dest += token.Length;
+            *size -= token.Length;
+        }
+        else
+        {
+            // The run does not fit, let the raw formatter truncate it at the same codepoint it always has
+            format_string_part_from_raw(dest, size, program.Source + token.Offset, args);
+            return;
+        }
+    }
+}
+
 static void format_string_part(utf8** dest, size_t* size, rct_string_id format, char** args)
 {
     if (format == STR_NONE)
@@ -1234,8 +1263,16 @@ static void format_string_part(utf8** dest, size_t* size, rct_string_id format,
     else if (format < USER_STRING_START)
     {
         // Language string
-        const utf8* rawString = language_get_string(format);
-        format_string_part_from_raw(dest, size, rawString, args);
+        const auto* program = language_get_format_program(format);
+        if (program != nullptr)
+        {
+            format_string_part_from_program(dest, size, *program, args);
+        }
+        else
+        {
+            const utf8* rawString = language_get_string(format);
+            format_string_part_from_raw(dest, size, rawString, args);
+        }
     }
     else if (format <= USER_STRING_END)
     {
@@ -66,6 +66,24 @@ const char* LocalisationService::GetString(rct_string_id id) const
     return result;
 }
 
+const FormatProgram* LocalisationService::GetFormatProgram(rct_string_id id) const
+{
+    // Must resolve to the same pack as GetString so the program matches the string that would be returned
+    if (id == STR_EMPTY || id == STR_NONE)
+    {
+        return nullptr;
+    }
+    if (_languageCurrent != nullptr && _languageCurrent->GetString(id) != nullptr)
+    {
+        return _languageCurrent->GetFormatProgram(id);
+    }
+    if (_languageFallback != nullptr && _languageFallback->GetString(id) != nullptr)
+    {
+        return _languageFallback->GetFormatProgram(id);
+    }
+    return nullptr;
+}
+
 std::string LocalisationService::GetLanguagePath(uint32_t languageId) const
 {
     auto locale = std::string(LanguagesDescriptors[languageId].locale);
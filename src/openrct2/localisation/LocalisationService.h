@@ -17,6 +17,7 @@
 #include <string_view>
 #include <tuple>
 
+struct FormatProgram;
 struct ILanguagePack;
 struct IObjectManager;
 
@@ -55,6 +56,7 @@ namespace OpenRCT2::Localisation
         ~LocalisationService();
 
         const char* GetString(rct_string_id id) const;
+        const FormatProgram* GetFormatProgram(rct_string_id id) const;
         std::tuple<rct_string_id, rct_string_id, rct_string_id> GetLocalisedScenarioStrings(
             const std::string& scenarioFilename) const;
         rct_string_id GetObjectOverrideStringId(const std::string_view& legacyIdentifier, uint8_t index) const;
@@ -10,7 +10,9 @@
 #include "ImageTable.h"
 
 #include "../OpenRCT2.h"
+#include "../core/FileStream.hpp"
 #include "../core/IStream.hpp"
+#include "../rct12/SawyerChunkReader.h"
 #include "Object.h"
 
 #include <algorithm>
@@ -19,7 +21,7 @@
 
 ImageTable::~ImageTable()
 {
-    if (_data == nullptr)
+    if (_data == nullptr && _sourcePath.empty())
     {
         for (auto& entry : _entries)
         {
@@ -49,6 +51,13 @@ void ImageTable::Read(IReadObjectContext* context, OpenRCT2::IStream* stream)
         }
 
         auto dataSize = static_cast<size_t>(imageDataSize);
+        auto legacyFilePath = context->GetLegacyFilePath();
+        if (!legacyFilePath.empty())
+        {
+            ReadHeaders(context, stream, numImages, dataSize, legacyFilePath);
+            return;
+        }
+
         auto data = std::make_unique<uint8_t[]>(dataSize);
         if (data == nullptr)
         {
@@ -88,6 +97,7 @@ void ImageTable::Read(IReadObjectContext* context, OpenRCT2::IStream* stream)
         }
 
         _data = std::move(data);
+        _dataSize = dataSize;
         _entries.insert(_entries.end(), newEntries.begin(), newEntries.end());
     }
     catch (const std::exception&)
@@ -97,6 +107,119 @@ void ImageTable::Read(IReadObjectContext* context, OpenRCT2::IStream* stream)
     }
 }
 
+void ImageTable::ReadHeaders(
+    IReadObjectContext* context, OpenRCT2::IStream* stream, uint32_t numImages, size_t dataSize,
+    std::string_view legacyFilePath)
+{
+    // Only read the headers now, the image data is read from the object file again when the images are first drawn
+    std::vector<rct_g1_element> newEntries;
+    std::vector<uint32_t> newDataOffsets;
+    for (uint32_t i = 0; i < numImages; i++)
+    {
+        rct_g1_element g1Element;
+
+        newDataOffsets.push_back(stream->ReadValue<uint32_t>());
+        g1Element.offset = nullptr;
+
+        g1Element.width = stream->ReadValue<int16_t>();
+        g1Element.height = stream->ReadValue<int16_t>();
+        g1Element.x_offset = stream->ReadValue<int16_t>();
+        g1Element.y_offset = stream->ReadValue<int16_t>();
+        g1Element.flags = stream->ReadValue<uint16_t>();
+        g1Element.zoomed_offset = stream->ReadValue<uint16_t>();
+
+        newEntries.push_back(g1Element);
+    }
+
+    auto position = static_cast<size_t>(stream->GetPosition());
+    auto length = static_cast<size_t>(stream->GetLength());
+    if (length - position < dataSize)
+    {
+        context->LogWarning(OBJECT_ERROR_BAD_IMAGE_TABLE, "Image table size shorter than expected.");
+    }
+
+    _sourcePath = legacyFilePath;
+    _sourceChunkLength = length;
+    _sourceDataPosition = position;
+    _dataSize = dataSize;
+    _imageDataOffsets = std::move(newDataOffsets);
+    _entries.insert(_entries.end(), newEntries.begin(), newEntries.end());
+    stream->SetPosition(std::min<uint64_t>(length, position + dataSize));
+}
+
+void ImageTable::LoadImageData()
+{
+    if (_data != nullptr || _sourcePath.empty())
+    {
+        return;
+    }
+
+    // Missing data is left as zeros so that a bad or changed file never leaves dangling image pointers
+    auto data = std::make_unique<uint8_t[]>(_dataSize);
+    try
+    {
+        auto fs = OpenRCT2::FileStream(_sourcePath, OpenRCT2::FILE_MODE_OPEN);
+        auto chunkReader = SawyerChunkReader(&fs);
+        fs.ReadValue<rct_object_entry>();
+        auto chunk = chunkReader.ReadChunk();
+        if (chunk->GetLength() == _sourceChunkLength)
+        {
+            auto available = std::min(_dataSize, _sourceChunkLength - _sourceDataPosition);
+            auto src = static_cast<const uint8_t*>(chunk->GetData()) + _sourceDataPosition;
+            std::copy_n(src, available, data.get());
+        }
+        else
+        {
+            log_error("Unable to load images from %s, the file has changed.", _sourcePath.c_str());
+        }
+    }
+    catch (const std::exception& e)
+    {
+        log_error("Unable to load images from %s: %s", _sourcePath.c_str(), e.what());
+    }
+
+    auto imageDataBase = reinterpret_cast<uintptr_t>(data.get());
+    for (size_t i = 0; i < _entries.size(); i++)
+    {
+        _entries[i].offset = reinterpret_cast<uint8_t*>(imageDataBase + _imageDataOffsets[i]);
+    }
+    _data = std::move(data);
+}
+
+void ImageTable::UnloadImageData()
+{
+    if (_sourcePath.empty())
+    {
+        return;
+    }
+
+    for (auto& entry : _entries)
+    {
+        entry.offset = nullptr;
+    }
+    _data = nullptr;
+}
+
+size_t ImageTable::GetImageDataSize() const
+{
+    return _dataSize;
+}
+
+size_t ImageTable::GetMemoryUsage() const
+{
+    auto usage = _entries.size() * sizeof(rct_g1_element);
+    if (_sourcePath.empty() || _data != nullptr)
+    {
+        usage += _dataSize;
+    }
+    return usage;
+}
+
+uint32_t ImageTable::AllocateImages()
+{
+    return gfx_object_allocate_images(_entries.data(), GetCount(), _sourcePath.empty() ? nullptr : this);
+}
+
 void ImageTable::AddImage(const rct_g1_element* g1)
 {
     rct_g1_element newg1 = *g1;
@@ -109,6 +232,7 @@ void ImageTable::AddImage(const rct_g1_element* g1)
     {
         newg1.offset = new uint8_t[length];
         std::copy_n(g1->offset, length, newg1.offset);
+        _dataSize += length;
     }
     _entries.push_back(newg1);
 }
@@ -13,6 +13,8 @@
 #include "../drawing/Drawing.h"
 
 #include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 
 struct IReadObjectContext;
@@ -21,18 +23,33 @@ namespace OpenRCT2
     struct IStream;
 }
 
-class ImageTable
+class ImageTable final : public IImageDataSource
 {
 private:
     std::unique_ptr<uint8_t[]> _data;
     std::vector<rct_g1_element> _entries;
 
+    // Where to read the image data from when it is loaded on demand, the position is within the decoded object chunk
+    std::string _sourcePath;
+    size_t _sourceChunkLength = 0;
+    size_t _sourceDataPosition = 0;
+    size_t _dataSize = 0;
+    std::vector<uint32_t> _imageDataOffsets;
+
+    void ReadHeaders(
+        IReadObjectContext* context, OpenRCT2::IStream* stream, uint32_t numImages, size_t dataSize,
+        std::string_view legacyFilePath);
+
 public:
     ImageTable() = default;
     ImageTable(const ImageTable&) = delete;
     ImageTable& operator=(const ImageTable&) = delete;
-    ~ImageTable();
+    ~ImageTable() override;
 
+    /**
+     * Reads the image table of a legacy object. When the object is read from a file, only the image headers are read
+     * and the data is left in the file until the images are first drawn or LoadImageData is called.
+     */
     void Read(IReadObjectContext* context, OpenRCT2::IStream* stream);
     const rct_g1_element* GetImages() const
     {
@@ -43,4 +60,11 @@ public:
         return static_cast<uint32_t>(_entries.size());
     }
     void AddImage(const rct_g1_element* g1);
+    uint32_t AllocateImages();
+    // Gets the number of bytes currently held for the images, not counting image data that has not been loaded yet
+    size_t GetMemoryUsage() const;
+
+    void LoadImageData() override;
+    void UnloadImageData() override;
+    size_t GetImageDataSize() const override;
 };
@@ -151,6 +151,8 @@ struct IReadObjectContext
     virtual IObjectRepository& GetObjectRepository() abstract;
     virtual bool ShouldLoadImages() abstract;
     virtual std::vector<uint8_t> GetData(const std::string_view& path) abstract;
+    // Path of the legacy object file being read if its image data may be read from it on demand, otherwise empty
+    virtual std::string_view GetLegacyFilePath() abstract;
 
     virtual void LogWarning(uint32_t code, const utf8* text) abstract;
     virtual void LogError(uint32_t code, const utf8* text) abstract;
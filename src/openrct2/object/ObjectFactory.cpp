@@ -90,6 +90,7 @@ private:
     std::string _identifier;
     bool _loadImages;
     std::string _basePath;
+    std::string _legacyFilePath;
     bool _wasWarning = false;
     bool _wasError = false;
 
@@ -137,6 +138,16 @@ public:
         return {};
     }
 
+    std::string_view GetLegacyFilePath() override
+    {
+        return _legacyFilePath;
+    }
+
+    void SetLegacyFilePath(const std::string_view& path)
+    {
+        _legacyFilePath = path;
+    }
+
     void LogWarning(uint32_t code, const utf8* text) override
     {
         _wasWarning = true;
@@ -196,17 +207,32 @@ namespace ObjectFactory
         }
     }
 
-    Object* CreateObjectFromLegacyFile(IObjectRepository& objectRepository, const utf8* path)
+    Object* CreateObjectFromLegacyFile(
+        IObjectRepository& objectRepository, const utf8* path, bool loadImageDataOnDemand)
     {
         log_verbose("CreateObjectFromLegacyFile(..., \"%s\")", path);
 
-        Object* result = nullptr;
         try
         {
             auto fs = OpenRCT2::FileStream(path, OpenRCT2::FILE_MODE_OPEN);
-            auto chunkReader = SawyerChunkReader(&fs);
+            return CreateObjectFromLegacyStream(objectRepository, &fs, path, loadImageDataOnDemand);
+        }
+        catch (const std::exception& e)
+        {
+            log_error("Error: %s when processing object %s", e.what(), path);
+        }
+        return nullptr;
+    }
+
+    Object* CreateObjectFromLegacyStream(
+        IObjectRepository& objectRepository, OpenRCT2::IStream* stream, const utf8* path, bool loadImageDataOnDemand)
+    {
+        Object* result = nullptr;
+        try
+        {
+            auto chunkReader = SawyerChunkReader(stream);
 
-            rct_object_entry entry = fs.ReadValue<rct_object_entry>();
+            rct_object_entry entry = stream->ReadValue<rct_object_entry>();
 
             if (entry.GetType() != OBJECT_TYPE_SCENARIO_TEXT)
             {
@@ -221,6 +247,10 @@ namespace ObjectFactory
 
                 auto chunkStream = OpenRCT2::MemoryStream(chunk->GetData(), chunk->GetLength());
                 auto readContext = ReadObjectContext(objectRepository, objectName, !gOpenRCT2NoGraphics, nullptr);
+                if (loadImageDataOnDemand)
+                {
+                    readContext.SetLegacyFilePath(path);
+                }
                 ReadObjectLegacy(result, &readContext, &chunkStream);
                 if (readContext.WasError())
                 {
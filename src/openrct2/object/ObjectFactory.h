@@ -17,9 +17,18 @@ struct IObjectRepository;
 class Object;
 struct rct_object_entry;
 
+namespace OpenRCT2
+{
+    struct IStream;
+}
+
 namespace ObjectFactory
 {
-    Object* CreateObjectFromLegacyFile(IObjectRepository& objectRepository, const utf8* path);
+    Object* CreateObjectFromLegacyFile(
+        IObjectRepository& objectRepository, const utf8* path, bool loadImageDataOnDemand = true);
+    Object* CreateObjectFromLegacyStream(
+        IObjectRepository& objectRepository, OpenRCT2::IStream* stream, const utf8* path,
+        bool loadImageDataOnDemand = true);
     Object* CreateObjectFromLegacyData(
         IObjectRepository& objectRepository, const rct_object_entry* entry, const void* data, size_t dataSize);
     Object* CreateObjectFromZipFile(IObjectRepository& objectRepository, const std::string_view& path);
@@ -26,18 +26,38 @@
 
 #include <algorithm>
 #include <array>
+#include <list>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <unordered_map>
 #include <unordered_set>
 
 class ObjectManager final : public IObjectManager
 {
 private:
+    // How much memory objects that are no longer used by the park may keep before being deleted
+    static constexpr size_t MAX_OBJECT_CACHE_SIZE = 128 * 1024 * 1024;
+
+    struct CachedObject
+    {
+        std::string Key;
+        Object* Obj{};
+        size_t Size{};
+    };
+
     IObjectRepository& _objectRepository;
     std::vector<Object*> _loadedObjects;
     std::array<std::vector<ObjectEntryIndex>, RIDE_TYPE_COUNT> _rideTypeToObjectMap;
 
+    // Unloaded objects kept so that the next park using them does not need to read them again, least recently
+    // unloaded first
+    std::list<CachedObject> _objectCache;
+    std::unordered_map<std::string, std::list<CachedObject>::iterator> _objectCacheMap;
+    size_t _objectCacheSize = 0;
+    std::mutex _objectCacheMutex;
+
     // Used to return a safe empty vector back from GetAllRideEntries, can be removed when std::span is available
     std::vector<ObjectEntryIndex> _nullRideTypeEntries;
 
@@ -54,6 +74,7 @@ public:
     ~ObjectManager() override
     {
         UnloadAll();
+        ClearObjectCache();
     }
 
     Object* GetLoadedObject(size_t index) override
@@ -377,8 +398,92 @@ private:
             }
 
             object->Unload();
-            delete object;
+            AddToObjectCache(object);
+        }
+    }
+
+    static std::string GetObjectCacheKey(const rct_object_entry& entry)
+    {
+        auto key = std::string(entry.name, sizeof(entry.name));
+        key.append(reinterpret_cast<const char*>(&entry.checksum), sizeof(entry.checksum));
+        return key;
+    }
+
+    void AddToObjectCache(Object* object)
+    {
+        std::lock_guard<std::mutex> lock(_objectCacheMutex);
+        auto key = GetObjectCacheKey(*object->GetObjectEntry());
+        auto it = _objectCacheMap.find(key);
+        if (it != _objectCacheMap.end())
+        {
+            // An older copy of the same object, only keep the newest one
+            _objectCacheSize -= it->second->Size;
+            delete it->second->Obj;
+            _objectCache.erase(it->second);
+            _objectCacheMap.erase(it);
+        }
+
+        auto size = static_cast<const Object*>(object)->GetImageTable().GetMemoryUsage();
+        _objectCache.push_back({ key, object, size });
+        _objectCacheMap[key] = std::prev(_objectCache.end());
+        _objectCacheSize += size;
+
+        while (_objectCacheSize > MAX_OBJECT_CACHE_SIZE && !_objectCache.empty())
+        {
+            auto& oldest = _objectCache.front();
+            _objectCacheSize -= oldest.Size;
+            delete oldest.Obj;
+            _objectCacheMap.erase(oldest.Key);
+            _objectCache.pop_front();
+        }
+    }
+
+    /**
+     * Removes the given object from the cache of unloaded objects, the returned object still needs to be loaded.
+     * Returns nullptr if the object is not cached.
+     */
+    Object* TakeFromObjectCache(const ObjectRepositoryItem* ori)
+    {
+        std::lock_guard<std::mutex> lock(_objectCacheMutex);
+        auto it = _objectCacheMap.find(GetObjectCacheKey(ori->ObjectEntry));
+        if (it == _objectCacheMap.end())
+        {
+            return nullptr;
         }
+
+        auto object = it->second->Obj;
+        _objectCacheSize -= it->second->Size;
+        _objectCache.erase(it->second);
+        _objectCacheMap.erase(it);
+        return object;
+    }
+
+    bool IsObjectCached(const ObjectRepositoryItem* ori)
+    {
+        std::lock_guard<std::mutex> lock(_objectCacheMutex);
+        return _objectCacheMap.find(GetObjectCacheKey(ori->ObjectEntry)) != _objectCacheMap.end();
+    }
+
+    void ClearObjectCache()
+    {
+        std::lock_guard<std::mutex> lock(_objectCacheMutex);
+        for (auto& cachedObject : _objectCache)
+        {
+            delete cachedObject.Obj;
+        }
+        _objectCache.clear();
+        _objectCacheMap.clear();
+        _objectCacheSize = 0;
+    }
+
+    Object* ReadObject(const ObjectRepositoryItem* ori)
+    {
+        auto object = TakeFromObjectCache(ori);
+        if (object == nullptr)
+        {
+            object = _objectRepository.LoadObject(ori);
+        }
+        return object;
     }
 
     void UnloadObjectsExcept(const std::vector<Object*>& newLoadedObjects)
@@ -509,7 +614,7 @@ private:
             {
                 Object* loadedObject = nullptr;
                 loadedObject = ori->LoadedObject;
-                if (loadedObject == nullptr)
+                if (loadedObject == nullptr && !IsObjectCached(ori))
                 {
                     loadedObject = _objectRepository.LoadObject(ori);
                     if (loadedObject == nullptr)
@@ -595,7 +700,7 @@ private:
                 loadedObject = ori->LoadedObject;
                 if (loadedObject == nullptr)
                 {
-                    loadedObject = _objectRepository.LoadObject(ori);
+                    loadedObject = ReadObject(ori);
                     if (loadedObject == nullptr)
                     {
                         std::lock_guard<std::mutex> guard(commonMutex);
@@ -643,7 +748,7 @@ private:
         if (loadedObject == nullptr)
         {
             // Try to load object
-            loadedObject = _objectRepository.LoadObject(ori);
+            loadedObject = ReadObject(ori);
             if (loadedObject != nullptr)
             {
                 loadedObject->Load();
@@ -39,6 +39,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -92,7 +93,17 @@ public:
     }
 
 public:
-    std::tuple<bool, ObjectRepositoryItem> Create([[maybe_unused]] int32_t language, const std::string& path) const override
+    std::tuple<bool, ObjectRepositoryItem> Create(int32_t language, const std::string& path) const override
+    {
+        return Create(language, path, nullptr);
+    }
+
+    /**
+     * Creates the item from the given stream of the file's contents, or from the file itself if stream is null. Only
+     * legacy objects are read from the stream, JSON and zipped objects refer to other files by their path.
+     */
+    std::tuple<bool, ObjectRepositoryItem> Create(
+        [[maybe_unused]] int32_t language, const std::string& path, IStream* stream) const override
     {
         Object* object = nullptr;
         auto extension = Path::GetExtension(path);
@@ -104,6 +115,10 @@ public:
         {
             object = ObjectFactory::CreateObjectFromZipFile(_objectRepository, path);
         }
+        else if (stream != nullptr)
+        {
+            object = ObjectFactory::CreateObjectFromLegacyStream(_objectRepository, stream, path.c_str());
+        }
         else
         {
             object = ObjectFactory::CreateObjectFromLegacyFile(_objectRepository, path.c_str());
@@ -229,6 +244,8 @@ class ObjectRepository final : public IObjectRepository
     ObjectFileIndex const _fileIndex;
     std::vector<ObjectRepositoryItem> _items;
     ObjectEntryMap _itemMap;
+    std::unique_ptr<ObjectRepository> _indexSnapshot;
+    std::optional<std::vector<ObjectRepositoryItem>> _indexUpdate;
 
 public:
     explicit ObjectRepository(const std::shared_ptr<IPlatformEnvironment>& env)
@@ -257,6 +274,53 @@ public:
         SortItems();
     }
 
+    void PrepareIndexUpdate() override
+    {
+        // Objects look up the repository while they are read, e.g. for the source game of banners, so the index is
+        // built by a copy of the items that objects added meanwhile do not modify
+        _indexSnapshot = std::make_unique<ObjectRepository>(_env);
+        _indexSnapshot->_items = _items;
+        _indexSnapshot->_itemMap = _itemMap;
+    }
+
+    void UpdateIndex(int32_t language) override
+    {
+        Guard::Assert(_indexSnapshot != nullptr, "PrepareIndexUpdate must be called first");
+        _indexUpdate = _indexSnapshot->_fileIndex.LoadOrBuild(language);
+    }
+
+    void ApplyIndexUpdate() override
+    {
+        if (!_indexUpdate)
+        {
+            return;
+        }
+
+        // Loaded objects keep their item, and with it their registration, until they are unloaded
+        std::vector<ObjectRepositoryItem> loadedItems;
+        for (auto& item : _items)
+        {
+            if (item.LoadedObject != nullptr)
+            {
+                loadedItems.push_back(std::move(item));
+            }
+        }
+
+        ClearItems();
+        AddItems(loadedItems);
+        for (const auto& item : *_indexUpdate)
+        {
+            auto existingItem = FindObject(&item.ObjectEntry);
+            if (existingItem == nullptr || existingItem->LoadedObject == nullptr)
+            {
+                AddItem(item);
+            }
+        }
+        SortItems();
+        _indexUpdate.reset();
+        _indexSnapshot.reset();
+    }
+
     size_t GetNumObjects() const override
     {
         return _items.size();
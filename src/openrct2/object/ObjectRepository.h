@@ -69,6 +69,18 @@ struct IObjectRepository
 
     virtual void LoadOrConstruct(int32_t language) abstract;
     virtual void Construct(int32_t language) abstract;
+    /**
+     * Copies the items that objects are resolved against while the index is updated. Must be called on the main thread
+     * before UpdateIndex.
+     */
+    virtual void PrepareIndexUpdate() abstract;
+    /**
+     * Brings the object index up to date with the object directories without touching the items in use, so it can run
+     * on a background thread. The changes are applied by ApplyIndexUpdate, which must be called on the main thread
+     * after UpdateIndex has returned.
+     */
+    virtual void UpdateIndex(int32_t language) abstract;
+    virtual void ApplyIndexUpdate() abstract;
     virtual size_t GetNumObjects() const abstract;
     virtual const ObjectRepositoryItem* GetObjects() const abstract;
     virtual const ObjectRepositoryItem* FindObject(const std::string_view& legacyIdentifier) const abstract;
@@ -74,7 +74,7 @@ void SmallSceneryObject::Load()
 {
     GetStringTable().Sort();
     _legacyType.name = language_allocate_object_string(GetName());
-    _legacyType.image = gfx_object_allocate_images(GetImageTable().GetImages(), GetImageTable().GetCount());
+    _legacyType.image = GetImageTable().AllocateImages();
 
     _legacyType.small_scenery.scenery_tab_id = OBJECT_ENTRY_INDEX_NULL;
 
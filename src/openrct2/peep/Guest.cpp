@@ -694,6 +694,34 @@ int32_t Guest::CheckEasterEggName(int32_t index) const
     return _stricmp(buffer, gPeepEasterEggNames[index]) == 0;
 }
 
+// Energy drops more slowly than it rises and wraps around when it drops below zero, which the clamp to
+// PEEP_MAX_ENERGY then turns into a jump to full energy. This matches the original.
+static constexpr int32_t GuestNeedDecreaseStep[GUEST_NEED_COUNT] = { 2, 4, 4 };
+static constexpr bool GuestNeedDecreaseWraps[GUEST_NEED_COUNT] = { true, false, false };
+static constexpr int32_t GuestNeedIncreaseLimit[GUEST_NEED_COUNT] = { PEEP_MAX_ENERGY_TARGET, 255, 255 };
+static constexpr int32_t GuestNeedMinimum[GUEST_NEED_COUNT] = { PEEP_MIN_ENERGY, 0, 0 };
+static constexpr int32_t GuestNeedMaximum[GUEST_NEED_COUNT] = { PEEP_MAX_ENERGY, 255, 255 };
+
+/**
+ * Moves each need 4 points (energy drops by 2) towards its target without overshooting it. The needs are updated as
+ * independent lanes with per-lane limits rather than three copies of the same branches, so the loop has no data
+ * dependent control flow and can be vectorised.
+ */
+void guest_update_needs_towards_targets(uint8_t (&needs)[GUEST_NEED_COUNT], const uint8_t (&targets)[GUEST_NEED_COUNT])
+{
+    for (int32_t i = 0; i < GUEST_NEED_COUNT; i++)
+    {
+        int32_t target = targets[i];
+        int32_t decreased = needs[i] - GuestNeedDecreaseStep[i];
+        decreased = GuestNeedDecreaseWraps[i] ? (decreased & 0xFF) : std::max(decreased, 0);
+        decreased = std::max(decreased, target);
+        int32_t increased = std::min({ needs[i] + 4, GuestNeedIncreaseLimit[i], target });
+
+        int32_t need = needs[i] >= target ? decreased : increased;
+        needs[i] = static_cast<uint8_t>(std::clamp(need, GuestNeedMinimum[i], GuestNeedMaximum[i]));
+    }
+}
+
 void Guest::loc_68F9F3()
 {
     // Idle peep happiness tends towards 127 (50%).
@@ -800,72 +828,16 @@ void Guest::loc_68FA89()
         }
     }
 
-    uint8_t newEnergy = Energy;
-    uint8_t newTargetEnergy = EnergyTarget;
-    if (newEnergy >= newTargetEnergy)
-    {
-        newEnergy -= 2;
-        if (newEnergy < newTargetEnergy)
-            newEnergy = newTargetEnergy;
-    }
-    else
-    {
-        newEnergy = std::min(PEEP_MAX_ENERGY_TARGET, newEnergy + 4);
-        if (newEnergy > newTargetEnergy)
-            newEnergy = newTargetEnergy;
-    }
-
-    if (newEnergy < PEEP_MIN_ENERGY)
-        newEnergy = PEEP_MIN_ENERGY;
-
-    /* Previous code here suggested maximum energy is 128. */
-    newEnergy = std::min(static_cast<uint8_t>(PEEP_MAX_ENERGY), newEnergy);
-
-    if (newEnergy != Energy)
-    {
-        Energy = newEnergy;
-        WindowInvalidateFlags |= PEEP_INVALIDATE_PEEP_2;
-    }
-
-    uint8_t newHappiness = Happiness;
-    uint8_t newHappinessGrowth = HappinessTarget;
-    if (newHappiness >= newHappinessGrowth)
-    {
-        newHappiness = std::max(newHappiness - 4, 0);
-        if (newHappiness < newHappinessGrowth)
-            newHappiness = newHappinessGrowth;
-    }
-    else
-    {
-        newHappiness = std::min(255, newHappiness + 4);
-        if (newHappiness > newHappinessGrowth)
-            newHappiness = newHappinessGrowth;
-    }
-
-    if (newHappiness != Happiness)
-    {
-        Happiness = newHappiness;
-        WindowInvalidateFlags |= PEEP_INVALIDATE_PEEP_2;
-    }
-
-    uint8_t newNausea = Nausea;
-    uint8_t newNauseaGrowth = NauseaTarget;
-    if (newNausea >= newNauseaGrowth)
-    {
-        newNausea = std::max(newNausea - 4, 0);
-        if (newNausea < newNauseaGrowth)
-            newNausea = newNauseaGrowth;
-    }
-    else
-    {
-        newNausea = std::min(255, newNausea + 4);
-        if (newNausea > newNauseaGrowth)
-            newNausea = newNauseaGrowth;
-    }
+    uint8_t needs[GUEST_NEED_COUNT] = { Energy, Happiness, Nausea };
+    const uint8_t targets[GUEST_NEED_COUNT] = { EnergyTarget, HappinessTarget, NauseaTarget };
+    guest_update_needs_towards_targets(needs, targets);
 
-    if (newNausea != Nausea)
+    if (needs[GUEST_NEED_ENERGY] != Energy || needs[GUEST_NEED_HAPPINESS] != Happiness
+        || needs[GUEST_NEED_NAUSEA] != Nausea)
     {
-        Nausea = newNausea;
+        Energy = needs[GUEST_NEED_ENERGY];
+        Happiness = needs[GUEST_NEED_HAPPINESS];
+        Nausea = needs[GUEST_NEED_NAUSEA];
         WindowInvalidateFlags |= PEEP_INVALIDATE_PEEP_2;
     }
 }
@@ -1932,39 +1904,13 @@ std::bitset<MAX_RIDES> Guest::FindRidesToGoOn()
     else
     {
         // Take nearby rides into consideration
-        constexpr auto radius = 10 * 32;
-        int32_t cx = floor2(x, 32);
-        int32_t cy = floor2(y, 32);
-        for (int32_t tileX = cx - radius; tileX <= cx + radius; tileX += COORDS_XY_STEP)
-        {
-            for (int32_t tileY = cy - radius; tileY <= cy + radius; tileY += COORDS_XY_STEP)
-            {
-                if (map_is_location_valid({ tileX, tileY }))
-                {
-                    auto tileElement = map_get_first_element_at({ tileX, tileY });
-                    if (tileElement != nullptr)
-                    {
-                        do
-                        {
-                            if (tileElement->GetType() == TILE_ELEMENT_TYPE_TRACK)
-                            {
-                                auto rideIndex = tileElement->AsTrack()->GetRideIndex();
-                                rideConsideration[rideIndex] = true;
-                            }
-                        } while (!(tileElement++)->IsLastForTile());
-                    }
-                }
-            }
-        }
+        constexpr auto radius = 10;
+        int32_t cx = floor2(x, 32) / COORDS_XY_STEP;
+        int32_t cy = floor2(y, 32) / COORDS_XY_STEP;
+        rideConsideration = ride_get_rides_with_track_in({ cx - radius, cy - radius }, { cx + radius, cy + radius });
 
         // Always take the tall rides into consideration (realistic as you can usually see them from anywhere in the park)
-        for (auto& ride : GetRideManager())
-        {
-            if (ride.highest_drop_height > 66 || ride.excitement >= RIDE_RATING(8, 00))
-            {
-                rideConsideration[ride.id] = true;
-            }
-        }
+        rideConsideration |= ride_get_rides_visible_from_anywhere();
     }
 
     return rideConsideration;
@@ -395,6 +395,8 @@ void peep_update_all()
     if (gScreenFlags & SCREEN_FLAGS_EDITOR)
         return;
 
+    ride_update_rides_visible_from_anywhere();
+
     int32_t i = 0;
     // Warning this loop can delete peeps
     for (auto peep : EntityList<Peep>(EntityListId::Peep))
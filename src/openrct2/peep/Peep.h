@@ -1018,6 +1018,15 @@ extern TileCoordsXYZ gPeepPathFindGoalPosition;
 extern bool gPeepPathFindIgnoreForeignQueues;
 extern ride_id_t gPeepPathFindQueueRideIndex;
 
+// Needs that move a few points towards their target every 128 ticks
+enum
+{
+    GUEST_NEED_ENERGY,
+    GUEST_NEED_HAPPINESS,
+    GUEST_NEED_NAUSEA,
+    GUEST_NEED_COUNT
+};
+
 Peep* try_get_guest(uint16_t spriteIndex);
 int32_t peep_get_staff_count();
 bool peep_can_be_picked_up(Peep* peep);
@@ -1030,6 +1039,7 @@ void peep_applause();
 void peep_thought_set_format_args(const rct_peep_thought* thought);
 int32_t get_peep_face_sprite_small(Peep* peep);
 int32_t get_peep_face_sprite_large(Peep* peep);
+void guest_update_needs_towards_targets(uint8_t (&needs)[GUEST_NEED_COUNT], const uint8_t (&targets)[GUEST_NEED_COUNT]);
 void game_command_pickup_guest(
     int32_t* eax, int32_t* ebx, int32_t* ecx, int32_t* edx, int32_t* esi, int32_t* edi, int32_t* ebp);
 void peep_sprite_remove(Peep* peep);
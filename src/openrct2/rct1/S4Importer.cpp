@@ -209,6 +209,7 @@ public:
         determine_ride_entrance_and_exit_locations();
 
         game_convert_news_items_to_utf8();
+        map_remove_elements_outside_map();
         map_count_remaining_land_rights();
         research_determine_first_of_type();
     }
@@ -1988,10 +1989,11 @@ private:
     {
         gMapBaseZ = 7;
 
-        for (uint32_t index = 0, dstOffset = 0; index < RCT1_MAX_TILE_ELEMENTS; index++)
+        std::vector<TileElement> tileElements(RCT1_MAX_TILE_ELEMENTS);
+        for (uint32_t index = 0; index < RCT1_MAX_TILE_ELEMENTS; index++)
         {
             auto src = &_s4.tile_elements[index];
-            auto dst = &gTileElements[index + dstOffset];
+            auto dst = &tileElements[index];
             if (src->base_height == RCT12_MAX_ELEMENT_HEIGHT)
             {
                 std::memcpy(dst, src, sizeof(*src));
@@ -2002,7 +2004,7 @@ private:
             }
         }
 
-        ClearExtraTileEntries();
+        ClearExtraTileEntries(tileElements);
         FixWalls();
         FixEntrancePositions();
     }
@@ -2729,61 +2731,43 @@ private:
         gSavedViewRotation = _s4.view_rotation;
     }
 
-    void ClearExtraTileEntries()
+    void ClearExtraTileEntries(const std::vector<TileElement>& rct1TileElements)
     {
-        // Reset the map tile pointers
-        std::fill(std::begin(gTileElementTilePointers), std::end(gTileElementTilePointers), nullptr);
+        TileElement blankSurface{};
+        blankSurface.ClearAs(TILE_ELEMENT_TYPE_SURFACE);
+        blankSurface.SetLastForTile(true);
+        blankSurface.AsSurface()->SetSlope(TILE_ELEMENT_SLOPE_FLAT);
+        blankSurface.AsSurface()->SetSurfaceStyle(TERRAIN_GRASS);
+        blankSurface.AsSurface()->SetEdgeStyle(TERRAIN_EDGE_ROCK);
+        blankSurface.AsSurface()->SetGrassLength(GRASS_LENGTH_CLEAR_0);
+        blankSurface.AsSurface()->SetOwnership(OWNERSHIP_UNOWNED);
 
-        // Get the first free map element
-        TileElement* nextFreeTileElement = gTileElements;
-        for (size_t i = 0; i < RCT1_MAX_MAP_SIZE * RCT1_MAX_MAP_SIZE; i++)
-        {
-            while (!(nextFreeTileElement++)->IsLastForTile())
-                ;
-        }
-
-        TileElement* tileElement = gTileElements;
-        TileElement** tilePointer = gTileElementTilePointers;
+        std::vector<TileElement> tileElements;
+        tileElements.reserve(rct1TileElements.size() + MAX_TILE_TILE_ELEMENT_POINTERS);
 
         // 128 rows of map data from RCT1 map
+        size_t index = 0;
         for (int32_t x = 0; x < RCT1_MAX_MAP_SIZE; x++)
         {
-            // Assign the first half of this row
+            // Copy the first half of this row
             for (int32_t y = 0; y < RCT1_MAX_MAP_SIZE; y++)
             {
-                *tilePointer++ = tileElement;
-                while (!(tileElement++)->IsLastForTile())
-                    ;
+                while (index < rct1TileElements.size())
+                {
+                    tileElements.push_back(rct1TileElements[index]);
+                    if (rct1TileElements[index++].IsLastForTile())
+                        break;
+                }
             }
 
             // Fill the rest of the row with blank tiles
-            for (int32_t y = 0; y < RCT1_MAX_MAP_SIZE; y++)
-            {
-                nextFreeTileElement->ClearAs(TILE_ELEMENT_TYPE_SURFACE);
-                nextFreeTileElement->SetLastForTile(true);
-                nextFreeTileElement->AsSurface()->SetSlope(TILE_ELEMENT_SLOPE_FLAT);
-                nextFreeTileElement->AsSurface()->SetSurfaceStyle(TERRAIN_GRASS);
-                nextFreeTileElement->AsSurface()->SetEdgeStyle(TERRAIN_EDGE_ROCK);
-                nextFreeTileElement->AsSurface()->SetGrassLength(GRASS_LENGTH_CLEAR_0);
-                nextFreeTileElement->AsSurface()->SetOwnership(OWNERSHIP_UNOWNED);
-                *tilePointer++ = nextFreeTileElement++;
-            }
+            tileElements.insert(tileElements.end(), RCT1_MAX_MAP_SIZE, blankSurface);
         }
 
         // 128 extra rows left to fill with blank tiles
-        for (int32_t y = 0; y < 128 * 256; y++)
-        {
-            nextFreeTileElement->ClearAs(TILE_ELEMENT_TYPE_SURFACE);
-            nextFreeTileElement->SetLastForTile(true);
-            nextFreeTileElement->AsSurface()->SetSlope(TILE_ELEMENT_SLOPE_FLAT);
-            nextFreeTileElement->AsSurface()->SetSurfaceStyle(TERRAIN_GRASS);
-            nextFreeTileElement->AsSurface()->SetEdgeStyle(TERRAIN_EDGE_ROCK);
-            nextFreeTileElement->AsSurface()->SetGrassLength(GRASS_LENGTH_CLEAR_0);
-            nextFreeTileElement->AsSurface()->SetOwnership(OWNERSHIP_UNOWNED);
-            *tilePointer++ = nextFreeTileElement++;
-        }
+        tileElements.insert(tileElements.end(), 128 * 256, blankSurface);
 
-        gNextFreeTileElement = nextFreeTileElement;
+        map_load_tile_elements(tileElements);
     }
 
     void FixWalls()
@@ -52,6 +52,8 @@
 #include <functional>
 #include <iterator>
 #include <optional>
+#include <stdexcept>
+#include <string>
 
 S6Exporter::S6Exporter()
 {
@@ -1407,9 +1409,20 @@ void S6Exporter::ExportMapAnimations()
 
 void S6Exporter::ExportTileElements()
 {
+    // Flatten the per tile storage into the fixed size S6 array, any remaining space is left zeroed as before. The map
+    // can hold more elements than the S6 format, such parks fail to save rather than being truncated.
+    auto tileElements = map_get_tile_elements();
+    if (tileElements.size() > RCT2_MAX_TILE_ELEMENTS)
+    {
+        throw std::runtime_error(
+            "The park has " + std::to_string(tileElements.size()) + " tile elements, the S6 format can only hold "
+            + std::to_string(RCT2_MAX_TILE_ELEMENTS) + ".");
+    }
+    tileElements.resize(RCT2_MAX_TILE_ELEMENTS, TileElement{});
+
     for (uint32_t index = 0; index < RCT2_MAX_TILE_ELEMENTS; index++)
     {
-        auto src = &gTileElements[index];
+        auto src = &tileElements[index];
         auto dst = &_s6.tile_elements[index];
         if (src->base_height == MAX_ELEMENT_HEIGHT)
         {
@@ -455,7 +455,7 @@ public:
 
         // Fix and set dynamic variables
         map_strip_ghost_flag_from_elements();
-        map_update_tile_pointers();
+        map_remove_elements_outside_map();
         game_convert_strings_to_utf8();
         map_count_remaining_land_rights();
         determine_ride_entrance_and_exit_locations();
@@ -1031,10 +1031,11 @@ public:
 
     void ImportTileElements()
     {
+        std::vector<TileElement> tileElements(RCT2_MAX_TILE_ELEMENTS);
         for (uint32_t index = 0; index < RCT2_MAX_TILE_ELEMENTS; index++)
         {
             auto src = &_s6.tile_elements[index];
-            auto dst = &gTileElements[index];
+            auto dst = &tileElements[index];
             if (src->base_height == RCT12_MAX_ELEMENT_HEIGHT)
             {
                 std::memcpy(dst, src, sizeof(*src));
@@ -1051,6 +1052,7 @@ public:
                     ImportTileElement(dst, src);
             }
         }
+        map_load_tile_elements(tileElements);
         gNextFreeTileElementPointerIndex = _s6.next_free_tile_element_pointer_index;
     }
 
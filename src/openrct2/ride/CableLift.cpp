@@ -266,7 +266,7 @@ bool Vehicle::CableLiftUpdateTrackMotionForwards()
 
         track_progress = trackProgress;
         const auto moveInfo = GetMoveInfo();
-        auto unk = CoordsXYZ{ moveInfo->x, moveInfo->y, moveInfo->z } + TrackLocation;
+        auto unk = CoordsXYZ{ moveInfo.x, moveInfo.y, moveInfo.z } + TrackLocation;
 
         uint8_t bx = 0;
         unk.z += RideTypeDescriptors[curRide->type].Heights.VehicleZOffset;
@@ -282,9 +282,9 @@ bool Vehicle::CableLiftUpdateTrackMotionForwards()
         unk_F64E20.y = unk.y;
         unk_F64E20.z = unk.z;
 
-        sprite_direction = moveInfo->direction;
-        bank_rotation = moveInfo->bank_rotation;
-        vehicle_sprite_type = moveInfo->vehicle_sprite_type;
+        sprite_direction = moveInfo.direction;
+        bank_rotation = moveInfo.bank_rotation;
+        vehicle_sprite_type = moveInfo.vehicle_sprite_type;
 
         if (remaining_distance >= 13962)
         {
@@ -332,7 +332,7 @@ bool Vehicle::CableLiftUpdateTrackMotionBackwards()
         }
         track_progress = trackProgress;
         const auto moveInfo = GetMoveInfo();
-        auto unk = CoordsXYZ{ moveInfo->x, moveInfo->y, moveInfo->z } + TrackLocation;
+        auto unk = CoordsXYZ{ moveInfo.x, moveInfo.y, moveInfo.z } + TrackLocation;
 
         uint8_t bx = 0;
         unk.z += RideTypeDescriptors[curRide->type].Heights.VehicleZOffset;
@@ -348,9 +348,9 @@ bool Vehicle::CableLiftUpdateTrackMotionBackwards()
         unk_F64E20.y = unk.y;
         unk_F64E20.z = unk.z;
 
-        sprite_direction = moveInfo->direction;
-        bank_rotation = moveInfo->bank_rotation;
-        vehicle_sprite_type = moveInfo->vehicle_sprite_type;
+        sprite_direction = moveInfo.direction;
+        bank_rotation = moveInfo.bank_rotation;
+        vehicle_sprite_type = moveInfo.vehicle_sprite_type;
 
         if (remaining_distance < 0)
         {
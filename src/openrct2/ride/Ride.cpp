@@ -63,6 +63,7 @@
 #include "TrackDesign.h"
 
 #include <algorithm>
+#include <bitset>
 #include <cassert>
 #include <climits>
 #include <cstdlib>
@@ -434,41 +435,45 @@ bool ride_try_get_origin_element(const Ride* ride, CoordsXYE* output)
 {
     TileElement* resultTileElement = nullptr;
 
-    tile_element_iterator it;
-    tile_element_iterator_begin(&it);
-    do
+    for (const auto& tilePos : map_get_tiles_with_elements(tile_element_type_flag(TILE_ELEMENT_TYPE_TRACK)))
     {
-        if (it.element->GetType() != TILE_ELEMENT_TYPE_TRACK)
-            continue;
-        if (it.element->AsTrack()->GetRideIndex() != ride->id)
+        auto tileElement = map_get_first_element_at(tilePos.ToCoordsXY());
+        if (tileElement == nullptr)
             continue;
+        do
+        {
+            if (tileElement->GetType() != TILE_ELEMENT_TYPE_TRACK)
+                continue;
+            if (tileElement->AsTrack()->GetRideIndex() != ride->id)
+                continue;
 
-        // Found a track piece for target ride
-
-        // Check if it's not the station or ??? (but allow end piece of station)
-        bool specialTrackPiece
-            = (it.element->AsTrack()->GetTrackType() != TRACK_ELEM_BEGIN_STATION
-               && it.element->AsTrack()->GetTrackType() != TRACK_ELEM_MIDDLE_STATION
-               && (TrackSequenceProperties[it.element->AsTrack()->GetTrackType()][0] & TRACK_SEQUENCE_FLAG_ORIGIN));
+            // Found a track piece for target ride
 
-        // Set result tile to this track piece if first found track or a ???
-        if (resultTileElement == nullptr || specialTrackPiece)
-        {
-            resultTileElement = it.element;
+            // Check if it's not the station or ??? (but allow end piece of station)
+            bool specialTrackPiece
+                = (tileElement->AsTrack()->GetTrackType() != TRACK_ELEM_BEGIN_STATION
+                   && tileElement->AsTrack()->GetTrackType() != TRACK_ELEM_MIDDLE_STATION
+                   && (TrackSequenceProperties[tileElement->AsTrack()->GetTrackType()][0] & TRACK_SEQUENCE_FLAG_ORIGIN));
 
-            if (output != nullptr)
+            // Set result tile to this track piece if first found track or a ???
+            if (resultTileElement == nullptr || specialTrackPiece)
             {
-                output->element = resultTileElement;
-                output->x = it.x * COORDS_XY_STEP;
-                output->y = it.y * COORDS_XY_STEP;
+                resultTileElement = tileElement;
+
+                if (output != nullptr)
+                {
+                    output->element = resultTileElement;
+                    output->x = tilePos.x * COORDS_XY_STEP;
+                    output->y = tilePos.y * COORDS_XY_STEP;
+                }
             }
-        }
 
-        if (specialTrackPiece)
-        {
-            return true;
-        }
-    } while (tile_element_iterator_next(&it));
+            if (specialTrackPiece)
+            {
+                return true;
+            }
+        } while (!(tileElement++)->IsLastForTile());
+    }
 
     return resultTileElement != nullptr;
 }
@@ -5872,24 +5877,139 @@ bool Ride::IsBlockSectioned() const
 
 bool ride_has_any_track_elements(const Ride* ride)
 {
-    tile_element_iterator it;
-
-    tile_element_iterator_begin(&it);
-    while (tile_element_iterator_next(&it))
+    for (const auto& tilePos : map_get_tiles_with_elements(tile_element_type_flag(TILE_ELEMENT_TYPE_TRACK)))
     {
-        if (it.element->GetType() != TILE_ELEMENT_TYPE_TRACK)
-            continue;
-        if (it.element->AsTrack()->GetRideIndex() != ride->id)
-            continue;
-        if (it.element->IsGhost())
+        auto tileElement = map_get_first_element_at(tilePos.ToCoordsXY());
+        if (tileElement == nullptr)
             continue;
+        do
+        {
+            if (tileElement->GetType() != TILE_ELEMENT_TYPE_TRACK)
+                continue;
+            if (tileElement->AsTrack()->GetRideIndex() != ride->id)
+                continue;
+            if (tileElement->IsGhost())
+                continue;
 
-        return true;
+            return true;
+        } while (!(tileElement++)->IsLastForTile());
     }
 
     return false;
 }
 
+// Rides with track, including ghosts, in each cell of MAP_CELL_SIZE tiles along with the tiles of the cell they are on,
+// so that finding the rides within an area does not need to look at every element of every tile. A cell is rebuilt
+// when it is next looked at after any of its tiles have changed.
+struct RideFootprintCell
+{
+    uint32_t Generation;
+    bool IsBuilt;
+    // Bit y * MAP_CELL_SIZE + x is set for each tile of the cell the ride has track on
+    std::vector<std::pair<ride_id_t, uint64_t>> Rides;
+};
+static_assert(MAP_CELL_SIZE * MAP_CELL_SIZE <= 64);
+static RideFootprintCell _rideFootprintCells[MAP_CELL_COUNT_XY * MAP_CELL_COUNT_XY];
+static std::bitset<MAX_RIDES> _ridesVisibleFromAnywhere;
+
+static const RideFootprintCell& ride_get_footprint_cell(const TileCoordsXY& cellPos)
+{
+    auto& cell = _rideFootprintCells[cellPos.x + cellPos.y * MAP_CELL_COUNT_XY];
+    auto generation = map_get_cell_elements_generation(cellPos);
+    if (cell.IsBuilt && cell.Generation == generation)
+        return cell;
+
+    cell.Rides.clear();
+    for (int32_t y = 0; y < MAP_CELL_SIZE; y++)
+    {
+        for (int32_t x = 0; x < MAP_CELL_SIZE; x++)
+        {
+            auto tilePos = TileCoordsXY{ cellPos.x * MAP_CELL_SIZE + x, cellPos.y * MAP_CELL_SIZE + y };
+            auto tileElement = map_get_first_element_at(tilePos.ToCoordsXY());
+            if (tileElement == nullptr)
+                continue;
+            do
+            {
+                if (tileElement->GetType() != TILE_ELEMENT_TYPE_TRACK)
+                    continue;
+
+                auto rideIndex = tileElement->AsTrack()->GetRideIndex();
+                auto it = std::find_if(cell.Rides.begin(), cell.Rides.end(), [rideIndex](const auto& ride) {
+                    return ride.first == rideIndex;
+                });
+                if (it == cell.Rides.end())
+                {
+                    it = cell.Rides.emplace(cell.Rides.end(), rideIndex, 0);
+                }
+                it->second |= static_cast<uint64_t>(1) << (y * MAP_CELL_SIZE + x);
+            } while (!(tileElement++)->IsLastForTile());
+        }
+    }
+    cell.Generation = generation;
+    cell.IsBuilt = true;
+    return cell;
+}
+
+/**
+ * Gets the rides that have any track, including ghost track, on the tiles between the given corners (inclusive).
+ */
+std::bitset<MAX_RIDES> ride_get_rides_with_track_in(const TileCoordsXY& min, const TileCoordsXY& max)
+{
+    std::bitset<MAX_RIDES> rides;
+    auto left = std::max(min.x, 0);
+    auto top = std::max(min.y, 0);
+    auto right = std::min(max.x, MAXIMUM_MAP_SIZE_TECHNICAL - 1);
+    auto bottom = std::min(max.y, MAXIMUM_MAP_SIZE_TECHNICAL - 1);
+    for (int32_t cellY = top / MAP_CELL_SIZE; cellY <= bottom / MAP_CELL_SIZE; cellY++)
+    {
+        for (int32_t cellX = left / MAP_CELL_SIZE; cellX <= right / MAP_CELL_SIZE; cellX++)
+        {
+            // Tiles of the cell that are within the range
+            auto cellLeft = std::max(left - cellX * MAP_CELL_SIZE, 0);
+            auto cellTop = std::max(top - cellY * MAP_CELL_SIZE, 0);
+            auto cellRight = std::min(right - cellX * MAP_CELL_SIZE, MAP_CELL_SIZE - 1);
+            auto cellBottom = std::min(bottom - cellY * MAP_CELL_SIZE, MAP_CELL_SIZE - 1);
+            uint64_t rowMask = ((static_cast<uint64_t>(1) << (cellRight - cellLeft + 1)) - 1) << cellLeft;
+            uint64_t mask = 0;
+            for (int32_t y = cellTop; y <= cellBottom; y++)
+            {
+                mask |= rowMask << (y * MAP_CELL_SIZE);
+            }
+
+            for (const auto& [rideIndex, tiles] : ride_get_footprint_cell({ cellX, cellY }).Rides)
+            {
+                if ((tiles & mask) != 0 && rideIndex < MAX_RIDES)
+                {
+                    rides[rideIndex] = true;
+                }
+            }
+        }
+    }
+    return rides;
+}
+
+/**
+ * Works out which rides are tall or exciting enough for guests to see them from anywhere in the park. Ratings and
+ * drop heights do not change while guests are being updated, so this only needs to be done once per update rather
+ * than every time a guest thinks about which ride to go on next.
+ */
+void ride_update_rides_visible_from_anywhere()
+{
+    _ridesVisibleFromAnywhere.reset();
+    for (const auto& ride : GetRideManager())
+    {
+        if (ride.highest_drop_height > 66 || ride.excitement >= RIDE_RATING(8, 00))
+        {
+            _ridesVisibleFromAnywhere[ride.id] = true;
+        }
+    }
+}
+
+const std::bitset<MAX_RIDES>& ride_get_rides_visible_from_anywhere()
+{
+    return _ridesVisibleFromAnywhere;
+}
+
 /**
  *
  *  rct2: 0x006847BA
@@ -7545,17 +7665,29 @@ void determine_ride_entrance_and_exit_locations()
 
 void ride_clear_leftover_entrances(Ride* ride)
 {
-    tile_element_iterator it;
-
-    tile_element_iterator_begin(&it);
-    while (tile_element_iterator_next(&it))
+    for (const auto& tilePos : map_get_tiles_with_elements(tile_element_type_flag(TILE_ELEMENT_TYPE_ENTRANCE)))
     {
-        if (it.element->GetType() == TILE_ELEMENT_TYPE_ENTRANCE
-            && it.element->AsEntrance()->GetEntranceType() != ENTRANCE_TYPE_PARK_ENTRANCE
-            && it.element->AsEntrance()->GetRideIndex() == ride->id)
+        auto tileElement = map_get_first_element_at(tilePos.ToCoordsXY());
+        while (tileElement != nullptr)
         {
-            tile_element_remove(it.element);
-            tile_element_iterator_restart_for_tile(&it);
+            if (tileElement->GetType() == TILE_ELEMENT_TYPE_ENTRANCE
+                && tileElement->AsEntrance()->GetEntranceType() != ENTRANCE_TYPE_PARK_ENTRANCE
+                && tileElement->AsEntrance()->GetRideIndex() == ride->id)
+            {
+                // The remaining elements move down, so look at the same slot again
+                bool wasLast = tileElement->IsLastForTile();
+                tile_element_remove(tileElement);
+                if (wasLast)
+                    break;
+            }
+            else if (tileElement->IsLastForTile())
+            {
+                break;
+            }
+            else
+            {
+                tileElement++;
+            }
         }
     }
 }
@@ -18,6 +18,7 @@
 #include "RideTypes.h"
 #include "Vehicle.h"
 
+#include <bitset>
 #include <limits>
 #include <string_view>
 
@@ -1154,6 +1155,9 @@ uint8_t ride_get_helix_sections(Ride* ride);
 
 bool ride_type_has_flag(int32_t rideType, uint64_t flag);
 bool ride_has_any_track_elements(const Ride* ride);
+std::bitset<MAX_RIDES> ride_get_rides_with_track_in(const TileCoordsXY& min, const TileCoordsXY& max);
+void ride_update_rides_visible_from_anywhere();
+const std::bitset<MAX_RIDES>& ride_get_rides_visible_from_anywhere();
 
 void ride_construction_set_default_next_piece();
 
@@ -28,7 +28,8 @@
 #include "Track.h"
 #include "TrackPaint.h"
 
-using ride_ratings_calculation = void (*)(Ride* ride);
+struct RideRatingCalculationData;
+using ride_ratings_calculation = void (*)(RideRatingCalculationData& state, Ride* ride);
 struct RideComponentName
 {
     rct_string_id singular;
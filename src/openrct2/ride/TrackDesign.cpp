@@ -66,9 +66,7 @@ using namespace OpenRCT2::Drawing;
 
 struct map_backup
 {
-    TileElement tile_elements[MAX_TILE_ELEMENTS];
-    TileElement* tile_pointers[MAX_TILE_TILE_ELEMENT_POINTERS];
-    TileElement* next_free_tile_element;
+    std::vector<TileElement> tile_elements;
     uint16_t map_size_units;
     uint16_t map_size_units_minus_2;
     uint16_t map_size;
@@ -638,6 +636,25 @@ std::unique_ptr<TrackDesign> track_design_open(const utf8* path)
     return nullptr;
 }
 
+/**
+ * Opens the track design from a stream of the file's contents, the path is only used to determine the format.
+ */
+std::unique_ptr<TrackDesign> track_design_open(const utf8* path, OpenRCT2::IStream* stream)
+{
+    try
+    {
+        auto trackImporter = TrackImporter::Create(path);
+        trackImporter->LoadFromStream(stream);
+        return trackImporter->Import();
+    }
+    catch (const std::exception& e)
+    {
+        log_error("Unable to load track design: %s", e.what());
+    }
+    log_verbose("track_design_open(\"%s\")", path);
+    return nullptr;
+}
+
 /**
  *
  *  rct2: 0x006ABDB0
@@ -2099,9 +2116,7 @@ static std::unique_ptr<map_backup> track_design_preview_backup_map()
     auto backup = std::make_unique<map_backup>();
     if (backup != nullptr)
     {
-        std::memcpy(backup->tile_elements, gTileElements, sizeof(backup->tile_elements));
-        std::memcpy(backup->tile_pointers, gTileElementTilePointers, sizeof(backup->tile_pointers));
-        backup->next_free_tile_element = gNextFreeTileElement;
+        backup->tile_elements = map_get_tile_elements();
         backup->map_size_units = gMapSizeUnits;
         backup->map_size_units_minus_2 = gMapSizeMinus2;
         backup->map_size = gMapSize;
@@ -2116,9 +2131,7 @@ static std::unique_ptr<map_backup> track_design_preview_backup_map()
  */
 static void track_design_preview_restore_map(map_backup* backup)
 {
-    std::memcpy(gTileElements, backup->tile_elements, sizeof(backup->tile_elements));
-    std::memcpy(gTileElementTilePointers, backup->tile_pointers, sizeof(backup->tile_pointers));
-    gNextFreeTileElement = backup->next_free_tile_element;
+    map_load_tile_elements(backup->tile_elements);
     gMapSizeUnits = backup->map_size_units;
     gMapSizeMinus2 = backup->map_size_units_minus_2;
     gMapSize = backup->map_size;
@@ -2137,20 +2150,20 @@ static void track_design_preview_clear_map()
     gMapSizeMinus2 = (264 * 32) - 2;
     gMapSize = 256;
 
-    for (int32_t i = 0; i < MAX_TILE_TILE_ELEMENT_POINTERS; i++)
+    std::vector<TileElement> tileElements(MAX_TILE_TILE_ELEMENT_POINTERS);
+    for (auto& tileElement : tileElements)
     {
-        TileElement* tile_element = &gTileElements[i];
-        tile_element->ClearAs(TILE_ELEMENT_TYPE_SURFACE);
-        tile_element->SetLastForTile(true);
-        tile_element->AsSurface()->SetSlope(TILE_ELEMENT_SLOPE_FLAT);
-        tile_element->AsSurface()->SetWaterHeight(0);
-        tile_element->AsSurface()->SetSurfaceStyle(TERRAIN_GRASS);
-        tile_element->AsSurface()->SetEdgeStyle(TERRAIN_EDGE_ROCK);
-        tile_element->AsSurface()->SetGrassLength(GRASS_LENGTH_CLEAR_0);
-        tile_element->AsSurface()->SetOwnership(OWNERSHIP_OWNED);
-        tile_element->AsSurface()->SetParkFences(0);
+        tileElement.ClearAs(TILE_ELEMENT_TYPE_SURFACE);
+        tileElement.SetLastForTile(true);
+        tileElement.AsSurface()->SetSlope(TILE_ELEMENT_SLOPE_FLAT);
+        tileElement.AsSurface()->SetWaterHeight(0);
+        tileElement.AsSurface()->SetSurfaceStyle(TERRAIN_GRASS);
+        tileElement.AsSurface()->SetEdgeStyle(TERRAIN_EDGE_ROCK);
+        tileElement.AsSurface()->SetGrassLength(GRASS_LENGTH_CLEAR_0);
+        tileElement.AsSurface()->SetOwnership(OWNERSHIP_OWNED);
+        tileElement.AsSurface()->SetParkFences(0);
     }
-    map_update_tile_pointers();
+    map_load_tile_elements(tileElements);
 }
 
 bool track_design_are_entrance_and_exit_placed()
@@ -202,6 +202,7 @@ extern bool gTrackDesignSaveMode;
 extern ride_id_t gTrackDesignSaveRideIndex;
 
 std::unique_ptr<TrackDesign> track_design_open(const utf8* path);
+std::unique_ptr<TrackDesign> track_design_open(const utf8* path, OpenRCT2::IStream* stream);
 
 void track_design_mirror(TrackDesign* td6);
 
@@ -28,7 +28,9 @@
 
 #include <algorithm>
 #include <memory>
+#include <optional>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 using namespace OpenRCT2;
@@ -64,6 +66,10 @@ private:
     static constexpr uint16_t VERSION = 3;
     static constexpr auto PATTERN = "*.td4;*.td6";
 
+    // Copy of the ride objects in the object repository by name, so that the index can be built while the object
+    // repository changes
+    std::unordered_map<std::string, ObjectRepositoryItem> _rideObjects;
+
 public:
     explicit TrackDesignFileIndex(const IPlatformEnvironment& env)
         : FileIndex(
@@ -77,16 +83,38 @@ public:
     }
 
 public:
-    std::tuple<bool, TrackRepositoryItem> Create(int32_t, const std::string& path) const override
+    void SetRideObjects(std::unordered_map<std::string, ObjectRepositoryItem>&& rideObjects)
+    {
+        _rideObjects = std::move(rideObjects);
+    }
+
+    std::tuple<bool, TrackRepositoryItem> Create(int32_t language, const std::string& path) const override
+    {
+        try
+        {
+            auto fs = FileStream(path, FILE_MODE_OPEN);
+            return Create(language, path, &fs);
+        }
+        catch (const std::exception& e)
+        {
+            log_error("Unable to load track design: %s", e.what());
+            return std::make_tuple(true, TrackRepositoryItem());
+        }
+    }
+
+    std::tuple<bool, TrackRepositoryItem> Create(int32_t, const std::string& path, IStream* stream) const override
     {
-        auto td6 = track_design_open(path.c_str());
+        auto td6 = track_design_open(path.c_str(), stream);
         if (td6 != nullptr)
         {
             ObjectEntryIndex rideType = td6->type;
-            if (RCT2RideTypeNeedsConversion(td6->type))
+            auto rideObject = _rideObjects.find(std::string(td6->vehicle_object.name, 8));
+            if (RCT2RideTypeNeedsConversion(td6->type) && rideObject != _rideObjects.end())
             {
+                // Reading the object fills in the flags and vehicles the conversion needs. The object is never loaded, as
+                // that allocates its strings and images, which is only allowed on the main thread.
                 std::scoped_lock<std::mutex> lock(_objectLookupMutex);
-                auto* rawObject = object_repository_load_object(&td6->vehicle_object);
+                auto* rawObject = GetContext()->GetObjectRepository().LoadObject(&rideObject->second);
                 if (rawObject != nullptr)
                 {
                     const auto* rideEntry = static_cast<const rct_ride_entry*>(
@@ -95,7 +123,7 @@ public:
                     {
                         rideType = RCT2RideTypeToOpenRCT2RideType(td6->type, rideEntry);
                     }
-                    object_delete(rawObject);
+                    delete rawObject;
                 }
             }
 
@@ -149,8 +177,9 @@ class TrackDesignRepository final : public ITrackDesignRepository
 {
 private:
     std::shared_ptr<IPlatformEnvironment> const _env;
-    TrackDesignFileIndex const _fileIndex;
+    TrackDesignFileIndex _fileIndex;
     std::vector<TrackRepositoryItem> _items;
+    std::optional<std::vector<TrackRepositoryItem>> _indexUpdate;
 
 public:
     explicit TrackDesignRepository(const std::shared_ptr<IPlatformEnvironment>& env)
@@ -239,14 +268,40 @@ public:
 
     void Scan(int32_t language) override
     {
-        _items.clear();
-        auto trackDesigns = _fileIndex.LoadOrBuild(language);
-        for (const auto& td : trackDesigns)
+        PrepareIndexUpdate();
+        UpdateIndex(language);
+        ApplyIndexUpdate();
+    }
+
+    void PrepareIndexUpdate() override
+    {
+        const auto& objectRepository = GetContext()->GetObjectRepository();
+        auto objects = objectRepository.GetObjects();
+        std::unordered_map<std::string, ObjectRepositoryItem> rideObjects;
+        for (size_t i = 0; i < objectRepository.GetNumObjects(); i++)
         {
-            _items.push_back(td);
+            const auto& object = objects[i];
+            if (object.ObjectEntry.GetType() == OBJECT_TYPE_RIDE)
+            {
+                rideObjects.emplace(std::string(object.ObjectEntry.name, 8), object);
+            }
         }
+        _fileIndex.SetRideObjects(std::move(rideObjects));
+    }
 
-        SortItems();
+    void UpdateIndex(int32_t language) override
+    {
+        _indexUpdate = _fileIndex.LoadOrBuild(language);
+    }
+
+    void ApplyIndexUpdate() override
+    {
+        if (_indexUpdate)
+        {
+            _items = std::move(*_indexUpdate);
+            _indexUpdate.reset();
+            SortItems();
+        }
     }
 
     bool Delete(const std::string& path) override
@@ -37,6 +37,16 @@ struct ITrackDesignRepository
         uint8_t rideType, const std::string& entry) const abstract;
 
     virtual void Scan(int32_t language) abstract;
+    /**
+     * Copies the ride objects that the ride types of older track designs are resolved against. Must be called on the
+     * main thread before UpdateIndex, once any update of the object index has been applied.
+     */
+    virtual void PrepareIndexUpdate() abstract;
+    /**
+     * Updates the track design index without changing the track list, see IObjectRepository::UpdateIndex.
+     */
+    virtual void UpdateIndex(int32_t language) abstract;
+    virtual void ApplyIndexUpdate() abstract;
     virtual bool Delete(const std::string& path) abstract;
     virtual std::string Rename(const std::string& path, const std::string& newName) abstract;
     virtual std::string Install(const std::string& path) abstract;
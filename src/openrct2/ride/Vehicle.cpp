@@ -17,6 +17,7 @@
 #include "../audio/AudioMixer.h"
 #include "../audio/audio.h"
 #include "../config/Config.h"
+#include "../core/JobPool.hpp"
 #include "../core/Memory.hpp"
 #include "../interface/Viewport.h"
 #include "../localisation/Localisation.h"
@@ -37,6 +38,7 @@
 #include "CableLift.h"
 #include "Ride.h"
 #include "RideData.h"
+#include "RideRatings.h"
 #include "Station.h"
 #include "Track.h"
 #include "TrackData.h"
@@ -44,7 +46,13 @@
 #include "VehicleSubpositionData.h"
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 static bool vehicle_boat_is_location_accessible(const CoordsXYZ& location);
 
@@ -55,17 +63,65 @@ constexpr int16_t VEHICLE_MAX_SPIN_SPEED_WATER_RIDE = 512;
 constexpr int16_t VEHICLE_MIN_SPIN_SPEED_WATER_RIDE = -VEHICLE_MAX_SPIN_SPEED_WATER_RIDE;
 constexpr int16_t VEHICLE_STOPPING_SPIN_SPEED = 600;
 
-Vehicle* gCurrentVehicle;
+// The state of the vehicle update in progress on each thread, see vehicle_update_all
+thread_local Vehicle* gCurrentVehicle;
+
+static thread_local uint8_t _vehicleBreakdown;
+thread_local StationIndex _vehicleStationIndex;
+thread_local uint32_t _vehicleMotionTrackFlags;
+thread_local int32_t _vehicleVelocityF64E08;
+thread_local int32_t _vehicleVelocityF64E0C;
+thread_local int32_t _vehicleUnkF64E10;
+thread_local uint8_t _vehicleF64E2C;
+thread_local Vehicle* _vehicleFrontVehicle;
+thread_local CoordsXYZ unk_F64E20;
+
+// Effects on state shared with other rides queued by the track motion running on this thread, see vehicle_update_all
+static thread_local std::vector<std::function<void()>>* _vehicleDeferredEffects;
+// Block brake states queued by the track motion running on this thread, in the order they were set, so that later
+// trains of the same ride see them before they are applied
+static thread_local std::vector<std::pair<TrackElement*, bool>>* _vehicleDeferredBlockBrakes;
 
-static uint8_t _vehicleBreakdown;
-StationIndex _vehicleStationIndex;
-uint32_t _vehicleMotionTrackFlags;
-int32_t _vehicleVelocityF64E08;
-int32_t _vehicleVelocityF64E0C;
-int32_t _vehicleUnkF64E10;
-uint8_t _vehicleF64E2C;
-Vehicle* _vehicleFrontVehicle;
-CoordsXYZ unk_F64E20;
+/**
+ * Runs an effect of a vehicle update on state shared with other rides, or queues it when the vehicle's track motion
+ * is running in parallel with other rides.
+ */
+template<typename TFn> static void vehicle_shared_effect(TFn&& effect)
+{
+    if (_vehicleDeferredEffects != nullptr)
+    {
+        _vehicleDeferredEffects->emplace_back(std::forward<TFn>(effect));
+    }
+    else
+    {
+        effect();
+    }
+}
+
+static bool vehicle_is_block_brake_closed(const TrackElement* trackElement)
+{
+    if (_vehicleDeferredBlockBrakes != nullptr)
+    {
+        auto& blockBrakes = *_vehicleDeferredBlockBrakes;
+        auto it = std::find_if(blockBrakes.rbegin(), blockBrakes.rend(), [trackElement](const auto& blockBrake) {
+            return blockBrake.first == trackElement;
+        });
+        if (it != blockBrakes.rend())
+        {
+            return it->second;
+        }
+    }
+    return trackElement->BlockBrakeClosed();
+}
+
+static void vehicle_set_block_brake_closed(TrackElement* trackElement, bool isClosed)
+{
+    if (_vehicleDeferredBlockBrakes != nullptr)
+    {
+        _vehicleDeferredBlockBrakes->emplace_back(trackElement, isClosed);
+    }
+    vehicle_shared_effect([trackElement, isClosed]() { trackElement->SetBlockBrakeClosed(isClosed); });
+}
 
 // clang-format off
 static constexpr const SoundId byte_9A3A14[] = { SoundId::Scream8, SoundId::Scream1 };
@@ -728,81 +784,25 @@ template<> bool SpriteBase::Is<Vehicle>() const
     return sprite_identifier == SPRITE_IDENTIFIER_VEHICLE;
 }
 
-static bool vehicle_move_info_valid(VehicleTrackSubposition trackSubposition, int32_t typeAndDirection, int32_t offset)
-{
-    if (trackSubposition >= VehicleTrackSubposition{ std::size(gTrackVehicleInfo) })
-    {
-        return false;
-    }
-    int32_t size = 0;
-    switch (trackSubposition)
-    {
-        case VehicleTrackSubposition::Default:
-            size = 1024;
-            break;
-        case VehicleTrackSubposition::ChairliftGoingOut:
-            size = 692;
-            break;
-        case VehicleTrackSubposition::ChairliftGoingBack:
-        case VehicleTrackSubposition::ChairliftEndBullwheel:
-        case VehicleTrackSubposition::ChairliftStartBullwheel:
-            size = 404;
-            break;
-        case VehicleTrackSubposition::GoKartsLeftLane:
-        case VehicleTrackSubposition::GoKartsRightLane:
-        case VehicleTrackSubposition::GoKartsMovingToRightLane:
-        case VehicleTrackSubposition::GoKartsMovingToLeftLane:
-            size = 208;
-            break;
-        case VehicleTrackSubposition::MiniGolfPathA9: // VehicleTrackSubposition::MiniGolfStart9
-        case VehicleTrackSubposition::MiniGolfBallPathA10:
-        case VehicleTrackSubposition::MiniGolfPathB11:
-        case VehicleTrackSubposition::MiniGolfBallPathB12:
-        case VehicleTrackSubposition::MiniGolfPathC13:
-        case VehicleTrackSubposition::MiniGolfBallPathC14:
-            size = 824;
-            break;
-        case VehicleTrackSubposition::ReverserRCFrontBogie:
-        case VehicleTrackSubposition::ReverserRCRearBogie:
-            size = 868;
-            break;
-        default:
-            break;
-    }
-    if (typeAndDirection >= size)
-    {
-        return false;
-    }
-    if (offset >= gTrackVehicleInfo[static_cast<uint8_t>(trackSubposition)][typeAndDirection]->size)
-    {
-        return false;
-    }
-    return true;
-}
-
-static const rct_vehicle_info* vehicle_get_move_info(
+static rct_vehicle_info vehicle_get_move_info(
     VehicleTrackSubposition trackSubposition, int32_t typeAndDirection, int32_t offset)
 {
-    if (!vehicle_move_info_valid(trackSubposition, typeAndDirection, offset))
+    auto list = vehicle_get_packed_move_info(trackSubposition, typeAndDirection);
+    if (offset < 0 || offset >= list.size)
     {
-        static constexpr const rct_vehicle_info zero = {};
-        return &zero;
+        return {};
     }
-    return &gTrackVehicleInfo[static_cast<uint8_t>(trackSubposition)][typeAndDirection]->info[offset];
+    return list.info[offset].Unpack();
 }
 
-const rct_vehicle_info* Vehicle::GetMoveInfo() const
+rct_vehicle_info Vehicle::GetMoveInfo() const
 {
     return vehicle_get_move_info(TrackSubposition, track_type, track_progress);
 }
 
 static uint16_t vehicle_get_move_info_size(VehicleTrackSubposition trackSubposition, int32_t typeAndDirection)
 {
-    if (!vehicle_move_info_valid(trackSubposition, typeAndDirection, 0))
-    {
-        return 0;
-    }
-    return gTrackVehicleInfo[static_cast<uint8_t>(trackSubposition)][typeAndDirection]->size;
+    return vehicle_get_packed_move_info(trackSubposition, typeAndDirection).size;
 }
 
 uint16_t Vehicle::GetTrackProgress() const
@@ -1347,9 +1347,60 @@ void vehicle_sounds_update()
     }
 }
 
+namespace
+{
+    struct ParallelTrain
+    {
+        Vehicle* Head;
+        uint8_t Breakdown;
+        std::optional<int32_t> TrackMotionFlags;
+        StationIndex Station;
+        std::vector<std::function<void()>> Effects;
+    };
+
+    // The trains of one ride whose track motion is run as one job
+    struct ParallelRide
+    {
+        std::vector<size_t> Trains;
+        std::vector<std::pair<TrackElement*, bool>> BlockBrakes;
+        SpriteDeferredChanges SpriteChanges;
+    };
+} // namespace
+
+static std::unique_ptr<JobPool> _vehicleUpdateJobs;
+
+static void vehicle_update_track_motion_of_ride(ParallelRide& ride, std::vector<ParallelTrain>& trains)
+{
+    _vehicleDeferredBlockBrakes = &ride.BlockBrakes;
+    sprite_defer_changes(&ride.SpriteChanges);
+    for (auto trainIndex : ride.Trains)
+    {
+        auto& train = trains[trainIndex];
+
+        // An earlier train may have crashed into this one
+        if (train.Head->status == Vehicle::Status::Travelling)
+        {
+            _vehicleDeferredEffects = &train.Effects;
+            _vehicleBreakdown = train.Breakdown;
+            train.TrackMotionFlags = train.Head->UpdateTrackMotion(nullptr);
+            train.Station = _vehicleStationIndex;
+        }
+    }
+    sprite_defer_changes(nullptr);
+    _vehicleDeferredEffects = nullptr;
+    _vehicleDeferredBlockBrakes = nullptr;
+}
+
 /**
  *
  *  rct2: 0x006D4204
+ *
+ * Trains travelling on track spend most of their update stepping their cars along it, which only touches their own
+ * ride. Those trains are updated in three steps: the part of the update before the track motion is run in train order
+ * along with the updates of all other trains, then the track motion of each ride is run as a job, then the rest of
+ * each update is run in train order. The jobs queue their effects on state shared with other rides, such as block
+ * brakes and level crossings, which are applied between the last two steps in train order, so the result does not
+ * depend on how the jobs were scheduled.
  */
 void vehicle_update_all()
 {
@@ -1359,10 +1410,122 @@ void vehicle_update_all()
     if ((gScreenFlags & SCREEN_FLAGS_TRACK_DESIGNER) && gS6Info.editor_step != EDITOR_STEP_ROLLERCOASTER_DESIGNER)
         return;
 
+    std::vector<ParallelTrain> trains;
+    std::vector<ParallelRide> rides;
+    std::unordered_map<ride_id_t, size_t> rideIndices;
     for (auto vehicle : EntityList<Vehicle>(EntityListId::TrainHead))
     {
-        vehicle->Update();
+        if (!vehicle->CanUpdateTrackMotionInParallel())
+        {
+            vehicle->Update();
+            continue;
+        }
+
+        if (vehicle->BeginTravellingUpdate())
+        {
+            auto it = rideIndices.emplace(vehicle->ride, rides.size()).first;
+            if (it->second == rides.size())
+            {
+                rides.emplace_back();
+            }
+            rides[it->second].Trains.push_back(trains.size());
+            trains.push_back({ vehicle, _vehicleBreakdown, std::nullopt, STATION_INDEX_NULL, {} });
+        }
+    }
+
+    if (rides.size() > 1)
+    {
+        if (_vehicleUpdateJobs == nullptr)
+        {
+            _vehicleUpdateJobs = std::make_unique<JobPool>();
+        }
+        for (auto& ride : rides)
+        {
+            _vehicleUpdateJobs->AddTask([&ride, &trains]() {
+                map_bypass_track_element_index(true);
+                vehicle_update_track_motion_of_ride(ride, trains);
+                map_bypass_track_element_index(false);
+            });
+        }
+        _vehicleUpdateJobs->Join();
+    }
+    else
+    {
+        for (auto& ride : rides)
+        {
+            vehicle_update_track_motion_of_ride(ride, trains);
+        }
+    }
+
+    for (auto& ride : rides)
+    {
+        sprite_apply_deferred_changes(ride.SpriteChanges);
+    }
+    for (auto& train : trains)
+    {
+        for (auto& effect : train.Effects)
+        {
+            effect();
+        }
+    }
+
+    for (auto& train : trains)
+    {
+        _vehicleBreakdown = train.Breakdown;
+        _vehicleStationIndex = train.Station;
+        train.Head->EndTravellingUpdate(train.TrackMotionFlags);
+    }
+}
+
+/**
+ * Whether the track motion of the train can run in parallel with the trains of other rides. It must be travelling on
+ * the track. Mini golf and go karts draw random numbers while moving, and go karts and boat hire look for the vehicles
+ * of other rides to avoid.
+ */
+bool Vehicle::CanUpdateTrackMotionInParallel() const
+{
+    if (status != Vehicle::Status::Travelling || ride_subtype == RIDE_ENTRY_INDEX_NULL)
+        return false;
+
+    constexpr uint32_t sharedStateFlags = VEHICLE_ENTRY_FLAG_MINI_GOLF | VEHICLE_ENTRY_FLAG_GO_KART
+        | VEHICLE_ENTRY_FLAG_BOAT_HIRE_COLLISION_DETECTION;
+    for (const Vehicle* car = this; car != nullptr; car = GetEntity<Vehicle>(car->next_vehicle_on_train))
+    {
+        auto vehicleEntry = car->Entry();
+        if (vehicleEntry == nullptr || (vehicleEntry->flags & sharedStateFlags))
+            return false;
     }
+    return true;
+}
+
+/**
+ * Runs the part of Update for a travelling train that comes before its track motion.
+ * @returns true if UpdateTrackMotion and EndTravellingUpdate are to be called to finish the update.
+ */
+bool Vehicle::BeginTravellingUpdate()
+{
+    if (!UpdateBreakdownAndMeasurements())
+        return false;
+
+    if (!UpdateTravellingBeforeTrackMotion())
+    {
+        UpdateSound();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Runs the part of Update for a travelling train that comes after its track motion, given the flags returned by
+ * UpdateTrackMotion. Without flags, the train has stopped travelling since BeginTravellingUpdate and did not move.
+ */
+void Vehicle::EndTravellingUpdate(std::optional<int32_t> trackMotionFlags)
+{
+    if (trackMotionFlags.has_value())
+    {
+        UpdateTravellingAfterTrackMotion(*trackMotionFlags);
+    }
+    UpdateSound();
 }
 
 /**
@@ -1953,31 +2116,9 @@ void Vehicle::Update()
         return;
     }
 
-    auto rideEntry = GetRideEntry();
-    if (rideEntry == nullptr)
-        return;
-
-    auto curRide = GetRide();
-    if (curRide == nullptr)
+    if (!UpdateBreakdownAndMeasurements())
         return;
 
-    if (HasUpdateFlag(VEHICLE_UPDATE_FLAG_TESTING))
-        UpdateMeasurements();
-
-    _vehicleBreakdown = 255;
-    if (curRide->lifecycle_flags & (RIDE_LIFECYCLE_BREAKDOWN_PENDING | RIDE_LIFECYCLE_BROKEN_DOWN))
-    {
-        _vehicleBreakdown = curRide->breakdown_reason_pending;
-        auto vehicleEntry = &rideEntry->vehicles[vehicle_type];
-        if ((vehicleEntry->flags & VEHICLE_ENTRY_FLAG_POWERED) && curRide->breakdown_reason_pending == BREAKDOWN_SAFETY_CUT_OUT)
-        {
-            if (!(vehicleEntry->flags & VEHICLE_ENTRY_FLAG_WATER_RIDE) || (vehicle_sprite_type == 2 && velocity <= 0x20000))
-            {
-                SetUpdateFlag(VEHICLE_UPDATE_FLAG_ZERO_VELOCITY);
-            }
-        }
-    }
-
     switch (status)
     {
         case Vehicle::Status::MovingToEndOfStation:
@@ -2053,6 +2194,40 @@ void Vehicle::Update()
     UpdateSound();
 }
 
+/**
+ * Updates the measurements of a ride being tested and the breakdown state used by the rest of the update.
+ * @returns false if the ride or ride entry of the vehicle is missing and it should not be updated.
+ */
+bool Vehicle::UpdateBreakdownAndMeasurements()
+{
+    auto rideEntry = GetRideEntry();
+    if (rideEntry == nullptr)
+        return false;
+
+    auto curRide = GetRide();
+    if (curRide == nullptr)
+        return false;
+
+    if (HasUpdateFlag(VEHICLE_UPDATE_FLAG_TESTING))
+        UpdateMeasurements();
+
+    _vehicleBreakdown = 255;
+    if (curRide->lifecycle_flags & (RIDE_LIFECYCLE_BREAKDOWN_PENDING | RIDE_LIFECYCLE_BROKEN_DOWN))
+    {
+        _vehicleBreakdown = curRide->breakdown_reason_pending;
+        auto vehicleEntry = &rideEntry->vehicles[vehicle_type];
+        if ((vehicleEntry->flags & VEHICLE_ENTRY_FLAG_POWERED) && curRide->breakdown_reason_pending == BREAKDOWN_SAFETY_CUT_OUT)
+        {
+            if (!(vehicleEntry->flags & VEHICLE_ENTRY_FLAG_WATER_RIDE) || (vehicle_sprite_type == 2 && velocity <= 0x20000))
+            {
+                SetUpdateFlag(VEHICLE_UPDATE_FLAG_ZERO_VELOCITY);
+            }
+        }
+    }
+
+    return true;
+}
+
 /**
  *
  *  rct2: 0x006D7BCC
@@ -3032,6 +3207,9 @@ static void test_finish(Ride& ride)
     totalTime = std::max(totalTime, 1u);
     ride.average_speed = ride.average_speed / totalTime;
     window_invalidate_by_number(WC_RIDE, ride.id);
+
+    // Rate the ride now rather than when the ratings round robin gets to it
+    ride_ratings_request(ride.id);
 }
 
 void Vehicle::UpdateTestFinish()
@@ -3671,12 +3849,23 @@ void Vehicle::UpdateCrashSetup()
  *  rct2: 0x006D8937
  */
 void Vehicle::UpdateTravelling()
+{
+    if (UpdateTravellingBeforeTrackMotion())
+    {
+        UpdateTravellingAfterTrackMotion(UpdateTrackMotion(nullptr));
+    }
+}
+
+/**
+ * @returns false if the vehicle does not move along the track this tick.
+ */
+bool Vehicle::UpdateTravellingBeforeTrackMotion()
 {
     CheckIfMissing();
 
     auto curRide = GetRide();
     if (curRide == nullptr || (_vehicleBreakdown == 0 && curRide->mode == RIDE_MODE_ROTATING_LIFT))
-        return;
+        return false;
 
     if (sub_state == 2)
     {
@@ -3693,10 +3882,16 @@ void Vehicle::UpdateTravelling()
         velocity = 0;
         acceleration = 0;
         Invalidate();
-        return;
+        return false;
     }
+    return true;
+}
 
-    uint32_t curFlags = UpdateTrackMotion(nullptr);
+void Vehicle::UpdateTravellingAfterTrackMotion(uint32_t curFlags)
+{
+    auto curRide = GetRide();
+    if (curRide == nullptr)
+        return;
 
     bool skipCheck = false;
     if (curFlags & (VEHICLE_UPDATE_MOTION_TRACK_FLAG_8 | VEHICLE_UPDATE_MOTION_TRACK_FLAG_9)
@@ -6651,14 +6846,14 @@ void Vehicle::CheckAndApplyBlockSectionStopSite()
     switch (trackType)
     {
         case TRACK_ELEM_BLOCK_BRAKES:
-            if (curRide->IsBlockSectioned() && trackElement->AsTrack()->BlockBrakeClosed())
+            if (curRide->IsBlockSectioned() && vehicle_is_block_brake_closed(trackElement->AsTrack()))
                 ApplyStopBlockBrake();
             else
                 ApplyNonStopBlockBrake();
 
             break;
         case TRACK_ELEM_END_STATION:
-            if (trackElement->AsTrack()->BlockBrakeClosed())
+            if (vehicle_is_block_brake_closed(trackElement->AsTrack()))
                 _vehicleMotionTrackFlags |= VEHICLE_UPDATE_MOTION_TRACK_FLAG_10;
 
             break;
@@ -6671,7 +6866,7 @@ void Vehicle::CheckAndApplyBlockSectionStopSite()
             {
                 if (trackType == TRACK_ELEM_CABLE_LIFT_HILL || trackElement->AsTrack()->HasChain())
                 {
-                    if (trackElement->AsTrack()->BlockBrakeClosed())
+                    if (vehicle_is_block_brake_closed(trackElement->AsTrack()))
                     {
                         ApplyStopBlockBrake();
                     }
@@ -6759,15 +6954,16 @@ static void block_brakes_open_previous_section(Ride& ride, const CoordsXYZ& vehi
     {
         return;
     }
-    trackElement->SetBlockBrakeClosed(false);
-    map_invalidate_element(location, reinterpret_cast<TileElement*>(trackElement));
+    vehicle_set_block_brake_closed(trackElement, false);
+    vehicle_shared_effect(
+        [location, trackElement]() { map_invalidate_element(location, reinterpret_cast<TileElement*>(trackElement)); });
 
     int32_t trackType = trackElement->GetTrackType();
     if (trackType == TRACK_ELEM_BLOCK_BRAKES || trackType == TRACK_ELEM_END_STATION)
     {
         if (ride.IsBlockSectioned())
         {
-            audio_play_sound_at_location(SoundId::BlockBrakeClose, location);
+            vehicle_shared_effect([location]() { audio_play_sound_at_location(SoundId::BlockBrakeClose, location); });
         }
     }
 }
@@ -7195,6 +7391,12 @@ void Vehicle::UpdateSpinningCar()
  */
 static void steam_particle_create(const CoordsXYZ& coords)
 {
+    if (_vehicleDeferredEffects != nullptr)
+    {
+        _vehicleDeferredEffects->emplace_back([coords]() { steam_particle_create(coords); });
+        return;
+    }
+
     auto surfaceElement = map_get_surface_element_at(coords);
     if (surfaceElement != nullptr && coords.z > surfaceElement->GetBaseZ())
     {
@@ -7407,6 +7609,15 @@ static void play_scenery_door_close_sound(const CoordsXYZ& loc, WallElement* til
 template<bool isBackwards>
 static void AnimateSceneryDoor(const CoordsXYZD& doorLocation, const CoordsXYZ& trackLocation, bool isLastVehicle)
 {
+    // The door may be on the edge of a tile used by another ride
+    if (_vehicleDeferredEffects != nullptr)
+    {
+        _vehicleDeferredEffects->emplace_back([doorLocation, trackLocation, isLastVehicle]() {
+            AnimateSceneryDoor<isBackwards>(doorLocation, trackLocation, isLastVehicle);
+        });
+        return;
+    }
+
     auto door = map_get_wall_element_at(doorLocation);
     if (door == nullptr)
     {
@@ -7485,7 +7696,9 @@ static void trigger_on_ride_photo(const CoordsXYZ& loc, TileElement* tileElement
 {
     tileElement->AsTrack()->SetPhotoTimeout();
 
-    map_animation_create(MAP_ANIMATION_TYPE_TRACK_ONRIDEPHOTO, { loc, tileElement->GetBaseZ() });
+    CoordsXYZ animationLoc = { loc, tileElement->GetBaseZ() };
+    vehicle_shared_effect(
+        [animationLoc]() { map_animation_create(MAP_ANIMATION_TYPE_TRACK_ONRIDEPHOTO, animationLoc); });
 }
 
 /**
@@ -7512,7 +7725,8 @@ static void vehicle_update_play_water_splash_sound()
         return;
     }
 
-    audio_play_sound_at_location(SoundId::WaterSplash, { unk_F64E20.x, unk_F64E20.y, unk_F64E20.z });
+    CoordsXYZ loc = unk_F64E20;
+    vehicle_shared_effect([loc]() { audio_play_sound_at_location(SoundId::WaterSplash, loc); });
 }
 
 /**
@@ -7579,7 +7793,7 @@ void Vehicle::UpdateHandleWaterSplash() const
 void Vehicle::UpdateReverserCarBogies()
 {
     const auto moveInfo = GetMoveInfo();
-    MoveTo({ TrackLocation.x + moveInfo->x, TrackLocation.y + moveInfo->y, z });
+    MoveTo({ TrackLocation.x + moveInfo.x, TrackLocation.y + moveInfo.y, z });
 }
 
 /**
@@ -7921,15 +8135,17 @@ bool Vehicle::UpdateTrackMotionForwardsGetNewTrack(uint16_t trackType, Ride* cur
     {
         if (next_vehicle_on_train == SPRITE_INDEX_NULL)
         {
-            tileElement->AsTrack()->SetBlockBrakeClosed(true);
+            vehicle_set_block_brake_closed(tileElement->AsTrack(), true);
             if (trackType == TRACK_ELEM_BLOCK_BRAKES || trackType == TRACK_ELEM_END_STATION)
             {
                 if (!(rideEntry->vehicles[0].flags & VEHICLE_ENTRY_FLAG_POWERED))
                 {
-                    audio_play_sound_at_location(SoundId::BlockBrakeRelease, TrackLocation);
+                    CoordsXYZ loc = TrackLocation;
+                    vehicle_shared_effect([loc]() { audio_play_sound_at_location(SoundId::BlockBrakeRelease, loc); });
                 }
             }
-            map_invalidate_element(TrackLocation, tileElement);
+            CoordsXY elementLoc = TrackLocation;
+            vehicle_shared_effect([elementLoc, tileElement]() { map_invalidate_element(elementLoc, tileElement); });
             block_brakes_open_previous_section(*curRide, TrackLocation, tileElement);
         }
     }
@@ -8125,7 +8341,8 @@ loc_6DAEB9:
                 if (_vehicleF64E2C == 0)
                 {
                     _vehicleF64E2C++;
-                    audio_play_sound_at_location(SoundId::BrakeRelease, { x, y, z });
+                    CoordsXYZ loc = { x, y, z };
+                    vehicle_shared_effect([loc]() { audio_play_sound_at_location(SoundId::BrakeRelease, loc); });
                 }
             }
         }
@@ -8206,7 +8423,7 @@ loc_6DAEB9:
     trackType = GetTrackType();
     {
         auto loc = TrackLocation
-            + CoordsXYZ{ moveInfo->x, moveInfo->y, moveInfo->z + RideTypeDescriptors[curRide->type].Heights.VehicleZOffset };
+            + CoordsXYZ{ moveInfo.x, moveInfo.y, moveInfo.z + RideTypeDescriptors[curRide->type].Heights.VehicleZOffset };
 
         regs.ebx = 0;
         if (loc.x != unk_F64E20.x)
@@ -8234,22 +8451,22 @@ loc_6DAEB9:
         {
             ReverseReverserCar();
 
-            const rct_vehicle_info* moveInfo2 = GetMoveInfo();
-            loc.x = x + moveInfo2->x;
-            loc.y = y + moveInfo2->y;
+            const auto moveInfo2 = GetMoveInfo();
+            loc.x = x + moveInfo2.x;
+            loc.y = y + moveInfo2.y;
         }
 
         // loc_6DB8A5
         regs.ebx = dword_9A2930[regs.ebx];
         remaining_distance -= regs.ebx;
         unk_F64E20 = loc;
-        sprite_direction = moveInfo->direction;
-        bank_rotation = moveInfo->bank_rotation;
-        vehicle_sprite_type = moveInfo->vehicle_sprite_type;
+        sprite_direction = moveInfo.direction;
+        bank_rotation = moveInfo.bank_rotation;
+        vehicle_sprite_type = moveInfo.vehicle_sprite_type;
 
-        regs.ebx = moveInfo->vehicle_sprite_type;
+        regs.ebx = moveInfo.vehicle_sprite_type;
 
-        if ((vehicleEntry->flags & VEHICLE_ENTRY_FLAG_25) && moveInfo->vehicle_sprite_type != 0)
+        if ((vehicleEntry->flags & VEHICLE_ENTRY_FLAG_25) && moveInfo.vehicle_sprite_type != 0)
         {
             SwingSprite = 0;
             SwingPosition = 0;
@@ -8538,9 +8755,9 @@ loc_6DBA33:;
     // loc_6DBD42
     track_progress = regs.ax;
     {
-        const rct_vehicle_info* moveInfo = GetMoveInfo();
+        const auto moveInfo = GetMoveInfo();
         auto loc = TrackLocation
-            + CoordsXYZ{ moveInfo->x, moveInfo->y, moveInfo->z + RideTypeDescriptors[curRide->type].Heights.VehicleZOffset };
+            + CoordsXYZ{ moveInfo.x, moveInfo.y, moveInfo.z + RideTypeDescriptors[curRide->type].Heights.VehicleZOffset };
 
         regs.ebx = 0;
         if (loc.x != unk_F64E20.x)
@@ -8558,9 +8775,9 @@ loc_6DBA33:;
         remaining_distance += dword_9A2930[regs.ebx];
 
         unk_F64E20 = loc;
-        sprite_direction = moveInfo->direction;
-        bank_rotation = moveInfo->bank_rotation;
-        regs.ebx = moveInfo->vehicle_sprite_type;
+        sprite_direction = moveInfo.direction;
+        bank_rotation = moveInfo.bank_rotation;
+        regs.ebx = moveInfo.vehicle_sprite_type;
         vehicle_sprite_type = regs.bl;
 
         if ((vehicleEntry->flags & VEHICLE_ENTRY_FLAG_25) && regs.bl != 0)
@@ -8819,15 +9036,15 @@ loc_6DC743:
             animation_frame = 0;
         }
     }
-    const rct_vehicle_info* moveInfo;
+    rct_vehicle_info moveInfo;
     for (;;)
     {
         moveInfo = GetMoveInfo();
-        if (moveInfo->x != LOCATION_NULL)
+        if (moveInfo.x != LOCATION_NULL)
         {
             break;
         }
-        switch (moveInfo->y)
+        switch (moveInfo.y)
         {
             case 0: // loc_6DC7B4
                 if (!IsHead())
@@ -8851,7 +9068,7 @@ loc_6DC743:
                 track_progress++;
                 break;
             case 1: // loc_6DC7ED
-                var_D3 = static_cast<uint8_t>(moveInfo->z);
+                var_D3 = static_cast<uint8_t>(moveInfo.z);
                 track_progress++;
                 break;
             case 2: // loc_6DC800
@@ -8863,7 +9080,7 @@ loc_6DC743:
                 track_progress++;
                 break;
             case 4: // loc_6DC820
-                trackPos.z = moveInfo->z;
+                trackPos.z = moveInfo.z;
                 // When the ride is closed occasionally the peep is removed
                 // but the vehicle is still on the track. This will prevent
                 // it from crashing in that situation.
@@ -8907,8 +9124,8 @@ loc_6DC743:
     }
 
     // loc_6DC8A1
-    trackPos = { TrackLocation.x + moveInfo->x, TrackLocation.y + moveInfo->y,
-                 TrackLocation.z + moveInfo->z + RideTypeDescriptors[curRide->type].Heights.VehicleZOffset };
+    trackPos = { TrackLocation.x + moveInfo.x, TrackLocation.y + moveInfo.y,
+                 TrackLocation.z + moveInfo.z + RideTypeDescriptors[curRide->type].Heights.VehicleZOffset };
 
     remaining_distance -= 0x368A;
     if (remaining_distance < 0)
@@ -8917,9 +9134,9 @@ loc_6DC743:
     }
 
     unk_F64E20 = trackPos;
-    sprite_direction = moveInfo->direction;
-    bank_rotation = moveInfo->bank_rotation;
-    vehicle_sprite_type = moveInfo->vehicle_sprite_type;
+    sprite_direction = moveInfo.direction;
+    bank_rotation = moveInfo.bank_rotation;
+    vehicle_sprite_type = moveInfo.vehicle_sprite_type;
 
     if (rideEntry->vehicles[0].flags & VEHICLE_ENTRY_FLAG_25)
     {
@@ -9022,8 +9239,8 @@ loc_6DCA9A:
 
 loc_6DCC2C:
     moveInfo = GetMoveInfo();
-    trackPos = { TrackLocation.x + moveInfo->x, TrackLocation.y + moveInfo->y,
-                 TrackLocation.z + moveInfo->z + RideTypeDescriptors[curRide->type].Heights.VehicleZOffset };
+    trackPos = { TrackLocation.x + moveInfo.x, TrackLocation.y + moveInfo.y,
+                 TrackLocation.z + moveInfo.z + RideTypeDescriptors[curRide->type].Heights.VehicleZOffset };
 
     remaining_distance -= 0x368A;
     if (remaining_distance < 0)
@@ -9032,9 +9249,9 @@ loc_6DCC2C:
     }
 
     unk_F64E20 = trackPos;
-    sprite_direction = moveInfo->direction;
-    bank_rotation = moveInfo->bank_rotation;
-    vehicle_sprite_type = moveInfo->vehicle_sprite_type;
+    sprite_direction = moveInfo.direction;
+    bank_rotation = moveInfo.bank_rotation;
+    vehicle_sprite_type = moveInfo.vehicle_sprite_type;
 
     if (rideEntry->vehicles[0].flags & VEHICLE_ENTRY_FLAG_25)
     {
@@ -9711,7 +9928,6 @@ void Vehicle::UpdateCrossings() const
     {
         int16_t autoReserveAhead = 4 + abs(velocity) / 150000;
         int16_t crossingBonus = 0;
-        bool playedClaxon = false;
 
         // vehicle positions mean we have to take larger
         //  margins for travelling backwards
@@ -9730,12 +9946,16 @@ void Vehicle::UpdateCrossings() const
             if (pathElement && curRide != nullptr
                 && RideTypeDescriptors[curRide->type].HasFlag(RIDE_TYPE_FLAG_SUPPORTS_LEVEL_CROSSINGS))
             {
-                if (!playedClaxon && !pathElement->IsBlockedByVehicle())
-                {
-                    Claxon();
-                }
+                // The path may be crossed by the track of other rides
+                const Vehicle* vehicle = this;
+                vehicle_shared_effect([vehicle, pathElement]() {
+                    if (!pathElement->IsBlockedByVehicle())
+                    {
+                        vehicle->Claxon();
+                    }
+                    pathElement->SetIsBlockedByVehicle(true);
+                });
                 crossingBonus = 4;
-                pathElement->SetIsBlockedByVehicle(true);
             }
             else
             {
@@ -9797,7 +10017,7 @@ void Vehicle::UpdateCrossings() const
             auto* pathElement = map_get_path_element_at(TileCoordsXYZ(CoordsXYZ{ xyElement, xyElement.element->GetBaseZ() }));
             if (pathElement)
             {
-                pathElement->SetIsBlockedByVehicle(false);
+                vehicle_shared_effect([pathElement]() { pathElement->SetIsBlockedByVehicle(false); });
             }
         }
     }
@@ -9806,13 +10026,14 @@ void Vehicle::UpdateCrossings() const
 void Vehicle::Claxon() const
 {
     rct_ride_entry* rideEntry = GetRideEntry();
+    CoordsXYZ loc = { x, y, z };
     switch (rideEntry->vehicles[vehicle_type].sound_range)
     {
         case SOUND_RANGE_WHISTLE:
-            audio_play_sound_at_location(SoundId::TrainWhistle, { x, y, z });
+            vehicle_shared_effect([loc]() { audio_play_sound_at_location(SoundId::TrainWhistle, loc); });
             break;
         case SOUND_RANGE_BELL:
-            audio_play_sound_at_location(SoundId::Tram, { x, y, z });
+            vehicle_shared_effect([loc]() { audio_play_sound_at_location(SoundId::Tram, loc); });
             break;
     }
 }
@@ -19,6 +19,7 @@
 
 #include <array>
 #include <cstddef>
+#include <optional>
 #include <vector>
 
 enum class SoundId : uint8_t;
@@ -317,6 +318,9 @@ struct Vehicle : SpriteBase
         return type == static_cast<uint8_t>(Vehicle::Type::Head);
     }
     void Update();
+    bool CanUpdateTrackMotionInParallel() const;
+    bool BeginTravellingUpdate();
+    void EndTravellingUpdate(std::optional<int32_t> trackMotionFlags);
     Vehicle* GetHead();
     const Vehicle* GetHead() const;
     Vehicle* GetCar(size_t carIndex) const;
@@ -357,7 +361,7 @@ struct Vehicle : SpriteBase
 private:
     bool SoundCanPlay() const;
     uint16_t GetSoundPriority() const;
-    const rct_vehicle_info* GetMoveInfo() const;
+    rct_vehicle_info GetMoveInfo() const;
     uint16_t GetTrackProgress() const;
     rct_vehicle_sound_params CreateSoundParam(uint16_t priority) const;
     void CableLiftUpdate();
@@ -369,6 +373,7 @@ private:
     void CableLiftUpdateTravelling();
     void CableLiftUpdateArriving();
     void Sub6DBF3E();
+    bool UpdateBreakdownAndMeasurements();
     void UpdateMeasurements();
     void UpdateMovingToEndOfStation();
     void UpdateWaitingForPassengers();
@@ -386,6 +391,8 @@ private:
     void UpdateDeparting();
     void FinishDeparting();
     void UpdateTravelling();
+    bool UpdateTravellingBeforeTrackMotion();
+    void UpdateTravellingAfterTrackMotion(uint32_t curFlags);
     void UpdateTravellingCableLift();
     void UpdateTravellingBoat();
     void UpdateMotionBoatHire();
@@ -625,14 +632,14 @@ Vehicle* try_get_vehicle(uint16_t spriteIndex);
 void vehicle_update_all();
 void vehicle_sounds_update();
 
-extern Vehicle* gCurrentVehicle;
-extern StationIndex _vehicleStationIndex;
-extern uint32_t _vehicleMotionTrackFlags;
-extern int32_t _vehicleVelocityF64E08;
-extern int32_t _vehicleVelocityF64E0C;
-extern int32_t _vehicleUnkF64E10;
-extern uint8_t _vehicleF64E2C;
-extern Vehicle* _vehicleFrontVehicle;
-extern CoordsXYZ unk_F64E20;
+extern thread_local Vehicle* gCurrentVehicle;
+extern thread_local StationIndex _vehicleStationIndex;
+extern thread_local uint32_t _vehicleMotionTrackFlags;
+extern thread_local int32_t _vehicleVelocityF64E08;
+extern thread_local int32_t _vehicleVelocityF64E0C;
+extern thread_local int32_t _vehicleUnkF64E10;
+extern thread_local uint8_t _vehicleF64E2C;
+extern thread_local Vehicle* _vehicleFrontVehicle;
+extern thread_local CoordsXYZ unk_F64E20;
 
 #endif
@@ -9,6 +9,12 @@
 
 #include "VehicleSubpositionData.h"
 
+#include "../core/Guard.hpp"
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
 #define CREATE_VEHICLE_INFO(VAR, ...)                                                                                          \
     static constexpr const rct_vehicle_info VAR##_data[] = __VA_ARGS__;                                                        \
     static constexpr const rct_vehicle_info_list VAR = { static_cast<uint16_t>(std::size(VAR##_data)), VAR##_data };
@@ -25745,3 +25751,108 @@ constexpr const rct_vehicle_info_list * const * gTrackVehicleInfo[static_cast<ui
 };
 
 // clang-format on
+
+// clang-format off
+static constexpr uint16_t TrackVehicleInfoListSizes[] = {
+    static_cast<uint16_t>(std::size(TrackVehicleInfoListDefault)),
+    static_cast<uint16_t>(std::size(TrackVehicleInfoListChairliftGoingOut)),
+    static_cast<uint16_t>(std::size(TrackVehicleInfoListChairliftGoingBack)),
+    static_cast<uint16_t>(std::size(TrackVehicleInfoListChairliftEndBullwheel)),
+    static_cast<uint16_t>(std::size(TrackVehicleInfoListChairliftStartBullwheel)),
+    static_cast<uint16_t>(std::size(TrackVehicleInfoListGoKartsLeftLane)),
+    static_cast<uint16_t>(std::size(TrackVehicleInfoListGoKartsRightLane)),
+    static_cast<uint16_t>(std::size(TrackVehicleInfoListGoKartsMovingToRightLane)),
+    static_cast<uint16_t>(std::size(TrackVehicleInfoListGoKartsMovingToLeftLane)),
+    static_cast<uint16_t>(std::size(TrackVehicleInfoListMiniGolfStartPathA9)),
+    static_cast<uint16_t>(std::size(TrackVehicleInfoListMiniGolfBallPathA10)),
+    static_cast<uint16_t>(std::size(TrackVehicleInfoListMiniGolfPathB11)),
+    static_cast<uint16_t>(std::size(TrackVehicleInfoListMiniGolfBallPathB12)),
+    static_cast<uint16_t>(std::size(TrackVehicleInfoListMiniGolfPathC13)),
+    static_cast<uint16_t>(std::size(TrackVehicleInfoListMiniGolfPathC14)),
+    static_cast<uint16_t>(std::size(TrackVehicleInfoListReverserRCFrontBogie)),
+    static_cast<uint16_t>(std::size(TrackVehicleInfoListReverserRCRearBogie)),
+};
+// clang-format on
+static_assert(std::size(TrackVehicleInfoListSizes) == std::size(gTrackVehicleInfo));
+
+/**
+ * All of gTrackVehicleInfo copied into one array of packed entries. Each track piece's entries are stored
+ * consecutively, so a car stepping along a piece reads sequential memory the hardware prefetcher can stay ahead of,
+ * instead of chasing a list pointer and then an info pointer into one of hundreds of separate arrays. Lists shared
+ * between subpositions or track pieces are only stored once.
+ */
+class PackedVehicleInfoTable
+{
+private:
+    struct ListSpan
+    {
+        uint32_t Offset;
+        uint16_t Size;
+    };
+
+    std::vector<rct_vehicle_info_packed> _entries;
+    // One span per track piece of every subposition, the subpositions stored back to back
+    std::vector<ListSpan> _spans;
+    std::array<uint32_t, std::size(gTrackVehicleInfo) + 1> _subpositionStart{};
+
+public:
+    PackedVehicleInfoTable()
+    {
+        std::unordered_map<const rct_vehicle_info_list*, uint32_t> listOffsets;
+        for (size_t subposition = 0; subposition < std::size(gTrackVehicleInfo); subposition++)
+        {
+            _subpositionStart[subposition] = static_cast<uint32_t>(_spans.size());
+            for (uint16_t i = 0; i < TrackVehicleInfoListSizes[subposition]; i++)
+            {
+                const auto* list = gTrackVehicleInfo[subposition][i];
+                auto it = listOffsets.find(list);
+                if (it == listOffsets.end())
+                {
+                    it = listOffsets.emplace(list, static_cast<uint32_t>(_entries.size())).first;
+                    for (uint16_t j = 0; j < list->size; j++)
+                    {
+                        _entries.push_back(Pack(list->info[j]));
+                    }
+                }
+                _spans.push_back({ it->second, list->size });
+            }
+        }
+        _subpositionStart[std::size(gTrackVehicleInfo)] = static_cast<uint32_t>(_spans.size());
+    }
+
+    rct_vehicle_info_packed_list Get(VehicleTrackSubposition trackSubposition, int32_t typeAndDirection) const
+    {
+        auto subposition = static_cast<size_t>(trackSubposition);
+        if (subposition >= std::size(gTrackVehicleInfo) || typeAndDirection < 0)
+        {
+            return {};
+        }
+        auto spanIndex = _subpositionStart[subposition] + static_cast<uint32_t>(typeAndDirection);
+        if (spanIndex >= _subpositionStart[subposition + 1])
+        {
+            return {};
+        }
+        const auto& span = _spans[spanIndex];
+        return { span.Size, &_entries[span.Offset] };
+    }
+
+private:
+    static rct_vehicle_info_packed Pack(const rct_vehicle_info& info)
+    {
+        Guard::Assert(info.direction < 32 && info.vehicle_sprite_type < 64 && info.bank_rotation < 32);
+        rct_vehicle_info_packed packed;
+        packed.x = info.x;
+        packed.y = info.y;
+        packed.z = info.z;
+        packed.attributes = info.direction | (info.vehicle_sprite_type << 5) | (info.bank_rotation << 11);
+        return packed;
+    }
+};
+
+static const PackedVehicleInfoTable _packedVehicleInfo;
+
+rct_vehicle_info_packed_list vehicle_get_packed_move_info(
+    VehicleTrackSubposition trackSubposition, int32_t typeAndDirection)
+{
+    return _packedVehicleInfo.Get(trackSubposition, typeAndDirection);
+}
@@ -20,3 +20,39 @@ struct rct_vehicle_info_list
 };
 
 extern const rct_vehicle_info_list* const* const gTrackVehicleInfo[17];
+
+/**
+ * An rct_vehicle_info packed into 8 bytes so that an entry never straddles a cache line.
+ */
+struct rct_vehicle_info_packed
+{
+    int16_t x;
+    int16_t y;
+    int16_t z;
+    // Bits 0-4: direction, bits 5-10: vehicle_sprite_type, bits 11-15: bank_rotation
+    uint16_t attributes;
+
+    rct_vehicle_info Unpack() const
+    {
+        return { x,
+                 y,
+                 z,
+                 static_cast<uint8_t>(attributes & 0x1F),
+                 static_cast<uint8_t>((attributes >> 5) & 0x3F),
+                 static_cast<uint8_t>(attributes >> 11) };
+    }
+};
+static_assert(sizeof(rct_vehicle_info_packed) == 8);
+
+struct rct_vehicle_info_packed_list
+{
+    uint16_t size;
+    const rct_vehicle_info_packed* info;
+};
+
+/**
+ * Gets the move info of a track piece from the packed copy of gTrackVehicleInfo, which keeps the entries of every
+ * subposition in one contiguous array. Returns an empty list for an unknown subposition or track piece.
+ */
+rct_vehicle_info_packed_list vehicle_get_packed_move_info(
+    VehicleTrackSubposition trackSubposition, int32_t typeAndDirection);
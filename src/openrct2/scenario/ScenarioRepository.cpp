@@ -30,6 +30,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <optional>
 #include <vector>
 
 using namespace OpenRCT2;
@@ -143,11 +144,25 @@ public:
     }
 
 protected:
-    std::tuple<bool, scenario_index_entry> Create(int32_t, const std::string& path) const override
+    std::tuple<bool, scenario_index_entry> Create(int32_t language, const std::string& path) const override
+    {
+        try
+        {
+            auto fs = FileStream(path, FILE_MODE_OPEN);
+            return Create(language, path, &fs);
+        }
+        catch (const std::exception&)
+        {
+            Console::Error::WriteLine("Unable to read scenario: '%s'", path.c_str());
+            return std::make_tuple(true, scenario_index_entry());
+        }
+    }
+
+    std::tuple<bool, scenario_index_entry> Create(int32_t, const std::string& path, IStream* stream) const override
     {
         scenario_index_entry entry;
         auto timestamp = File::GetLastModified(path);
-        if (GetScenarioInfo(path, timestamp, &entry))
+        if (GetScenarioInfo(path, stream, timestamp, &entry))
         {
             return std::make_tuple(true, entry);
         }
@@ -204,9 +219,9 @@ protected:
 
 private:
     /**
-     * Reads basic information from a scenario file.
+     * Reads basic information from a stream of a scenario file's contents.
      */
-    static bool GetScenarioInfo(const std::string& path, uint64_t timestamp, scenario_index_entry* entry)
+    static bool GetScenarioInfo(const std::string& path, IStream* stream, uint64_t timestamp, scenario_index_entry* entry)
     {
         log_verbose("GetScenarioInfo(%s, %d, ...)", path.c_str(), timestamp);
         try
@@ -219,7 +234,7 @@ private:
                 try
                 {
                     auto s4Importer = ParkImporter::CreateS4();
-                    s4Importer->LoadScenario(path.c_str(), true);
+                    s4Importer->LoadFromStream(stream, true, true, path.c_str());
                     if (s4Importer->GetDetails(entry))
                     {
                         String::Set(entry->path, sizeof(entry->path), path.c_str());
@@ -235,8 +250,7 @@ private:
             else
             {
                 // RCT2 scenario
-                auto fs = FileStream(path, FILE_MODE_OPEN);
-                auto chunkReader = SawyerChunkReader(&fs);
+                auto chunkReader = SawyerChunkReader(stream);
 
                 rct_s6_header header = chunkReader.ReadChunkAs<rct_s6_header>();
                 if (header.type == S6_TYPE_SCENARIO)
@@ -333,6 +347,7 @@ private:
     ScenarioFileIndex const _fileIndex;
     std::vector<scenario_index_entry> _scenarios;
     std::vector<scenario_highscore_entry*> _highscores;
+    std::optional<std::vector<scenario_index_entry>> _indexUpdate;
 
 public:
     explicit ScenarioRepository(const std::shared_ptr<IPlatformEnvironment>& env)
@@ -365,6 +380,29 @@ public:
         AttachHighscores();
     }
 
+    void UpdateIndex(int32_t language) override
+    {
+        _indexUpdate = _fileIndex.LoadOrBuild(language);
+    }
+
+    void ApplyIndexUpdate() override
+    {
+        if (!_indexUpdate)
+        {
+            return;
+        }
+
+        _scenarios.clear();
+        for (const auto& scenario : *_indexUpdate)
+        {
+            AddScenario(scenario);
+        }
+        _indexUpdate.reset();
+
+        Sort();
+        AttachHighscores();
+    }
+
     size_t GetCount() const override
     {
         return _scenarios.size();
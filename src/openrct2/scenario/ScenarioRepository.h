@@ -60,6 +60,12 @@ struct IScenarioRepository
      * Scans the scenario directories and grabs the metadata for all the scenarios.
      */
     virtual void Scan(int32_t language) abstract;
+    /**
+     * Updates the scenario index without changing the scenario list, see IObjectRepository::UpdateIndex. Highscores
+     * are kept as they are.
+     */
+    virtual void UpdateIndex(int32_t language) abstract;
+    virtual void ApplyIndexUpdate() abstract;
 
     virtual size_t GetCount() const abstract;
     virtual const scenario_index_entry* GetByIndex(size_t index) const abstract;
@@ -13,14 +13,38 @@
 
 #    include "../world/Map.h"
 
+#    include <atomic>
 #    include <cstdio>
 #    include <dukglue/dukglue.h>
 #    include <duktape.h>
 #    include <optional>
 #    include <stdexcept>
+#    include <utility>
+
+#    ifdef DUK_USE_EXEC_TIMEOUT_CHECK
+// Duktape builds that check for execution timeouts are expected to define DUK_USE_EXEC_TIMEOUT_CHECK(udata) as a call to
+// this function
+extern "C" duk_bool_t openrct2_duk_exec_timeout_check(void* udata);
+#    endif
 
 namespace OpenRCT2::Scripting
 {
+    /**
+     * The user data of the Duktape heaps created by CreateDukHeap.
+     */
+    struct DukHeapData
+    {
+        // Number of allocations made by the heap since it was created
+        uint64_t AllocationCount{};
+        // Stops the script running on the heap, if Duktape was built with DUK_USE_EXEC_TIMEOUT_CHECK
+        std::atomic<bool> Interrupted{};
+    };
+
+    /**
+     * Creates a Duktape heap that counts its allocations in the given data, which must outlive the heap.
+     */
+    duk_context* CreateDukHeap(DukHeapData& data);
+
     template<typename T> DukValue GetObjectAsDukValue(duk_context* ctx, const std::shared_ptr<T>& value)
     {
         dukglue::types::DukType<std::shared_ptr<T>>::template push<T>(ctx, value);
@@ -101,6 +125,13 @@ namespace OpenRCT2::Scripting
             duk_put_prop_string(_ctx, _idx, name);
         }
 
+        void Set(const char* name, double value)
+        {
+            EnsureObjectPushed();
+            duk_push_number(_ctx, value);
+            duk_put_prop_string(_ctx, _idx, name);
+        }
+
         void Set(const char* name, const std::string_view& value)
         {
             EnsureObjectPushed();
@@ -248,6 +279,37 @@ namespace OpenRCT2::Scripting
 
     std::string ProcessString(const DukValue& value);
 
+    template<typename T> struct DukTypedArrayType;
+    template<> struct DukTypedArrayType<uint8_t>
+    {
+        static constexpr duk_uint_t Flags = DUK_BUFOBJ_UINT8ARRAY;
+    };
+    template<> struct DukTypedArrayType<int16_t>
+    {
+        static constexpr duk_uint_t Flags = DUK_BUFOBJ_INT16ARRAY;
+    };
+    template<> struct DukTypedArrayType<uint16_t>
+    {
+        static constexpr duk_uint_t Flags = DUK_BUFOBJ_UINT16ARRAY;
+    };
+    template<> struct DukTypedArrayType<uint32_t>
+    {
+        static constexpr duk_uint_t Flags = DUK_BUFOBJ_UINT32ARRAY;
+    };
+
+    /**
+     * Creates a typed array of the given length and returns it along with a pointer to its elements, so that bulk data
+     * can be passed to scripts without creating a value for each element. The elements are zeroed.
+     */
+    template<typename T> std::pair<DukValue, T*> DukCreateTypedArray(duk_context* ctx, size_t length)
+    {
+        auto byteLength = static_cast<duk_size_t>(length * sizeof(T));
+        auto data = static_cast<T*>(duk_push_fixed_buffer(ctx, byteLength));
+        duk_push_buffer_object(ctx, -1, 0, byteLength, DukTypedArrayType<T>::Flags);
+        duk_remove(ctx, -2);
+        return { DukValue::take_from_stack(ctx), data };
+    }
+
     template<typename T> DukValue ToDuk(duk_context* ctx, const T& value) = delete;
     template<typename T> T FromDuk(const DukValue& s) = delete;
 
@@ -17,21 +17,35 @@
 
 using namespace OpenRCT2::Scripting;
 
+static const std::unordered_map<std::string, HOOK_TYPE> HookTypeLookupTable(
+    { { "action.query", HOOK_TYPE::ACTION_QUERY },
+      { "action.execute", HOOK_TYPE::ACTION_EXECUTE },
+      { "interval.tick", HOOK_TYPE::INTERVAL_TICK },
+      { "interval.day", HOOK_TYPE::INTERVAL_DAY },
+      { "network.chat", HOOK_TYPE::NETWORK_CHAT },
+      { "network.authenticate", HOOK_TYPE::NETWORK_AUTHENTICATE },
+      { "network.join", HOOK_TYPE::NETWORK_JOIN },
+      { "network.leave", HOOK_TYPE::NETWORK_LEAVE },
+      { "ride.ratings.calculate", HOOK_TYPE::RIDE_RATINGS_CALCULATE },
+      { "action.location", HOOK_TYPE::ACTION_LOCATION },
+      { "action.execute.batch", HOOK_TYPE::ACTION_EXECUTE_BATCH } });
+
 HOOK_TYPE OpenRCT2::Scripting::GetHookType(const std::string& name)
 {
-    static const std::unordered_map<std::string, HOOK_TYPE> LookupTable(
-        { { "action.query", HOOK_TYPE::ACTION_QUERY },
-          { "action.execute", HOOK_TYPE::ACTION_EXECUTE },
-          { "interval.tick", HOOK_TYPE::INTERVAL_TICK },
-          { "interval.day", HOOK_TYPE::INTERVAL_DAY },
-          { "network.chat", HOOK_TYPE::NETWORK_CHAT },
-          { "network.authenticate", HOOK_TYPE::NETWORK_AUTHENTICATE },
-          { "network.join", HOOK_TYPE::NETWORK_JOIN },
-          { "network.leave", HOOK_TYPE::NETWORK_LEAVE },
-          { "ride.ratings.calculate", HOOK_TYPE::RIDE_RATINGS_CALCULATE },
-          { "action.location", HOOK_TYPE::ACTION_LOCATION } });
-    auto result = LookupTable.find(name);
-    return (result != LookupTable.end()) ? result->second : HOOK_TYPE::UNDEFINED;
+    auto result = HookTypeLookupTable.find(name);
+    return (result != HookTypeLookupTable.end()) ? result->second : HOOK_TYPE::UNDEFINED;
+}
+
+std::string_view OpenRCT2::Scripting::GetHookName(HOOK_TYPE type)
+{
+    for (const auto& [name, hookType] : HookTypeLookupTable)
+    {
+        if (hookType == type)
+        {
+            return name;
+        }
+    }
+    return {};
 }
 
 HookEngine::HookEngine(ScriptEngine& scriptEngine)
@@ -97,7 +111,7 @@ void HookEngine::Call(HOOK_TYPE type, bool isGameStateMutable)
     auto& hookList = GetHookList(type);
     for (auto& hook : hookList.Hooks)
     {
-        _scriptEngine.ExecutePluginCall(hook.Owner, hook.Function, {}, isGameStateMutable);
+        _scriptEngine.ExecutePluginCall(hook.Owner, hook.Function, {}, isGameStateMutable, GetHookName(type));
     }
 }
 
@@ -106,7 +120,7 @@ void HookEngine::Call(HOOK_TYPE type, const DukValue& arg, bool isGameStateMutab
     auto& hookList = GetHookList(type);
     for (auto& hook : hookList.Hooks)
     {
-        _scriptEngine.ExecutePluginCall(hook.Owner, hook.Function, { arg }, isGameStateMutable);
+        _scriptEngine.ExecutePluginCall(hook.Owner, hook.Function, { arg }, isGameStateMutable, GetHookName(type));
     }
 }
 
@@ -141,7 +155,7 @@ void HookEngine::Call(
 
         std::vector<DukValue> dukArgs;
         dukArgs.push_back(DukValue::take_from_stack(ctx));
-        _scriptEngine.ExecutePluginCall(hook.Owner, hook.Function, dukArgs, isGameStateMutable);
+        _scriptEngine.ExecutePluginCall(hook.Owner, hook.Function, dukArgs, isGameStateMutable, GetHookName(type));
     }
 }
 
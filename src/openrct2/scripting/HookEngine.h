@@ -17,6 +17,7 @@
 #    include <any>
 #    include <memory>
 #    include <string>
+#    include <string_view>
 #    include <tuple>
 #    include <vector>
 
@@ -38,11 +39,13 @@ namespace OpenRCT2::Scripting
         NETWORK_LEAVE,
         RIDE_RATINGS_CALCULATE,
         ACTION_LOCATION,
+        ACTION_EXECUTE_BATCH,
         COUNT,
         UNDEFINED = -1,
     };
     constexpr size_t NUM_HOOK_TYPES = static_cast<size_t>(HOOK_TYPE::COUNT);
     HOOK_TYPE GetHookType(const std::string& name);
+    std::string_view GetHookName(HOOK_TYPE type);
 
     struct Hook
     {
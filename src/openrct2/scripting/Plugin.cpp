@@ -13,14 +13,56 @@
 
 #    include "../Diagnostic.h"
 #    include "../OpenRCT2.h"
+#    include "../core/File.h"
+#    include "../core/FileStream.hpp"
+#    include "../core/Path.hpp"
+#    include "../core/String.hpp"
 #    include "Duktape.hpp"
 
 #    include <algorithm>
+#    include <cinttypes>
+#    include <cstring>
 #    include <fstream>
 #    include <memory>
 
+using namespace OpenRCT2;
 using namespace OpenRCT2::Scripting;
 
+constexpr uint32_t BYTECODE_CACHE_MAGIC = 0x43425250; // PRBC
+constexpr uint32_t BYTECODE_CACHE_VERSION = 2;
+
+#    pragma pack(push, 1)
+struct BytecodeCacheHeader
+{
+    uint32_t Magic{};
+    uint32_t Version{};
+    uint32_t EngineVersion{};
+    uint32_t PointerSize{};
+    uint64_t SourceHash{};
+    uint64_t SourceLength{};
+    // Checked before the bytecode is handed to Duktape, which does not validate it
+    uint64_t PayloadHash{};
+    uint64_t PayloadLength{};
+};
+#    pragma pack(pop)
+
+static uint64_t GetFnv1aHash(std::string_view data)
+{
+    uint64_t hash = 0xCBF29CE484222325;
+    for (auto c : data)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001B3;
+    }
+    return hash;
+}
+
+static duk_ret_t LoadFunctionFromBuffer(duk_context* ctx, void* /*udata*/)
+{
+    duk_load_function(ctx);
+    return 1;
+}
+
 Plugin::Plugin(duk_context* context, const std::string& path)
     : _context(context)
     , _path(path)
@@ -32,38 +74,72 @@ void Plugin::SetCode(const std::string_view& code)
     _code = code;
 }
 
-void Plugin::Load()
+void Plugin::Load(const std::string& bytecodeCacheDirectory)
 {
     if (!_path.empty())
     {
         LoadCodeFromFile();
     }
 
-    std::string projectedVariables = "console,context,date,map,network,park";
+    std::vector<std::string> projectedVariables = { "console", "context", "date", "map", "network", "park" };
     if (!gOpenRCT2Headless)
     {
-        projectedVariables += ",ui";
+        projectedVariables.push_back("ui");
     }
 
-    // Wrap the script in a function and pass the global objects as variables
+    std::string parameters;
+    for (const auto& variable : projectedVariables)
+    {
+        if (!parameters.empty())
+            parameters += ",";
+        parameters += variable;
+    }
+
+    // Wrap the script in a function and pass the global objects as arguments
     // so that if the script modifies them, they are not modified for other scripts.
 
     // clang-format off
-    auto code = _code;
-    code =
-        "     (function(" + projectedVariables + ") {"
+    auto code =
+        "     function(" + parameters + ") {"
         "         var __metadata__ = null;"
         "         var registerPlugin = function(m) { __metadata__ = m };"
         "         (function(__metadata__) {"
-                      + code +
+                      + _code +
         "         })();"
         "         return __metadata__;"
-        "     })(" + projectedVariables + ");";
+        "     }";
     // clang-format on
 
-    auto flags = DUK_COMPILE_EVAL | DUK_COMPILE_SAFE | DUK_COMPILE_NOSOURCE | DUK_COMPILE_NOFILENAME;
-    auto result = duk_eval_raw(_context, code.c_str(), code.size(), flags);
-    if (result != DUK_ERR_NONE)
+    // Compiling large scripts is slow, so the compiled function is cached and reused until the source changes
+    std::string cachePath;
+    auto sourceHash = GetFnv1aHash(code);
+    if (!bytecodeCacheDirectory.empty())
+    {
+        // The parameters differ between headless and GUI, so both get their own file
+        auto cacheKey = _path.empty() ? sourceHash : GetFnv1aHash(parameters + ";" + _path);
+        cachePath = Path::Combine(bytecodeCacheDirectory, String::StdFormat("%016" PRIx64 ".bin", cacheKey));
+    }
+
+    if (cachePath.empty() || !LoadBytecode(cachePath, sourceHash, code.size()))
+    {
+        auto flags = DUK_COMPILE_FUNCTION | DUK_COMPILE_SAFE | DUK_COMPILE_NOSOURCE | DUK_COMPILE_NOFILENAME;
+        if (duk_compile_raw(_context, code.c_str(), code.size(), flags) != DUK_EXEC_SUCCESS)
+        {
+            auto val = std::string(duk_safe_to_string(_context, -1));
+            duk_pop(_context);
+            throw std::runtime_error("Failed to load plug-in script: " + val);
+        }
+        if (!cachePath.empty())
+        {
+            SaveBytecode(cachePath, sourceHash, code.size());
+        }
+    }
+
+    for (const auto& variable : projectedVariables)
+    {
+        duk_get_global_lstring(_context, variable.data(), variable.size());
+    }
+    if (duk_pcall(_context, static_cast<duk_idx_t>(projectedVariables.size())) != DUK_EXEC_SUCCESS)
     {
         auto val = std::string(duk_safe_to_string(_context, -1));
         duk_pop(_context);
@@ -113,6 +189,95 @@ void Plugin::LoadCodeFromFile()
     _code = std::move(code);
 }
 
+bool Plugin::LoadBytecode(const std::string& path, uint64_t sourceHash, size_t sourceLength)
+{
+    if (!File::Exists(path))
+    {
+        return false;
+    }
+
+    try
+    {
+        auto fs = FileStream(path, FILE_MODE_OPEN);
+        auto header = fs.ReadValue<BytecodeCacheHeader>();
+        if (header.Magic != BYTECODE_CACHE_MAGIC || header.Version != BYTECODE_CACHE_VERSION
+            || header.EngineVersion != DUK_VERSION || header.PointerSize != sizeof(void*) || header.SourceHash != sourceHash
+            || header.SourceLength != sourceLength || header.PayloadLength != fs.GetLength() - fs.GetPosition())
+        {
+            return false;
+        }
+
+        std::vector<uint8_t> payload(static_cast<size_t>(header.PayloadLength));
+        fs.Read(payload.data(), payload.size());
+        auto payloadView = std::string_view(reinterpret_cast<const char*>(payload.data()), payload.size());
+        if (GetFnv1aHash(payloadView) != header.PayloadHash)
+        {
+            log_warning("Cached plug-in bytecode '%s' is corrupt", path.c_str());
+            return false;
+        }
+
+        auto buffer = duk_push_fixed_buffer(_context, payload.size());
+        std::memcpy(buffer, payload.data(), payload.size());
+        if (duk_safe_call(_context, LoadFunctionFromBuffer, nullptr, 1, 1) != DUK_EXEC_SUCCESS)
+        {
+            log_warning("Unable to load cached plug-in bytecode '%s': %s", path.c_str(), duk_safe_to_string(_context, -1));
+            duk_pop(_context);
+            return false;
+        }
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        log_warning("Unable to read cached plug-in bytecode '%s': %s", path.c_str(), e.what());
+        return false;
+    }
+}
+
+void Plugin::SaveBytecode(const std::string& path, uint64_t sourceHash, size_t sourceLength)
+{
+    // Dump a copy so that the compiled function is left on the stack
+    duk_dup(_context, -1);
+    duk_dump_function(_context);
+    duk_size_t length{};
+    auto data = duk_get_buffer_data(_context, -1, &length);
+    try
+    {
+        BytecodeCacheHeader header;
+        header.Magic = BYTECODE_CACHE_MAGIC;
+        header.Version = BYTECODE_CACHE_VERSION;
+        header.EngineVersion = DUK_VERSION;
+        header.PointerSize = sizeof(void*);
+        header.SourceHash = sourceHash;
+        header.SourceLength = sourceLength;
+        header.PayloadHash = GetFnv1aHash(std::string_view(static_cast<const char*>(data), length));
+        header.PayloadLength = length;
+
+        // Write to a temporary file and move it into place, so that a partly written file is never read
+        Path::CreateDirectory(Path::GetDirectory(path));
+        auto tempPath = path + ".tmp";
+        {
+            auto fs = FileStream(tempPath, FILE_MODE_WRITE);
+            fs.WriteValue(header);
+            fs.Write(data, length);
+        }
+        if (!File::Move(tempPath, path))
+        {
+            // Not all platforms replace an existing file when moving
+            File::Delete(path);
+            if (!File::Move(tempPath, path))
+            {
+                File::Delete(tempPath);
+                log_warning("Unable to write cached plug-in bytecode '%s'", path.c_str());
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        log_warning("Unable to write cached plug-in bytecode '%s': %s", path.c_str(), e.what());
+    }
+    duk_pop(_context);
+}
+
 static std::string TryGetString(const DukValue& value, const std::string& message)
 {
     if (value.type() != DukValue::Type::STRING)
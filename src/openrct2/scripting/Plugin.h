@@ -86,12 +86,18 @@ namespace OpenRCT2::Scripting
         Plugin(Plugin&&) = delete;
 
         void SetCode(const std::string_view& code);
-        void Load();
+        /**
+         * Compiles and runs the plugin's script. If a cache directory is given, the compiled script is saved
+         * there and reused on later loads as long as the source has not changed.
+         */
+        void Load(const std::string& bytecodeCacheDirectory = {});
         void Start();
         void Stop();
 
     private:
         void LoadCodeFromFile();
+        bool LoadBytecode(const std::string& path, uint64_t sourceHash, size_t sourceLength);
+        void SaveBytecode(const std::string& path, uint64_t sourceHash, size_t sourceLength);
 
         static PluginMetadata GetMetadata(const DukValue& dukMetadata);
         static PluginType ParsePluginType(const std::string_view& type);
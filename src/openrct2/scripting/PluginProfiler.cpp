@@ -0,0 +1,97 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifdef ENABLE_SCRIPTING
+
+#    include "PluginProfiler.h"
+
+#    include <algorithm>
+
+using namespace OpenRCT2::Scripting;
+
+PluginProfiler::CallScope PluginProfiler::BeginCall(uint64_t allocationCount)
+{
+    CallScope scope;
+    scope.Start = std::chrono::steady_clock::now();
+    scope.StartAllocations = allocationCount;
+    scope.OuterNestedTime = _nestedTime;
+    scope.OuterNestedAllocations = _nestedAllocations;
+    _nestedTime = 0;
+    _nestedAllocations = 0;
+    return scope;
+}
+
+void PluginProfiler::EndCall(
+    const CallScope& scope, std::string_view pluginName, std::string_view callType, uint64_t allocationCount)
+{
+    auto duration = std::chrono::steady_clock::now() - scope.Start;
+    auto elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    auto allocations = allocationCount - scope.StartAllocations;
+
+    // Leave out the calls into other plugins made during this call, they have been counted already
+    auto selfTime = elapsed - std::min(elapsed, _nestedTime);
+    auto selfAllocations = allocations - std::min(allocations, _nestedAllocations);
+    _nestedTime = scope.OuterNestedTime + elapsed;
+    _nestedAllocations = scope.OuterNestedAllocations + allocations;
+
+    auto pluginIt = _stats.find(pluginName);
+    if (pluginIt == _stats.end())
+    {
+        pluginIt = _stats.emplace(std::string(pluginName), PluginStats()).first;
+    }
+    auto& pluginStats = pluginIt->second;
+
+    auto callIt = pluginStats.Calls.find(callType);
+    if (callIt == pluginStats.Calls.end())
+    {
+        callIt = pluginStats.Calls.emplace(std::string(callType), PluginCallStats()).first;
+    }
+    auto& callStats = callIt->second;
+
+    callStats.CallCount++;
+    callStats.TotalTime += selfTime;
+    callStats.MaxTime = std::max(callStats.MaxTime, selfTime);
+    callStats.Allocations += selfAllocations;
+    pluginStats.TickTime += selfTime;
+}
+
+void PluginProfiler::BeginTick()
+{
+    for (auto& [pluginName, pluginStats] : _stats)
+    {
+        pluginStats.TickTime = 0;
+    }
+    _nestedTime = 0;
+    _nestedAllocations = 0;
+}
+
+std::vector<std::string> PluginProfiler::EndTick(uint64_t tickBudget)
+{
+    std::vector<std::string> overBudget;
+    for (auto& [pluginName, pluginStats] : _stats)
+    {
+        if (tickBudget != 0 && pluginStats.TickTime > tickBudget)
+        {
+            pluginStats.TicksOverBudget++;
+            overBudget.push_back(pluginName);
+        }
+        pluginStats.MaxTickTime = std::max(pluginStats.MaxTickTime, pluginStats.TickTime);
+        pluginStats.TickTime = 0;
+    }
+    _nestedTime = 0;
+    _nestedAllocations = 0;
+    return overBudget;
+}
+
+void PluginProfiler::Reset()
+{
+    _stats.clear();
+}
+
+#endif
@@ -0,0 +1,87 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#ifdef ENABLE_SCRIPTING
+
+#    include "../common.h"
+
+#    include <chrono>
+#    include <functional>
+#    include <map>
+#    include <string>
+#    include <string_view>
+#    include <vector>
+
+namespace OpenRCT2::Scripting
+{
+    struct PluginCallStats
+    {
+        uint64_t CallCount{};
+        uint64_t TotalTime{};
+        uint64_t MaxTime{};
+        uint64_t Allocations{};
+    };
+
+    struct PluginStats
+    {
+        // Keyed by the kind of call, e.g. the hook the callback was subscribed to
+        std::map<std::string, PluginCallStats, std::less<>> Calls;
+        uint64_t TickTime{};
+        uint64_t MaxTickTime{};
+        uint32_t TicksOverBudget{};
+    };
+
+    /**
+     * Measures the time spent and the memory allocations made in the callbacks of each plugin. Times are in
+     * microseconds. Calls made into other plugins from within a callback, such as action hooks, are only counted for
+     * the plugin being called.
+     */
+    class PluginProfiler
+    {
+    public:
+        struct CallScope
+        {
+            std::chrono::steady_clock::time_point Start;
+            uint64_t StartAllocations{};
+            uint64_t OuterNestedTime{};
+            uint64_t OuterNestedAllocations{};
+        };
+
+    private:
+        std::map<std::string, PluginStats, std::less<>> _stats;
+        uint64_t _nestedTime{};
+        uint64_t _nestedAllocations{};
+
+    public:
+        CallScope BeginCall(uint64_t allocationCount);
+        void EndCall(
+            const CallScope& scope, std::string_view pluginName, std::string_view callType, uint64_t allocationCount);
+
+        /**
+         * Starts the accounting of a tick. Time spent in callbacks between ticks, such as those of UI events, does not
+         * count towards any tick.
+         */
+        void BeginTick();
+        /**
+         * Ends the accounting of the current tick, returns the plugins that spent more than the given number of
+         * microseconds in it. A budget of 0 means no limit.
+         */
+        std::vector<std::string> EndTick(uint64_t tickBudget);
+
+        const std::map<std::string, PluginStats, std::less<>>& GetStats() const
+        {
+            return _stats;
+        }
+        void Reset();
+    };
+} // namespace OpenRCT2::Scripting
+
+#endif
@@ -20,8 +20,10 @@
 #    include "ScConfiguration.hpp"
 #    include "ScDisposable.hpp"
 #    include "ScObject.hpp"
+#    include "ScWorker.hpp"
 #    include "ScriptEngine.h"
 
+#    include <algorithm>
 #    include <cstdio>
 #    include <memory>
 
@@ -61,6 +63,10 @@ namespace OpenRCT2::Scripting
                 captureOptions.Filename = fs::u8path(AsOrDefault(options["filename"], ""));
                 captureOptions.Rotation = options["rotation"].as_int() & 3;
                 captureOptions.Zoom = ZoomLevel(options["zoom"].as_int());
+                if (options["compressionLevel"].type() == DukValue::Type::NUMBER)
+                {
+                    captureOptions.CompressionLevel = options["compressionLevel"].as_int();
+                }
 
                 auto dukPosition = options["position"];
                 if (dukPosition.type() == DukValue::Type::OBJECT)
@@ -177,6 +183,23 @@ namespace OpenRCT2::Scripting
             return std::make_shared<ScDisposable>([this, hookType, cookie]() { _hookEngine.Unsubscribe(hookType, cookie); });
         }
 
+        std::shared_ptr<ScWorker> createWorker(const std::string& script)
+        {
+            auto owner = _execInfo.GetCurrentPlugin();
+            if (owner == nullptr)
+            {
+                throw DukException() << "Not in a plugin context";
+            }
+
+            auto& scriptEngine = GetContext()->GetScriptEngine();
+            auto worker = scriptEngine.CreateWorker(owner, script);
+            if (worker == nullptr)
+            {
+                throw DukException() << "Too many workers running";
+            }
+            return std::make_shared<ScWorker>(worker);
+        }
+
         void queryAction(const std::string& action, const DukValue& args, const DukValue& callback)
         {
             QueryOrExecuteAction(action, args, callback, false);
@@ -257,6 +280,44 @@ namespace OpenRCT2::Scripting
             }
         }
 
+        DukValue getPerformanceStats() const
+        {
+            auto& scriptEngine = GetContext()->GetScriptEngine();
+            auto ctx = scriptEngine.GetContext();
+            const auto& stats = scriptEngine.GetProfiler().GetStats();
+
+            // Times are given in milliseconds
+            duk_push_array(ctx);
+            duk_uarridx_t pluginIndex = 0;
+            for (const auto& [pluginName, pluginStats] : stats)
+            {
+                duk_push_array(ctx);
+                duk_uarridx_t callIndex = 0;
+                for (const auto& [callType, callStats] : pluginStats.Calls)
+                {
+                    DukObject dukCall(ctx);
+                    dukCall.Set("type", std::string_view(callType));
+                    dukCall.Set("count", static_cast<double>(callStats.CallCount));
+                    dukCall.Set("totalTime", callStats.TotalTime / 1000.0);
+                    dukCall.Set("averageTime", callStats.TotalTime / 1000.0 / std::max<uint64_t>(1, callStats.CallCount));
+                    dukCall.Set("maxTime", callStats.MaxTime / 1000.0);
+                    dukCall.Set("allocations", static_cast<double>(callStats.Allocations));
+                    dukCall.Take().push();
+                    duk_put_prop_index(ctx, -2, callIndex++);
+                }
+                auto dukCalls = DukValue::take_from_stack(ctx);
+
+                DukObject dukPlugin(ctx);
+                dukPlugin.Set("plugin", std::string_view(pluginName));
+                dukPlugin.Set("maxTickTime", pluginStats.MaxTickTime / 1000.0);
+                dukPlugin.Set("ticksOverBudget", pluginStats.TicksOverBudget);
+                dukPlugin.Set("calls", dukCalls);
+                dukPlugin.Take().push();
+                duk_put_prop_index(ctx, -2, pluginIndex++);
+            }
+            return DukValue::take_from_stack(ctx);
+        }
+
         void registerAction(const std::string& action, const DukValue& query, const DukValue& execute)
         {
             auto& scriptEngine = GetContext()->GetScriptEngine();
@@ -285,7 +346,9 @@ namespace OpenRCT2::Scripting
             dukglue_register_method(ctx, &ScContext::getObject, "getObject");
             dukglue_register_method(ctx, &ScContext::getAllObjects, "getAllObjects");
             dukglue_register_method(ctx, &ScContext::getRandom, "getRandom");
+            dukglue_register_method(ctx, &ScContext::getPerformanceStats, "getPerformanceStats");
             dukglue_register_method(ctx, &ScContext::subscribe, "subscribe");
+            dukglue_register_method(ctx, &ScContext::createWorker, "createWorker");
             dukglue_register_method(ctx, &ScContext::queryAction, "queryAction");
             dukglue_register_method(ctx, &ScContext::executeAction, "executeAction");
             dukglue_register_method(ctx, &ScContext::registerAction, "registerAction");
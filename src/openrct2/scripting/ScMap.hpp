@@ -19,6 +19,9 @@
 #    include "ScRide.hpp"
 #    include "ScTile.hpp"
 
+#    include <algorithm>
+#    include <vector>
+
 namespace OpenRCT2::Scripting
 {
     class ScMap
@@ -100,6 +103,196 @@ namespace OpenRCT2::Scripting
         }
 
         std::vector<DukValue> getAllEntities(const std::string& type) const
+        {
+            std::vector<DukValue> result;
+            for (auto sprite : GetEntitiesOfType(type))
+            {
+                if (sprite->sprite_identifier == SPRITE_IDENTIFIER_PEEP)
+                {
+                    if (sprite->Is<Staff>())
+                        result.push_back(GetObjectAsDukValue(_context, std::make_shared<ScStaff>(sprite->sprite_index)));
+                    else
+                        result.push_back(GetObjectAsDukValue(_context, std::make_shared<ScGuest>(sprite->sprite_index)));
+                }
+                else if (sprite->sprite_identifier == SPRITE_IDENTIFIER_VEHICLE)
+                {
+                    result.push_back(GetObjectAsDukValue(_context, std::make_shared<ScVehicle>(sprite->sprite_index)));
+                }
+                else
+                {
+                    result.push_back(GetObjectAsDukValue(_context, std::make_shared<ScEntity>(sprite->sprite_index)));
+                }
+            }
+            return result;
+        }
+
+        DukValue getTileData(int32_t x, int32_t y, int32_t width, int32_t height) const
+        {
+            auto region = ClampRegion(x, y, width, height);
+            auto numTiles = static_cast<size_t>(region.Width) * region.Height;
+            auto [baseHeights, baseHeightData] = DukCreateTypedArray<uint8_t>(_context, numTiles);
+            auto [waterHeights, waterHeightData] = DukCreateTypedArray<uint16_t>(_context, numTiles);
+            auto [surfaceStyles, surfaceStyleData] = DukCreateTypedArray<uint8_t>(_context, numTiles);
+            auto [edgeStyles, edgeStyleData] = DukCreateTypedArray<uint8_t>(_context, numTiles);
+            auto [numElements, numElementsData] = DukCreateTypedArray<uint16_t>(_context, numTiles);
+
+            size_t i = 0;
+            for (int32_t ty = region.Y; ty < region.Y + region.Height; ty++)
+            {
+                for (int32_t tx = region.X; tx < region.X + region.Width; tx++)
+                {
+                    auto element = map_get_first_element_at(TileCoordsXY(tx, ty).ToCoordsXY());
+                    if (element != nullptr)
+                    {
+                        uint16_t count = 0;
+                        do
+                        {
+                            auto surface = element->AsSurface();
+                            if (surface != nullptr)
+                            {
+                                baseHeightData[i] = surface->base_height;
+                                waterHeightData[i] = static_cast<uint16_t>(surface->GetWaterHeight());
+                                surfaceStyleData[i] = static_cast<uint8_t>(surface->GetSurfaceStyle());
+                                edgeStyleData[i] = static_cast<uint8_t>(surface->GetEdgeStyle());
+                            }
+                            count++;
+                        } while (!(element++)->IsLastForTile());
+                        numElementsData[i] = count;
+                    }
+                    i++;
+                }
+            }
+
+            DukObject result(_context);
+            SetRegion(result, region);
+            result.Set("baseHeight", baseHeights);
+            result.Set("waterHeight", waterHeights);
+            result.Set("surfaceStyle", surfaceStyles);
+            result.Set("edgeStyle", edgeStyles);
+            result.Set("numElements", numElements);
+            return result.Take();
+        }
+
+        DukValue getElementTypes(int32_t x, int32_t y, int32_t width, int32_t height) const
+        {
+            auto region = ClampRegion(x, y, width, height);
+
+            // The types of the elements of tile i are types[offsets[i]] up to types[offsets[i + 1]]
+            std::vector<uint32_t> offsets;
+            std::vector<uint8_t> types;
+            offsets.reserve(static_cast<size_t>(region.Width) * region.Height + 1);
+            for (int32_t ty = region.Y; ty < region.Y + region.Height; ty++)
+            {
+                for (int32_t tx = region.X; tx < region.X + region.Width; tx++)
+                {
+                    offsets.push_back(static_cast<uint32_t>(types.size()));
+                    auto element = map_get_first_element_at(TileCoordsXY(tx, ty).ToCoordsXY());
+                    if (element != nullptr)
+                    {
+                        do
+                        {
+                            types.push_back(static_cast<uint8_t>(element->GetType() >> 2));
+                        } while (!(element++)->IsLastForTile());
+                    }
+                }
+            }
+            offsets.push_back(static_cast<uint32_t>(types.size()));
+
+            auto [dukOffsets, offsetsData] = DukCreateTypedArray<uint32_t>(_context, offsets.size());
+            std::copy(offsets.begin(), offsets.end(), offsetsData);
+            auto [dukTypes, typesData] = DukCreateTypedArray<uint8_t>(_context, types.size());
+            std::copy(types.begin(), types.end(), typesData);
+
+            DukObject result(_context);
+            SetRegion(result, region);
+            result.Set("offsets", dukOffsets);
+            result.Set("types", dukTypes);
+            return result.Take();
+        }
+
+        DukValue getEntityData(const std::string& type) const
+        {
+            auto sprites = GetEntitiesOfType(type);
+            auto [ids, idsData] = DukCreateTypedArray<uint16_t>(_context, sprites.size());
+            auto [xs, xData] = DukCreateTypedArray<int16_t>(_context, sprites.size());
+            auto [ys, yData] = DukCreateTypedArray<int16_t>(_context, sprites.size());
+            auto [zs, zData] = DukCreateTypedArray<int16_t>(_context, sprites.size());
+            auto [states, statesData] = DukCreateTypedArray<uint8_t>(_context, sprites.size());
+            for (size_t i = 0; i < sprites.size(); i++)
+            {
+                auto sprite = sprites[i];
+                idsData[i] = sprite->sprite_index;
+                xData[i] = sprite->x;
+                yData[i] = sprite->y;
+                zData[i] = sprite->z;
+                if (auto peep = sprite->As<Peep>())
+                {
+                    statesData[i] = static_cast<uint8_t>(peep->State);
+                }
+                else if (auto vehicle = sprite->As<Vehicle>())
+                {
+                    statesData[i] = static_cast<uint8_t>(vehicle->status);
+                }
+            }
+
+            DukObject result(_context);
+            result.Set("id", ids);
+            result.Set("x", xs);
+            result.Set("y", ys);
+            result.Set("z", zs);
+            result.Set("state", states);
+            return result.Take();
+        }
+
+        static void Register(duk_context* ctx)
+        {
+            dukglue_register_property(ctx, &ScMap::size_get, nullptr, "size");
+            dukglue_register_property(ctx, &ScMap::numRides_get, nullptr, "numRides");
+            dukglue_register_property(ctx, &ScMap::numEntities_get, nullptr, "numEntities");
+            dukglue_register_property(ctx, &ScMap::rides_get, nullptr, "rides");
+            dukglue_register_method(ctx, &ScMap::getRide, "getRide");
+            dukglue_register_method(ctx, &ScMap::getTile, "getTile");
+            dukglue_register_method(ctx, &ScMap::getEntity, "getEntity");
+            dukglue_register_method(ctx, &ScMap::getAllEntities, "getAllEntities");
+            dukglue_register_method(ctx, &ScMap::getTileData, "getTileData");
+            dukglue_register_method(ctx, &ScMap::getElementTypes, "getElementTypes");
+            dukglue_register_method(ctx, &ScMap::getEntityData, "getEntityData");
+        }
+
+    private:
+        struct MapRegion
+        {
+            int32_t X{};
+            int32_t Y{};
+            int32_t Width{};
+            int32_t Height{};
+        };
+
+        static MapRegion ClampRegion(int32_t x, int32_t y, int32_t width, int32_t height)
+        {
+            MapRegion region;
+            region.X = std::clamp(x, 0, static_cast<int32_t>(gMapSize));
+            region.Y = std::clamp(y, 0, static_cast<int32_t>(gMapSize));
+            // Summed as 64-bit so that large script arguments cannot overflow
+            auto right = std::clamp<int64_t>(static_cast<int64_t>(x) + width, region.X, gMapSize);
+            auto bottom = std::clamp<int64_t>(static_cast<int64_t>(y) + height, region.Y, gMapSize);
+            region.Width = static_cast<int32_t>(right) - region.X;
+            region.Height = static_cast<int32_t>(bottom) - region.Y;
+            return region;
+        }
+
+        static void SetRegion(DukObject& obj, const MapRegion& region)
+        {
+            obj.Set("x", region.X);
+            obj.Set("y", region.Y);
+            obj.Set("width", region.Width);
+            obj.Set("height", region.Height);
+        }
+
+        /**
+         * Gets the entities of the given script entity type, the cars of each train are returned in order.
+         */
+        std::vector<const SpriteBase*> GetEntitiesOfType(const std::string& type) const
         {
             EntityListId targetList{};
             uint8_t targetType{};
@@ -108,7 +301,7 @@ namespace OpenRCT2::Scripting
                 targetList = EntityListId::Misc;
                 targetType = SPRITE_MISC_BALLOON;
             }
-            if (type == "car")
+            else if (type == "car")
             {
                 targetList = EntityListId::TrainHead;
             }
@@ -130,50 +323,30 @@ namespace OpenRCT2::Scripting
                 duk_error(_context, DUK_ERR_ERROR, "Invalid entity type.");
             }
 
-            std::vector<DukValue> result;
+            std::vector<const SpriteBase*> result;
             for (auto sprite : EntityList(targetList))
             {
                 // Only the misc list checks the type property
-                if (targetList != EntityListId::Misc || sprite->type == targetType)
+                if (targetList == EntityListId::Misc && sprite->type != targetType)
                 {
-                    if (targetList == EntityListId::Peep)
-                    {
-                        if (sprite->Is<Staff>())
-                            result.push_back(GetObjectAsDukValue(_context, std::make_shared<ScStaff>(sprite->sprite_index)));
-                        else
-                            result.push_back(GetObjectAsDukValue(_context, std::make_shared<ScGuest>(sprite->sprite_index)));
-                    }
-                    else if (targetList == EntityListId::TrainHead)
-                    {
-                        for (auto carId = sprite->sprite_index; carId != SPRITE_INDEX_NULL;)
-                        {
-                            auto car = GetEntity<Vehicle>(carId);
-                            result.push_back(GetObjectAsDukValue(_context, std::make_shared<ScVehicle>(carId)));
-                            carId = car->next_vehicle_on_train;
-                        }
-                    }
-                    else
+                    continue;
+                }
+
+                if (targetList == EntityListId::TrainHead)
+                {
+                    for (auto car = sprite->As<Vehicle>(); car != nullptr; car = GetEntity<Vehicle>(car->next_vehicle_on_train))
                     {
-                        result.push_back(GetObjectAsDukValue(_context, std::make_shared<ScEntity>(sprite->sprite_index)));
+                        result.push_back(car);
                     }
                 }
+                else
+                {
+                    result.push_back(sprite);
+                }
             }
             return result;
         }
 
-        static void Register(duk_context* ctx)
-        {
-            dukglue_register_property(ctx, &ScMap::size_get, nullptr, "size");
-            dukglue_register_property(ctx, &ScMap::numRides_get, nullptr, "numRides");
-            dukglue_register_property(ctx, &ScMap::numEntities_get, nullptr, "numEntities");
-            dukglue_register_property(ctx, &ScMap::rides_get, nullptr, "rides");
-            dukglue_register_method(ctx, &ScMap::getRide, "getRide");
-            dukglue_register_method(ctx, &ScMap::getTile, "getTile");
-            dukglue_register_method(ctx, &ScMap::getEntity, "getEntity");
-            dukglue_register_method(ctx, &ScMap::getAllEntities, "getAllEntities");
-        }
-
-    private:
         DukValue GetEntityAsDukValue(const SpriteBase* sprite) const
         {
             auto spriteId = sprite->sprite_index;
@@ -29,16 +29,72 @@ namespace OpenRCT2::Scripting
 {
     class ScSurfaceElement;
 
+    /**
+     * Refers to a tile element by its tile and index rather than by its address. The elements of a tile move in
+     * memory whenever the tile is edited or compacted, while scripts can hold on to tile elements across ticks.
+     */
+    class TileElementRef
+    {
+    private:
+        CoordsXY _coords;
+        size_t _index{};
+
+    public:
+        TileElementRef(const CoordsXY& coords, size_t index)
+            : _coords(coords)
+            , _index(index)
+        {
+        }
+
+        size_t GetIndex() const
+        {
+            return _index;
+        }
+
+        TileElement* Get() const
+        {
+            auto element = map_get_first_element_at(_coords);
+            if (element == nullptr)
+                return nullptr;
+
+            for (size_t i = 0; i < _index; i++)
+            {
+                if ((element++)->IsLastForTile())
+                    return nullptr;
+            }
+            return element;
+        }
+
+        /**
+         * Gets the element, raising a script error if the tile no longer has that many elements.
+         */
+        TileElement* Resolve() const
+        {
+            auto element = Get();
+            if (element == nullptr)
+            {
+                auto ctx = GetContext()->GetScriptEngine().GetContext();
+                duk_error(ctx, DUK_ERR_ERROR, "Tile element no longer exists.");
+            }
+            return element;
+        }
+
+        TileElement* operator->() const
+        {
+            return Resolve();
+        }
+    };
+
     class ScTileElement
     {
     protected:
         CoordsXY _coords;
-        TileElement* _element;
+        TileElementRef _element;
 
     public:
-        ScTileElement(const CoordsXY& coords, TileElement* element)
+        ScTileElement(const CoordsXY& coords, size_t index)
             : _coords(coords)
-            , _element(element)
+            , _element(coords, index)
         {
         }
 
@@ -525,10 +581,11 @@ namespace OpenRCT2::Scripting
         {
             // TODO: Simply return the 'hidden' field once corrupt elements are superseded.
             const TileElement* element = map_get_first_element_at(_coords);
+            const TileElement* self = _element.Resolve();
             bool previousElementWasUsefulCorrupt = false;
             do
             {
-                if (element == _element)
+                if (element == self)
                     return previousElementWasUsefulCorrupt;
 
                 if (element->GetType() == TILE_ELEMENT_TYPE_CORRUPT)
@@ -550,8 +607,7 @@ namespace OpenRCT2::Scripting
 
             if (hide)
             {
-                // Get index of our current element (has to be done now before inserting the corrupt element)
-                const auto elementIndex = _element - map_get_first_element_at(_coords);
+                const auto elementIndex = _element.GetIndex();
 
                 // Insert corrupt element at the end of the list for this tile
                 // Note: Z = MAX_ELEMENT_HEIGHT to guarantee this
@@ -563,11 +619,11 @@ namespace OpenRCT2::Scripting
                 }
                 insertedElement->SetType(TILE_ELEMENT_TYPE_CORRUPT);
 
-                // Since inserting a new element may move the tile elements in memory, we have to update the local pointer
-                _element = map_get_first_element_at(_coords) + elementIndex;
+                // Inserting a new element may move the tile elements in memory, so the element is looked up again
+                TileElement* element = map_get_first_element_at(_coords) + elementIndex;
 
                 // Move the corrupt element down in the list until it's right under our element
-                while (insertedElement > _element)
+                while (insertedElement > element)
                 {
                     std::swap<TileElement>(*insertedElement, *(insertedElement - 1));
                     insertedElement--;
@@ -581,17 +637,17 @@ namespace OpenRCT2::Scripting
                 }
 
                 // Now the corrupt element took the hidden element's place, increment it by one
-                _element++;
+                _element = TileElementRef(_coords, elementIndex + 1);
 
                 // Update base and clearance heights of inserted corrupt element to match the element to hide
                 insertedElement->base_height = insertedElement->clearance_height = _element->base_height;
             }
             else
             {
-                TileElement* const elementToRemove = _element - 1;
+                TileElement* const elementToRemove = _element.Resolve() - 1;
                 Guard::Assert(elementToRemove->GetType() == TILE_ELEMENT_TYPE_CORRUPT);
                 tile_element_remove(elementToRemove);
-                _element--;
+                _element = TileElementRef(_coords, _element.GetIndex() - 1);
             }
 
             Invalidate();
@@ -944,7 +1000,7 @@ namespace OpenRCT2::Scripting
 
         uint8_t direction_get() const
         {
-            if (_element != nullptr)
+            if (_element.Get() != nullptr)
             {
                 return _element->GetDirection();
             }
@@ -954,7 +1010,7 @@ namespace OpenRCT2::Scripting
         void direction_set(uint8_t value)
         {
             ThrowIfGameStateNotMutable();
-            if (_element != nullptr)
+            if (_element.Get() != nullptr)
             {
                 _element->SetDirection(value);
                 Invalidate();
@@ -1078,7 +1134,7 @@ namespace OpenRCT2::Scripting
                 result.reserve(currentNumElements);
                 for (size_t i = 0; i < currentNumElements; i++)
                 {
-                    result.push_back(std::make_shared<ScTileElement>(_coords, &first[i]));
+                    result.push_back(std::make_shared<ScTileElement>(_coords, i));
                 }
             }
             return result;
@@ -1107,42 +1163,9 @@ namespace OpenRCT2::Scripting
             {
                 duk_size_t dataLen{};
                 auto data = duk_get_buffer_data(ctx, -1, &dataLen);
-                auto numElements = dataLen / sizeof(TileElement);
-                if (numElements == 0)
-                {
-                    map_set_tile_element(TileCoordsXY(_coords), nullptr);
-                }
-                else
-                {
-                    auto first = GetFirstElement();
-                    auto currentNumElements = GetNumElements(first);
-                    if (numElements > currentNumElements)
-                    {
-                        // Allocate space for the extra tile elements (inefficient but works)
-                        auto pos = TileCoordsXYZ(TileCoordsXY(_coords), 0).ToCoordsXYZ();
-                        auto numToInsert = numElements - currentNumElements;
-                        for (size_t i = 0; i < numToInsert; i++)
-                        {
-                            tile_element_insert(pos, 0);
-                        }
-
-                        // Copy data to element span
-                        first = map_get_first_element_at(_coords);
-                        currentNumElements = GetNumElements(first);
-                        if (currentNumElements != 0)
-                        {
-                            std::memcpy(first, data, currentNumElements * sizeof(TileElement));
-                            // Safely force last tile flag for last element to avoid read overrun
-                            first[numElements - 1].SetLastForTile(true);
-                        }
-                    }
-                    else
-                    {
-                        std::memcpy(first, data, numElements * sizeof(TileElement));
-                        // Safely force last tile flag for last element to avoid read overrun
-                        first[numElements - 1].SetLastForTile(true);
-                    }
-                }
+                std::vector<TileElement> elements(dataLen / sizeof(TileElement));
+                std::memcpy(elements.data(), data, elements.size() * sizeof(TileElement));
+                map_set_tile_elements(TileCoordsXY(_coords), elements.data(), elements.size());
                 map_invalidate_tile_full(_coords);
             }
         }
@@ -1152,7 +1175,7 @@ namespace OpenRCT2::Scripting
             auto first = GetFirstElement();
             if (static_cast<size_t>(index) < GetNumElements(first))
             {
-                return std::make_shared<ScTileElement>(_coords, &first[index]);
+                return std::make_shared<ScTileElement>(_coords, index);
             }
             return {};
         }
@@ -1196,7 +1219,7 @@ namespace OpenRCT2::Scripting
                     }
                     first[origNumElements].SetLastForTile(true);
                     map_invalidate_tile_full(_coords);
-                    result = std::make_shared<ScTileElement>(_coords, &first[index]);
+                    result = std::make_shared<ScTileElement>(_coords, index);
                 }
             }
             else
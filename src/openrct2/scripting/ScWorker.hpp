@@ -0,0 +1,78 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#ifdef ENABLE_SCRIPTING
+
+#    include "Duktape.hpp"
+#    include "ScriptWorker.h"
+
+#    include <memory>
+
+namespace OpenRCT2::Scripting
+{
+    class ScWorker
+    {
+    private:
+        std::shared_ptr<ScriptWorker> _worker;
+
+    public:
+        ScWorker(std::shared_ptr<ScriptWorker> worker)
+            : _worker(worker)
+        {
+        }
+
+    private:
+        DukValue onMessage_get() const
+        {
+            return _worker->GetOnMessage();
+        }
+        void onMessage_set(const DukValue& value)
+        {
+            _worker->SetOnMessage(value);
+        }
+
+        bool isTerminated_get() const
+        {
+            return _worker->IsTerminated();
+        }
+
+        void postMessage(const DukValue& message)
+        {
+            auto ctx = message.context();
+            message.push();
+            ScriptWorkerValue value;
+            std::string error;
+            auto copied = ScriptWorkerValue::FromDuk(ctx, -1, value, error);
+            duk_pop(ctx);
+            if (!copied)
+            {
+                throw DukException() << error;
+            }
+            _worker->QueueMessage(std::move(value));
+        }
+
+        void terminate()
+        {
+            _worker->Terminate();
+        }
+
+    public:
+        static void Register(duk_context* ctx)
+        {
+            dukglue_register_property(ctx, &ScWorker::onMessage_get, &ScWorker::onMessage_set, "onMessage");
+            dukglue_register_property(ctx, &ScWorker::isTerminated_get, nullptr, "isTerminated");
+            dukglue_register_method(ctx, &ScWorker::postMessage, "postMessage");
+            dukglue_register_method(ctx, &ScWorker::terminate, "terminate");
+        }
+    };
+} // namespace OpenRCT2::Scripting
+
+#endif
@@ -35,13 +35,20 @@
 #    include "ScRide.hpp"
 #    include "ScTile.hpp"
 
+#    include <algorithm>
+#    include <cstdlib>
 #    include <iostream>
+#    include <optional>
 #    include <stdexcept>
+#    include <utility>
+#    include <variant>
+#    include <vector>
 
 using namespace OpenRCT2;
 using namespace OpenRCT2::Scripting;
 
 static constexpr int32_t OPENRCT2_PLUGIN_API_VERSION = 1;
+static constexpr int32_t MAX_WORKERS_PER_PLUGIN = 8;
 
 struct ExpressionStringifier final
 {
@@ -345,9 +352,43 @@ public:
     }
 };
 
+static void* DukAlloc(void* udata, duk_size_t size)
+{
+    static_cast<DukHeapData*>(udata)->AllocationCount++;
+    return std::malloc(size);
+}
+
+static void* DukRealloc(void* udata, void* ptr, duk_size_t size)
+{
+    if (size != 0)
+    {
+        static_cast<DukHeapData*>(udata)->AllocationCount++;
+    }
+    return std::realloc(ptr, size);
+}
+
+static void DukFree(void* /*udata*/, void* ptr)
+{
+    std::free(ptr);
+}
+
+#    ifdef DUK_USE_EXEC_TIMEOUT_CHECK
+duk_bool_t openrct2_duk_exec_timeout_check(void* udata)
+{
+    return static_cast<DukHeapData*>(udata)->Interrupted.load(std::memory_order_relaxed);
+}
+#    endif
+
+duk_context* OpenRCT2::Scripting::CreateDukHeap(DukHeapData& data)
+{
+    return duk_create_heap(DukAlloc, DukRealloc, DukFree, &data, nullptr);
+}
+
 DukContext::DukContext()
+    : _heapData(std::make_unique<DukHeapData>())
 {
-    _context = duk_create_heap_default();
+    // Count the allocations so the plugin profiler can attribute them to plugins
+    _context = CreateDukHeap(*_heapData);
     if (_context == nullptr)
     {
         throw std::runtime_error("Unable to initialise duktape context.");
@@ -394,6 +435,7 @@ void ScriptEngine::Initialise()
     ScPeep::Register(ctx);
     ScGuest::Register(ctx);
     ScStaff::Register(ctx);
+    ScWorker::Register(ctx);
 
     dukglue_register_global(ctx, std::make_shared<ScCheats>(), "cheats");
     dukglue_register_global(ctx, std::make_shared<ScConsole>(_console), "console");
@@ -444,6 +486,11 @@ void ScriptEngine::LoadPlugins()
     _pluginsStarted = false;
 }
 
+std::string ScriptEngine::GetBytecodeCacheDirectory() const
+{
+    return Path::Combine(_env.GetDirectoryPath(DIRBASE::CACHE), "plugin_bytecode");
+}
+
 void ScriptEngine::LoadPlugin(const std::string& path)
 {
     auto plugin = std::make_shared<Plugin>(_context, path);
@@ -455,7 +502,7 @@ void ScriptEngine::LoadPlugin(std::shared_ptr<Plugin>& plugin)
     try
     {
         ScriptExecutionInfo::PluginScope scope(_execInfo, plugin, false);
-        plugin->Load();
+        plugin->Load(GetBytecodeCacheDirectory());
 
         auto metadata = plugin->GetMetadata();
         if (metadata.MinApiVersion <= OPENRCT2_PLUGIN_API_VERSION)
@@ -479,6 +526,7 @@ void ScriptEngine::StopPlugin(std::shared_ptr<Plugin> plugin)
     if (plugin->HasStarted())
     {
         RemoveCustomGameActions(plugin);
+        TerminateWorkers(plugin);
         _hookEngine.UnsubscribeAll(plugin);
         for (auto callback : _pluginStoppedSubscriptions)
         {
@@ -527,6 +575,12 @@ void ScriptEngine::AutoReloadPlugins()
         std::lock_guard<std::mutex> guard(_changedPluginFilesMutex);
         for (auto& path : _changedPluginFiles)
         {
+            // The file watcher also reports deleted files, leave those plugins running
+            if (!File::Exists(path))
+            {
+                continue;
+            }
+
             auto findResult = std::find_if(_plugins.begin(), _plugins.end(), [&path](const std::shared_ptr<Plugin>& plugin) {
                 return Path::Equals(path, plugin->GetPath());
             });
@@ -538,7 +592,7 @@ void ScriptEngine::AutoReloadPlugins()
                     StopPlugin(plugin);
 
                     ScriptExecutionInfo::PluginScope scope(_execInfo, plugin, false);
-                    plugin->Load();
+                    plugin->Load(GetBytecodeCacheDirectory());
                     LogPluginInfo(plugin, "Reloaded");
                     plugin->Start();
                 }
@@ -552,6 +606,132 @@ void ScriptEngine::AutoReloadPlugins()
     }
 }
 
+void ScriptEngine::CheckPluginBudgets()
+{
+    auto tickBudgetMs = std::max(0, gConfigPlugin.tick_budget);
+    auto overBudget = _profiler.EndTick(static_cast<uint64_t>(tickBudgetMs) * 1000);
+    for (const auto& pluginName : overBudget)
+    {
+        auto findResult = std::find_if(_plugins.begin(), _plugins.end(), [&pluginName](const std::shared_ptr<Plugin>& plugin) {
+            return plugin->HasStarted() && plugin->GetMetadata().Name == pluginName;
+        });
+        if (findResult == _plugins.end())
+        {
+            continue;
+        }
+
+        auto plugin = *findResult;
+        auto budget = std::to_string(tickBudgetMs) + " ms";
+        // Timings differ between machines, so stopping plugins in a network game would desynchronise it
+        if (gConfigPlugin.stop_plugins_over_budget && network_get_mode() == NETWORK_MODE_NONE)
+        {
+            StopPlugin(plugin);
+            LogPluginInfo(plugin, "Stopped, exceeded the tick budget of " + budget);
+        }
+        else
+        {
+            // Only warn every so often, a slow plugin is likely to be slow on every tick
+            auto ticks = Platform::GetTicks();
+            auto& lastWarningTicks = _pluginBudgetWarningTicks[pluginName];
+            if (lastWarningTicks == 0 || ticks - lastWarningTicks >= 10000)
+            {
+                lastWarningTicks = ticks;
+                LogPluginInfo(plugin, "Exceeded the tick budget of " + budget);
+            }
+        }
+    }
+}
+
+void ScriptEngine::RunBatchedActionHooks()
+{
+    if (_batchedActionEvents.empty())
+    {
+        return;
+    }
+
+    DukStackFrame frame(_context);
+    duk_push_array(_context);
+    for (size_t i = 0; i < _batchedActionEvents.size(); i++)
+    {
+        _batchedActionEvents[i].push();
+        duk_put_prop_index(_context, -2, static_cast<duk_uarridx_t>(i));
+    }
+    auto dukEvents = DukValue::take_from_stack(_context);
+    _batchedActionEvents.clear();
+
+    _hookEngine.Call(HOOK_TYPE::ACTION_EXECUTE_BATCH, dukEvents, false);
+}
+
+void ScriptEngine::ProcessWorkerMessages()
+{
+    // Callbacks can create or terminate workers, so iterate over a copy
+    auto workers = _workers;
+    for (const auto& worker : workers)
+    {
+        const auto& owner = worker->GetOwner();
+        for (const auto& error : worker->TakeErrors())
+        {
+            LogPluginInfo(owner, "Worker error: " + error);
+        }
+        for (const auto& message : worker->TakeMessages())
+        {
+            // Read the callback again each time as the previous call may have changed it
+            auto onMessage = worker->GetOnMessage();
+            if (worker->IsTerminated() || !onMessage.is_function())
+            {
+                break;
+            }
+
+            DukStackFrame frame(_context);
+            message.Push(_context);
+            auto dukMessage = DukValue::take_from_stack(_context);
+            ExecutePluginCall(owner, onMessage, { dukMessage }, false, "worker.message");
+        }
+    }
+
+    RemoveFinishedWorkers();
+}
+
+void ScriptEngine::RemoveFinishedWorkers()
+{
+    _workers.erase(
+        std::remove_if(
+            _workers.begin(), _workers.end(),
+            [](const auto& worker) { return worker->IsTerminated() && !worker->IsRunning(); }),
+        _workers.end());
+}
+
+std::shared_ptr<ScriptWorker> ScriptEngine::CreateWorker(const std::shared_ptr<Plugin>& owner, const std::string& script)
+{
+    // Terminated workers count until their thread has finished, a plugin reloaded from the same file counts as the same.
+    // Scripts can not be interrupted, so this is what keeps a plugin whose workers never return from starting threads
+    // without bound.
+    auto numWorkers = std::count_if(_workers.begin(), _workers.end(), [&owner](const auto& worker) {
+        const auto& workerOwner = worker->GetOwner();
+        return workerOwner == owner || (!owner->GetPath().empty() && workerOwner->GetPath() == owner->GetPath());
+    });
+    if (numWorkers >= MAX_WORKERS_PER_PLUGIN)
+    {
+        return nullptr;
+    }
+
+    auto worker = std::make_shared<ScriptWorker>(owner, script);
+    _workers.push_back(worker);
+    return worker;
+}
+
+void ScriptEngine::TerminateWorkers(const std::shared_ptr<Plugin>& plugin)
+{
+    for (const auto& worker : _workers)
+    {
+        if (worker->GetOwner() == plugin)
+        {
+            worker->Terminate();
+        }
+    }
+    RemoveFinishedWorkers();
+}
+
 void ScriptEngine::UnloadPlugins()
 {
     StopPlugins();
@@ -560,6 +740,12 @@ void ScriptEngine::UnloadPlugins()
         LogPluginInfo(plugin, "Unloaded");
     }
     _plugins.clear();
+    _batchedActionEvents.clear();
+    for (const auto& worker : _workers)
+    {
+        worker->Terminate();
+    }
+    RemoveFinishedWorkers();
     _pluginsLoaded = false;
     _pluginsStarted = false;
 }
@@ -631,6 +817,10 @@ void ScriptEngine::Update()
         }
         else
         {
+            ProcessWorkerMessages();
+            // The batch is flushed at the end of each tick, this picks up the actions executed while the game is paused
+            RunBatchedActionHooks();
+
             auto tick = Platform::GetTicks();
             if (tick - _lastHotReloadCheckTick > 1000)
             {
@@ -643,6 +833,20 @@ void ScriptEngine::Update()
     ProcessREPL();
 }
 
+void ScriptEngine::BeginTick()
+{
+    _profiler.BeginTick();
+}
+
+void ScriptEngine::EndTick()
+{
+    if (_pluginsStarted)
+    {
+        RunBatchedActionHooks();
+        CheckPluginBudgets();
+    }
+}
+
 void ScriptEngine::ProcessREPL()
 {
     while (_evalQueue.size() > 0)
@@ -676,30 +880,36 @@ std::future<void> ScriptEngine::Eval(const std::string& s)
 }
 
 DukValue ScriptEngine::ExecutePluginCall(
-    const std::shared_ptr<Plugin>& plugin, const DukValue& func, const std::vector<DukValue>& args, bool isGameStateMutable)
+    const std::shared_ptr<Plugin>& plugin, const DukValue& func, const std::vector<DukValue>& args, bool isGameStateMutable,
+    std::string_view callType)
 {
     DukStackFrame frame(_context);
+    DukValue dukResult;
     if (func.is_function())
     {
-        ScriptExecutionInfo::PluginScope scope(_execInfo, plugin, isGameStateMutable);
-        func.push();
-        for (const auto& arg : args)
-        {
-            arg.push();
-        }
-        auto result = duk_pcall(_context, static_cast<duk_idx_t>(args.size()));
-        if (result == DUK_EXEC_SUCCESS)
-        {
-            return DukValue::take_from_stack(_context);
-        }
-        else
+        auto profilerScope = _profiler.BeginCall(_context.GetAllocationCount());
         {
-            auto message = duk_safe_to_string(_context, -1);
-            LogPluginInfo(plugin, message);
-            duk_pop(_context);
+            ScriptExecutionInfo::PluginScope scope(_execInfo, plugin, isGameStateMutable);
+            func.push();
+            for (const auto& arg : args)
+            {
+                arg.push();
+            }
+            auto result = duk_pcall(_context, static_cast<duk_idx_t>(args.size()));
+            if (result == DUK_EXEC_SUCCESS)
+            {
+                dukResult = DukValue::take_from_stack(_context);
+            }
+            else
+            {
+                auto message = duk_safe_to_string(_context, -1);
+                LogPluginInfo(plugin, message);
+                duk_pop(_context);
+            }
         }
+        _profiler.EndCall(profilerScope, plugin->GetMetadata().Name, callType, _context.GetAllocationCount());
     }
-    return DukValue();
+    return dukResult;
 }
 
 void ScriptEngine::LogPluginInfo(const std::shared_ptr<Plugin>& plugin, const std::string_view& message)
@@ -740,11 +950,13 @@ std::unique_ptr<GameActionResult> ScriptEngine::QueryOrExecuteCustomGameAction(
         DukValue dukResult;
         if (!isExecute)
         {
-            dukResult = ExecutePluginCall(customAction.Owner, customAction.Query, { *dukArgs }, false);
+            dukResult = ExecutePluginCall(
+                customAction.Owner, customAction.Query, { *dukArgs }, false, "customAction.query");
         }
         else
         {
-            dukResult = ExecutePluginCall(customAction.Owner, customAction.Execute, { *dukArgs }, true);
+            dukResult = ExecutePluginCall(
+                customAction.Owner, customAction.Execute, { *dukArgs }, true, "customAction.execute");
         }
         return DukToGameActionResult(dukResult);
     }
@@ -910,36 +1122,124 @@ public:
     }
 };
 
-class DukFromGameActionParameterVisitor : public GameActionParameterVisitor
+/**
+ * The parameters of a game action, kept so that the args object of a hook event is only created once a plugin reads it.
+ */
+class LazyActionArgs final : public GameActionParameterVisitor
 {
 private:
-    DukObject& _dukObject;
+    std::optional<std::string> _json;
+    std::vector<std::pair<std::string, std::variant<bool, int32_t, std::string>>> _parameters;
 
 public:
-    DukFromGameActionParameterVisitor(DukObject& dukObject)
-        : _dukObject(dukObject)
+    explicit LazyActionArgs(const GameAction& action)
     {
+        if (action.GetType() == GAME_COMMAND_CUSTOM)
+        {
+            _json = static_cast<const CustomAction&>(action).GetJson();
+        }
+        else
+        {
+            const_cast<GameAction&>(action).AcceptParameters(*this);
+        }
     }
 
     void Visit(const std::string_view& name, bool& param) override
     {
-        std::string szName(name);
-        _dukObject.Set(szName.c_str(), param);
+        _parameters.emplace_back(name, param);
     }
 
     void Visit(const std::string_view& name, int32_t& param) override
     {
-        std::string szName(name);
-        _dukObject.Set(szName.c_str(), param);
+        _parameters.emplace_back(name, param);
     }
 
     void Visit(const std::string_view& name, std::string& param) override
     {
-        std::string szName(name);
-        _dukObject.Set(szName.c_str(), param);
+        _parameters.emplace_back(name, param);
+    }
+
+    DukValue ToDuk(duk_context* ctx) const
+    {
+        if (_json)
+        {
+            auto dukArgs = DuktapeTryParseJson(ctx, *_json);
+            if (dukArgs)
+            {
+                return *dukArgs;
+            }
+        }
+
+        DukObject args(ctx);
+        for (const auto& [name, value] : _parameters)
+        {
+            std::visit([&args, &name = name](const auto& v) { args.Set(name.c_str(), v); }, value);
+        }
+        return args.Take();
     }
 };
 
+static duk_ret_t GetLazyActionArgs(duk_context* ctx)
+{
+    duk_push_this(ctx);
+    duk_get_prop_string(ctx, -1, DUK_HIDDEN_SYMBOL("lazyArgs"));
+    auto lazyArgs = static_cast<LazyActionArgs*>(duk_get_pointer(ctx, -1));
+    duk_pop(ctx);
+
+    DukValue args;
+    if (lazyArgs != nullptr)
+    {
+        args = lazyArgs->ToDuk(ctx);
+        delete lazyArgs;
+        duk_push_pointer(ctx, nullptr);
+        duk_put_prop_string(ctx, -2, DUK_HIDDEN_SYMBOL("lazyArgs"));
+    }
+    else
+    {
+        DukObject emptyArgs(ctx);
+        args = emptyArgs.Take();
+    }
+
+    // Replace the getter with the created object so it is only created once and can be modified by the plugin
+    duk_push_string(ctx, "args");
+    args.push();
+    duk_def_prop(
+        ctx, -3,
+        DUK_DEFPROP_HAVE_VALUE | DUK_DEFPROP_SET_WRITABLE | DUK_DEFPROP_SET_ENUMERABLE | DUK_DEFPROP_SET_CONFIGURABLE);
+    duk_pop(ctx);
+
+    args.push();
+    return 1;
+}
+
+static duk_ret_t FinaliseLazyActionArgs(duk_context* ctx)
+{
+    duk_get_prop_string(ctx, 0, DUK_HIDDEN_SYMBOL("lazyArgs"));
+    delete static_cast<LazyActionArgs*>(duk_get_pointer(ctx, -1));
+    duk_pop(ctx);
+    duk_push_pointer(ctx, nullptr);
+    duk_put_prop_string(ctx, 0, DUK_HIDDEN_SYMBOL("lazyArgs"));
+    return 0;
+}
+
+/**
+ * Defines the args property of a game action hook event as a getter that creates the args object on first access.
+ */
+static void SetLazyActionArgs(duk_context* ctx, const DukValue& eventArgs, const GameAction& action)
+{
+    eventArgs.push();
+    duk_push_pointer(ctx, new LazyActionArgs(action));
+    duk_put_prop_string(ctx, -2, DUK_HIDDEN_SYMBOL("lazyArgs"));
+
+    duk_push_string(ctx, "args");
+    duk_push_c_function(ctx, GetLazyActionArgs, 0);
+    duk_def_prop(ctx, -3, DUK_DEFPROP_HAVE_GETTER | DUK_DEFPROP_SET_ENUMERABLE | DUK_DEFPROP_SET_CONFIGURABLE);
+
+    duk_push_c_function(ctx, FinaliseLazyActionArgs, 1);
+    duk_set_finalizer(ctx, -2);
+    duk_pop(ctx);
+}
+
 const static std::unordered_map<std::string, uint32_t> ActionNameToType = {
     { "guestsetname", GAME_COMMAND_SET_GUEST_NAME },
     { "parksetname", GAME_COMMAND_SET_PARK_NAME },
@@ -988,26 +1288,17 @@ void ScriptEngine::RunGameActionHooks(const GameAction& action, std::unique_ptr<
     DukStackFrame frame(_context);
 
     auto hookType = isExecute ? HOOK_TYPE::ACTION_EXECUTE : HOOK_TYPE::ACTION_QUERY;
-    if (_hookEngine.HasSubscriptions(hookType))
+    auto hasSubscriptions = _hookEngine.HasSubscriptions(hookType);
+    auto isBatched = isExecute && _hookEngine.HasSubscriptions(HOOK_TYPE::ACTION_EXECUTE_BATCH);
+    if (hasSubscriptions || isBatched)
     {
         DukObject obj(_context);
 
         auto actionId = action.GetType();
         if (action.GetType() == GAME_COMMAND_CUSTOM)
         {
-            auto customAction = static_cast<const CustomAction&>(action);
+            const auto& customAction = static_cast<const CustomAction&>(action);
             obj.Set("action", customAction.GetId());
-
-            auto dukArgs = DuktapeTryParseJson(_context, customAction.GetJson());
-            if (dukArgs)
-            {
-                obj.Set("args", *dukArgs);
-            }
-            else
-            {
-                DukObject args(_context);
-                obj.Set("args", args.Take());
-            }
         }
         else
         {
@@ -1016,11 +1307,6 @@ void ScriptEngine::RunGameActionHooks(const GameAction& action, std::unique_ptr<
             {
                 obj.Set("action", actionName);
             }
-
-            DukObject args(_context);
-            DukFromGameActionParameterVisitor visitor(args);
-            const_cast<GameAction&>(action).AcceptParameters(visitor);
-            obj.Set("args", args.Take());
         }
 
         obj.Set("player", action.GetPlayer());
@@ -1032,7 +1318,17 @@ void ScriptEngine::RunGameActionHooks(const GameAction& action, std::unique_ptr<
         obj.Set("result", GameActionResultToDuk(action, result));
         auto dukEventArgs = obj.Take();
 
-        _hookEngine.Call(hookType, dukEventArgs, false);
+        // The args are often not read by any of the subscribers, only create them when they are
+        SetLazyActionArgs(_context, dukEventArgs, action);
+
+        if (hasSubscriptions)
+        {
+            _hookEngine.Call(hookType, dukEventArgs, false);
+        }
+        if (isBatched)
+        {
+            _batchedActionEvents.push_back(dukEventArgs);
+        }
 
         if (!isExecute)
         {
@@ -17,6 +17,8 @@
 #    include "../world/Location.hpp"
 #    include "HookEngine.h"
 #    include "Plugin.h"
+#    include "PluginProfiler.h"
+#    include "ScriptWorker.h"
 
 #    include <future>
 #    include <memory>
@@ -86,12 +88,14 @@ namespace OpenRCT2::Scripting
     {
     private:
         duk_context* _context{};
+        std::unique_ptr<DukHeapData> _heapData;
 
     public:
         DukContext();
         DukContext(DukContext&) = delete;
         DukContext(DukContext&& src) noexcept
             : _context(std::move(src._context))
+            , _heapData(std::move(src._heapData))
         {
             src._context = {};
         }
@@ -101,6 +105,12 @@ namespace OpenRCT2::Scripting
         {
             return _context;
         }
+
+        // Number of allocations made by the heap since it was created
+        uint64_t GetAllocationCount() const
+        {
+            return _heapData->AllocationCount;
+        }
     };
 
     class ScriptEngine
@@ -117,6 +127,8 @@ namespace OpenRCT2::Scripting
         uint32_t _lastHotReloadCheckTick{};
         HookEngine _hookEngine;
         ScriptExecutionInfo _execInfo;
+        PluginProfiler _profiler;
+        std::unordered_map<std::string, uint32_t> _pluginBudgetWarningTicks;
         DukValue _sharedStorage;
 
         std::unique_ptr<FileWatcher> _pluginFileWatcher;
@@ -134,6 +146,11 @@ namespace OpenRCT2::Scripting
 
         std::unordered_map<std::string, CustomActionInfo> _customActions;
 
+        // Events of the actions executed since the action.execute.batch hook was last called
+        std::vector<DukValue> _batchedActionEvents;
+
+        std::vector<std::shared_ptr<ScriptWorker>> _workers;
+
     public:
         ScriptEngine(InteractiveConsole& console, IPlatformEnvironment& env);
         ScriptEngine(ScriptEngine&) = delete;
@@ -158,14 +175,24 @@ namespace OpenRCT2::Scripting
         {
             return _plugins;
         }
+        PluginProfiler& GetProfiler()
+        {
+            return _profiler;
+        }
 
         void LoadPlugins();
         void UnloadPlugins();
         void Update();
+        /**
+         * Called at the start and end of each game tick, so that batched action hooks are run and plugins are held to
+         * the tick budget once per tick however many ticks are run in a frame.
+         */
+        void BeginTick();
+        void EndTick();
         std::future<void> Eval(const std::string& s);
         DukValue ExecutePluginCall(
             const std::shared_ptr<Plugin>& plugin, const DukValue& func, const std::vector<DukValue>& args,
-            bool isGameStateMutable);
+            bool isGameStateMutable, std::string_view callType = "callback");
 
         void LogPluginInfo(const std::shared_ptr<Plugin>& plugin, const std::string_view& message);
 
@@ -176,6 +203,11 @@ namespace OpenRCT2::Scripting
 
         void AddNetworkPlugin(const std::string_view& code);
 
+        /**
+         * Starts a worker owned by the given plugin, returns nullptr if the plugin has too many workers running.
+         */
+        std::shared_ptr<ScriptWorker> CreateWorker(const std::shared_ptr<Plugin>& owner, const std::string& script);
+
         std::unique_ptr<GameActionResult> QueryOrExecuteCustomGameAction(
             const std::string_view& id, const std::string_view& args, bool isExecute);
         bool RegisterCustomAction(
@@ -193,10 +225,16 @@ namespace OpenRCT2::Scripting
         void LoadPlugin(const std::string& path);
         void LoadPlugin(std::shared_ptr<Plugin>& plugin);
         void StopPlugin(std::shared_ptr<Plugin> plugin);
+        std::string GetBytecodeCacheDirectory() const;
         bool ShouldLoadScript(const std::string& path);
         bool ShouldStartPlugin(const std::shared_ptr<Plugin>& plugin);
         void SetupHotReloading();
         void AutoReloadPlugins();
+        void CheckPluginBudgets();
+        void RunBatchedActionHooks();
+        void ProcessWorkerMessages();
+        void RemoveFinishedWorkers();
+        void TerminateWorkers(const std::shared_ptr<Plugin>& plugin);
         void ProcessREPL();
         void RemoveCustomGameActions(const std::shared_ptr<Plugin>& plugin);
         std::unique_ptr<GameActionResult> DukToGameActionResult(const DukValue& d);
@@ -0,0 +1,392 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifdef ENABLE_SCRIPTING
+
+#    include "ScriptWorker.h"
+
+#    include <algorithm>
+#    include <thread>
+
+using namespace OpenRCT2::Scripting;
+
+constexpr int32_t MAX_WORKER_VALUE_DEPTH = 64;
+constexpr const char* STASH_WORKER_STATE = "workerState";
+
+static duk_uint_t GetBufferObjectFlags(std::string_view name)
+{
+    if (name == "ArrayBuffer")
+        return DUK_BUFOBJ_ARRAYBUFFER;
+    if (name == "DataView")
+        return DUK_BUFOBJ_DATAVIEW;
+    if (name == "Int8Array")
+        return DUK_BUFOBJ_INT8ARRAY;
+    if (name == "Uint8ClampedArray")
+        return DUK_BUFOBJ_UINT8CLAMPEDARRAY;
+    if (name == "Int16Array")
+        return DUK_BUFOBJ_INT16ARRAY;
+    if (name == "Uint16Array")
+        return DUK_BUFOBJ_UINT16ARRAY;
+    if (name == "Int32Array")
+        return DUK_BUFOBJ_INT32ARRAY;
+    if (name == "Uint32Array")
+        return DUK_BUFOBJ_UINT32ARRAY;
+    if (name == "Float32Array")
+        return DUK_BUFOBJ_FLOAT32ARRAY;
+    if (name == "Float64Array")
+        return DUK_BUFOBJ_FLOAT64ARRAY;
+    return DUK_BUFOBJ_UINT8ARRAY;
+}
+
+static std::string GetBufferObjectName(duk_context* ctx, duk_idx_t idx)
+{
+    std::string name = "Uint8Array";
+    if (duk_is_object(ctx, idx))
+    {
+        duk_get_prop_string(ctx, idx, "constructor");
+        if (duk_is_object(ctx, -1))
+        {
+            duk_get_prop_string(ctx, -1, "name");
+            if (duk_is_string(ctx, -1))
+            {
+                name = duk_get_string(ctx, -1);
+            }
+            duk_pop(ctx);
+        }
+        duk_pop(ctx);
+    }
+    return name;
+}
+
+static bool CopyFromDuk(duk_context* ctx, duk_idx_t idx, ScriptWorkerValue& result, std::string& error, int32_t depth)
+{
+    using Type = ScriptWorkerValue::Type;
+
+    if (depth > MAX_WORKER_VALUE_DEPTH)
+    {
+        error = "Message is nested too deeply or contains a cycle.";
+        return false;
+    }
+
+    idx = duk_normalize_index(ctx, idx);
+    switch (duk_get_type(ctx, idx))
+    {
+        case DUK_TYPE_UNDEFINED:
+            result.Kind = Type::Undefined;
+            return true;
+        case DUK_TYPE_NULL:
+            result.Kind = Type::Null;
+            return true;
+        case DUK_TYPE_BOOLEAN:
+            result.Kind = Type::Boolean;
+            result.Boolean = duk_get_boolean(ctx, idx) != 0;
+            return true;
+        case DUK_TYPE_NUMBER:
+            result.Kind = Type::Number;
+            result.Number = duk_get_number(ctx, idx);
+            return true;
+        case DUK_TYPE_STRING:
+        {
+            duk_size_t length{};
+            auto str = duk_get_lstring(ctx, idx, &length);
+            result.Kind = Type::String;
+            result.String = std::string(str, length);
+            return true;
+        }
+        case DUK_TYPE_BUFFER:
+        case DUK_TYPE_OBJECT:
+            break;
+        default:
+            error = "Message contains a value that can not be copied.";
+            return false;
+    }
+
+    if (duk_is_buffer_data(ctx, idx))
+    {
+        duk_size_t size{};
+        auto data = static_cast<const uint8_t*>(duk_get_buffer_data(ctx, idx, &size));
+        result.Kind = Type::Buffer;
+        result.String = GetBufferObjectName(ctx, idx);
+        result.Data.assign(data, data + size);
+        return true;
+    }
+
+    if (duk_is_function(ctx, idx))
+    {
+        error = "Message can not contain functions.";
+        return false;
+    }
+
+    if (duk_is_array(ctx, idx))
+    {
+        auto length = duk_get_length(ctx, idx);
+        result.Kind = Type::Array;
+        result.Elements.resize(length);
+        for (duk_size_t i = 0; i < length; i++)
+        {
+            duk_get_prop_index(ctx, idx, static_cast<duk_uarridx_t>(i));
+            auto copied = CopyFromDuk(ctx, -1, result.Elements[i], error, depth + 1);
+            duk_pop(ctx);
+            if (!copied)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    result.Kind = Type::Object;
+    duk_enum(ctx, idx, DUK_ENUM_OWN_PROPERTIES_ONLY);
+    while (duk_next(ctx, -1, 1))
+    {
+        result.Keys.emplace_back(duk_safe_to_string(ctx, -2));
+        auto& element = result.Elements.emplace_back();
+        auto copied = CopyFromDuk(ctx, -1, element, error, depth + 1);
+        duk_pop_2(ctx);
+        if (!copied)
+        {
+            duk_pop(ctx);
+            return false;
+        }
+    }
+    duk_pop(ctx);
+    return true;
+}
+
+bool ScriptWorkerValue::FromDuk(duk_context* ctx, duk_idx_t idx, ScriptWorkerValue& result, std::string& error)
+{
+    result = {};
+    return CopyFromDuk(ctx, idx, result, error, 0);
+}
+
+void ScriptWorkerValue::Push(duk_context* ctx) const
+{
+    switch (Kind)
+    {
+        case Type::Undefined:
+            duk_push_undefined(ctx);
+            break;
+        case Type::Null:
+            duk_push_null(ctx);
+            break;
+        case Type::Boolean:
+            duk_push_boolean(ctx, Boolean);
+            break;
+        case Type::Number:
+            duk_push_number(ctx, Number);
+            break;
+        case Type::String:
+            duk_push_lstring(ctx, String.data(), String.size());
+            break;
+        case Type::Array:
+            duk_push_array(ctx);
+            for (size_t i = 0; i < Elements.size(); i++)
+            {
+                Elements[i].Push(ctx);
+                duk_put_prop_index(ctx, -2, static_cast<duk_uarridx_t>(i));
+            }
+            break;
+        case Type::Object:
+            duk_push_object(ctx);
+            for (size_t i = 0; i < Elements.size(); i++)
+            {
+                Elements[i].Push(ctx);
+                duk_put_prop_lstring(ctx, -2, Keys[i].data(), Keys[i].size());
+            }
+            break;
+        case Type::Buffer:
+        {
+            auto buffer = static_cast<uint8_t*>(duk_push_fixed_buffer(ctx, Data.size()));
+            std::copy(Data.begin(), Data.end(), buffer);
+            duk_push_buffer_object(ctx, -1, 0, Data.size(), GetBufferObjectFlags(String));
+            duk_remove(ctx, -2);
+            break;
+        }
+    }
+}
+
+ScriptWorker::ScriptWorker(std::shared_ptr<Plugin> owner, std::string script)
+    : _owner(owner)
+    , _state(std::make_shared<SharedState>())
+{
+    // The thread only shares the state with us, so it can finish on its own after the worker has been terminated
+    std::thread(Run, _state, std::move(script)).detach();
+}
+
+ScriptWorker::~ScriptWorker()
+{
+    Terminate();
+}
+
+bool ScriptWorker::IsTerminated() const
+{
+    std::lock_guard<std::mutex> lock(_state->Mutex);
+    return _state->IsTerminated;
+}
+
+bool ScriptWorker::IsRunning() const
+{
+    std::lock_guard<std::mutex> lock(_state->Mutex);
+    return _state->IsRunning;
+}
+
+void ScriptWorker::QueueMessage(ScriptWorkerValue&& message)
+{
+    {
+        std::lock_guard<std::mutex> lock(_state->Mutex);
+        if (_state->IsTerminated)
+        {
+            return;
+        }
+        _state->Inbox.push_back(std::move(message));
+    }
+    _state->Condition.notify_one();
+}
+
+void ScriptWorker::Terminate()
+{
+    {
+        std::lock_guard<std::mutex> lock(_state->Mutex);
+        _state->IsTerminated = true;
+        _state->Inbox.clear();
+        _state->Outbox.clear();
+    }
+    _state->HeapData.Interrupted = true;
+    _state->Condition.notify_all();
+
+    // Drop the reference to the callback so that it does not outlive the plugin
+    _onMessage = DukValue();
+}
+
+std::vector<ScriptWorkerValue> ScriptWorker::TakeMessages()
+{
+    std::lock_guard<std::mutex> lock(_state->Mutex);
+    std::vector<ScriptWorkerValue> messages(
+        std::make_move_iterator(_state->Outbox.begin()), std::make_move_iterator(_state->Outbox.end()));
+    _state->Outbox.clear();
+    return messages;
+}
+
+std::vector<std::string> ScriptWorker::TakeErrors()
+{
+    std::lock_guard<std::mutex> lock(_state->Mutex);
+    std::vector<std::string> errors;
+    errors.swap(_state->Errors);
+    return errors;
+}
+
+void ScriptWorker::ReportError(SharedState& state, std::string_view message)
+{
+    // Errors raised by stopping a terminated script are of no interest
+    std::lock_guard<std::mutex> lock(state.Mutex);
+    if (!state.IsTerminated)
+    {
+        state.Errors.emplace_back(message);
+    }
+}
+
+void ScriptWorker::Run(std::shared_ptr<SharedState> state, std::string script)
+{
+    RunScript(*state, script);
+
+    std::lock_guard<std::mutex> lock(state->Mutex);
+    state->IsRunning = false;
+}
+
+void ScriptWorker::RunScript(SharedState& state, const std::string& script)
+{
+    auto ctx = CreateDukHeap(state.HeapData);
+    if (ctx == nullptr)
+    {
+        ReportError(state, "Unable to create worker context.");
+        return;
+    }
+
+    duk_push_global_stash(ctx);
+    duk_push_pointer(ctx, &state);
+    duk_put_prop_string(ctx, -2, STASH_WORKER_STATE);
+    duk_pop(ctx);
+
+    duk_push_c_function(ctx, PostMessageFromWorker, 1);
+    duk_put_global_string(ctx, "postMessage");
+
+    if (duk_peval_lstring(ctx, script.data(), script.size()) != DUK_EXEC_SUCCESS)
+    {
+        ReportError(state, duk_safe_to_string(ctx, -1));
+    }
+    duk_pop(ctx);
+
+    while (true)
+    {
+        ScriptWorkerValue message;
+        {
+            std::unique_lock<std::mutex> lock(state.Mutex);
+            state.Condition.wait(lock, [&state]() { return state.IsTerminated || !state.Inbox.empty(); });
+            if (state.IsTerminated)
+            {
+                break;
+            }
+            message = std::move(state.Inbox.front());
+            state.Inbox.pop_front();
+        }
+
+        duk_get_global_string(ctx, "onMessage");
+        if (duk_is_function(ctx, -1))
+        {
+            message.Push(ctx);
+            if (duk_pcall(ctx, 1) != DUK_EXEC_SUCCESS)
+            {
+                ReportError(state, duk_safe_to_string(ctx, -1));
+            }
+        }
+        duk_pop(ctx);
+    }
+
+    duk_destroy_heap(ctx);
+}
+
+duk_ret_t ScriptWorker::PostMessageFromWorker(duk_context* ctx)
+{
+    duk_push_global_stash(ctx);
+    duk_get_prop_string(ctx, -1, STASH_WORKER_STATE);
+    auto state = static_cast<SharedState*>(duk_get_pointer(ctx, -1));
+    duk_pop_2(ctx);
+
+    // Keep the C++ objects scoped so that they are destroyed before the error is thrown
+    bool posted{};
+    {
+        ScriptWorkerValue message;
+        std::string error;
+        if (ScriptWorkerValue::FromDuk(ctx, 0, message, error))
+        {
+            std::lock_guard<std::mutex> lock(state->Mutex);
+            if (state->IsTerminated)
+            {
+                // Unwind the script so that the thread can finish
+                error = "Worker has been terminated.";
+            }
+            else
+            {
+                state->Outbox.push_back(std::move(message));
+                posted = true;
+            }
+        }
+        if (!posted)
+        {
+            duk_push_error_object(ctx, DUK_ERR_TYPE_ERROR, "%s", error.c_str());
+        }
+    }
+    if (!posted)
+    {
+        return duk_throw(ctx);
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,127 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#ifdef ENABLE_SCRIPTING
+
+#    include "../common.h"
+#    include "Duktape.hpp"
+#    include "Plugin.h"
+
+#    include <condition_variable>
+#    include <deque>
+#    include <memory>
+#    include <mutex>
+#    include <string>
+#    include <string_view>
+#    include <vector>
+
+namespace OpenRCT2::Scripting
+{
+    /**
+     * A copy of a JavaScript value that can be moved between Duktape heaps. Only undefined, null, booleans, numbers,
+     * strings, arrays, plain objects and buffers such as typed arrays can be copied.
+     */
+    struct ScriptWorkerValue
+    {
+        enum class Type : uint8_t
+        {
+            Undefined,
+            Null,
+            Boolean,
+            Number,
+            String,
+            Array,
+            Object,
+            Buffer,
+        };
+
+        Type Kind{};
+        bool Boolean{};
+        double Number{};
+        // The string value, or for buffers the name of the typed array
+        std::string String;
+        std::vector<uint8_t> Data;
+        // Array elements or object property values, Keys holds the property names for objects
+        std::vector<std::string> Keys;
+        std::vector<ScriptWorkerValue> Elements;
+
+        /**
+         * Copies the value at the given stack index. Returns false and sets the error if the value can not be copied.
+         */
+        static bool FromDuk(duk_context* ctx, duk_idx_t idx, ScriptWorkerValue& result, std::string& error);
+        void Push(duk_context* ctx) const;
+    };
+
+    /**
+     * Runs a script in its own Duktape heap on a background thread. The script has no access to the game, it can only
+     * exchange messages with the plugin that created it through postMessage and onMessage. A terminated worker stops
+     * once its script returns or at its next call to postMessage, until then IsRunning stays true. The bundled Duktape is
+     * not built with DUK_USE_EXEC_TIMEOUT_CHECK, so a script that never returns can not be interrupted and keeps its
+     * thread until the game exits.
+     */
+    class ScriptWorker
+    {
+    private:
+        struct SharedState
+        {
+            std::mutex Mutex;
+            std::condition_variable Condition;
+            std::deque<ScriptWorkerValue> Inbox;
+            std::deque<ScriptWorkerValue> Outbox;
+            std::vector<std::string> Errors;
+            bool IsTerminated{};
+            // Cleared once the thread has destroyed the heap and is about to exit
+            bool IsRunning = true;
+            DukHeapData HeapData;
+        };
+
+        std::shared_ptr<Plugin> _owner;
+        std::shared_ptr<SharedState> _state;
+        DukValue _onMessage;
+
+    public:
+        ScriptWorker(std::shared_ptr<Plugin> owner, std::string script);
+        ScriptWorker(const ScriptWorker&) = delete;
+        ~ScriptWorker();
+
+        const std::shared_ptr<Plugin>& GetOwner() const
+        {
+            return _owner;
+        }
+        const DukValue& GetOnMessage() const
+        {
+            return _onMessage;
+        }
+        void SetOnMessage(const DukValue& value)
+        {
+            if (!IsTerminated())
+            {
+                _onMessage = value;
+            }
+        }
+
+        bool IsTerminated() const;
+        bool IsRunning() const;
+        void QueueMessage(ScriptWorkerValue&& message);
+        void Terminate();
+
+        std::vector<ScriptWorkerValue> TakeMessages();
+        std::vector<std::string> TakeErrors();
+
+    private:
+        static void Run(std::shared_ptr<SharedState> state, std::string script);
+        static void RunScript(SharedState& state, const std::string& script);
+        static duk_ret_t PostMessageFromWorker(duk_context* ctx);
+        static void ReportError(SharedState& state, std::string_view message);
+    };
+} // namespace OpenRCT2::Scripting
+
+#endif
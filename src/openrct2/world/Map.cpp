@@ -56,8 +56,11 @@
 #include "Wall.h"
 
 #include <algorithm>
+#include <array>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <unordered_map>
 
 using namespace OpenRCT2;
 
@@ -99,12 +102,10 @@ int16_t gMapSize;
 int16_t gMapSizeMaxXY;
 int16_t gMapBaseZ;
 
-TileElement gTileElements[MAX_TILE_ELEMENTS_WITH_SPARE_ROOM];
 TileElement* gTileElementTilePointers[MAX_TILE_TILE_ELEMENT_POINTERS];
 std::vector<CoordsXY> gMapSelectionTiles;
 std::vector<PeepSpawn> gPeepSpawns;
 
-TileElement* gNextFreeTileElement;
 uint32_t gNextFreeTileElementPointerIndex;
 
 bool gLandMountainMode;
@@ -142,14 +143,14 @@ int32_t tile_element_iterator_next(tile_element_iterator* it)
         return 1;
     }
 
-    if (it->x < (MAXIMUM_MAP_SIZE_TECHNICAL - 1))
+    if (it->x < (gMapSize - 1))
     {
         it->x++;
         it->element = map_get_first_element_at(TileCoordsXY{ it->x, it->y }.ToCoordsXY());
         return 1;
     }
 
-    if (it->y < (MAXIMUM_MAP_SIZE_TECHNICAL - 1))
+    if (it->y < (gMapSize - 1))
     {
         it->x = 0;
         it->y++;
@@ -165,6 +166,492 @@ void tile_element_iterator_restart_for_tile(tile_element_iterator* it)
     it->element = nullptr;
 }
 
+// Tile elements are allocated in chunks that never move, each tile owns a contiguous run within one chunk. Run
+// capacities are powers of two so that a run released by one tile can be reused by any other tile that needs the
+// same capacity. Inserting an element only relocates the run of that tile, so the map never needs a full
+// reorganise. Runs left oversized by removals and sparse chunks are compacted a few tiles at a time every tick.
+static constexpr size_t TILE_ELEMENT_CHUNK_SIZE = 0x10000;
+static constexpr uint8_t TILE_ELEMENT_RUN_CLASS_COUNT = 16;
+// A full compaction pass over all tiles takes 64 ticks
+static constexpr size_t TILE_ELEMENT_COMPACT_TILES_PER_TICK = 1024;
+static constexpr size_t TILE_ELEMENT_COMPACT_RELOCATIONS_PER_TICK = 64;
+
+static std::vector<std::unique_ptr<TileElement[]>> _tileElementChunks;
+// Number of elements in each chunk that belong to runs owned by a tile or waiting to be recycled
+static std::vector<size_t> _tileElementChunkLive;
+// Index of the tile that each slot of a chunk was last handed out to, so that an element can be traced back to its
+// tile
+static std::vector<std::unique_ptr<uint16_t[]>> _tileElementChunkOwners;
+static_assert(MAX_TILE_TILE_ELEMENT_POINTERS <= UINT16_MAX + 1);
+static size_t _tileElementChunkUsed;
+static std::vector<TileElement*> _tileElementFreeRuns[TILE_ELEMENT_RUN_CLASS_COUNT];
+// Runs released since the last recycle, stale pointers into these may still be in use until then
+static std::vector<std::pair<TileElement*, uint8_t>> _tileElementReleasedRuns;
+static uint8_t _tileElementRunClass[MAX_TILE_TILE_ELEMENT_POINTERS];
+static uint32_t _tileElementCount;
+// Tiles showing elements that are not in the storage, see map_substitute_tile_elements
+static std::vector<std::pair<size_t, TileElement*>> _tileElementSubstitutions;
+// tile_element_type_flag of every element type that may be on each tile. Tiles that had an element inserted since
+// the last recycle have all flags set as the type of the new element is not known yet. Removals leave flags set
+// until the compactor next visits the tile, so the flags are a superset of what is on the tile.
+static uint16_t _tileElementTypeFlags[MAX_TILE_TILE_ELEMENT_POINTERS];
+static std::vector<uint32_t> _tileElementTypeFlagsDirty;
+// Incremented whenever the run of a tile moves, an element is removed or its elements are edited in place, see
+// map_mark_tile_elements_changed. Edits are always followed by an invalidation so that the tile is redrawn, so
+// invalidating a tile counts as an edit as well. map_invalidate_tile_zoom1 does not, as it is used for animations.
+static uint32_t _tileElementGeneration[MAX_TILE_TILE_ELEMENT_POINTERS];
+// Incremented along with the generation of any tile within each cell of MAP_CELL_SIZE tiles
+static uint32_t _tileElementCellGeneration[MAP_CELL_COUNT_XY * MAP_CELL_COUNT_XY];
+
+// Track elements on each tile by base height, so that track lookups, which vehicles and ride code do many times a
+// tick, do not need to scan the elements of the tile. An entry is only used while its tile has not been moved or
+// edited in place since the entry was built and its elements are still track at that height, so removals are
+// detected without the index having to be told. The index is not locked, so it must only be used from the game thread.
+struct TrackElementIndexEntry
+{
+    uint32_t Generation{};
+    uint8_t Count{};
+    bool Overflow{};
+    std::array<TileElement*, 4> Elements{};
+
+    TileElement* const* begin() const
+    {
+        return Elements.data();
+    }
+    TileElement* const* end() const
+    {
+        return Elements.data() + Count;
+    }
+};
+static constexpr size_t TRACK_ELEMENT_INDEX_MAX_ENTRIES = 0x20000;
+static std::unordered_map<uint32_t, TrackElementIndexEntry> _trackElementIndex;
+// Set on threads that look up track while the game thread is blocked on them, see map_bypass_track_element_index
+static thread_local bool _trackElementIndexBypassed;
+
+// Chunk that the compactor is moving all runs out of so that it can be freed
+static const TileElement* _tileElementEvacuatingChunk;
+static size_t _tileElementCompactCursor;
+static uint32_t _tileElementCompactPasses;
+static uint64_t _tileElementRelocations;
+static uint32_t _tileElementChunksReleased;
+// Chunks emptied by the compactor. Elements and windows may still hold pointers into them from earlier ticks, so
+// they are only freed when the whole storage is cleared on load. Until then they are reused for new chunks.
+static std::vector<std::unique_ptr<TileElement[]>> _tileElementSpareChunks;
+
+static size_t tile_element_find_chunk(const TileElement* run)
+{
+    for (size_t i = 0; i < _tileElementChunks.size(); i++)
+    {
+        auto chunk = _tileElementChunks[i].get();
+        if (run >= chunk && run < chunk + TILE_ELEMENT_CHUNK_SIZE)
+        {
+            return i;
+        }
+    }
+    return SIZE_MAX;
+}
+
+static bool tile_element_is_in_chunk(const TileElement* run, const TileElement* chunk)
+{
+    return chunk != nullptr && run >= chunk && run < chunk + TILE_ELEMENT_CHUNK_SIZE;
+}
+
+static void tile_element_mark_changed(size_t tileIndex)
+{
+    auto cellX = (tileIndex % MAXIMUM_MAP_SIZE_TECHNICAL) / MAP_CELL_SIZE;
+    auto cellY = (tileIndex / MAXIMUM_MAP_SIZE_TECHNICAL) / MAP_CELL_SIZE;
+    _tileElementGeneration[tileIndex]++;
+    _tileElementCellGeneration[cellX + cellY * MAP_CELL_COUNT_XY]++;
+}
+
+static uint16_t tile_element_get_type_flags(const TileElement* tileElement)
+{
+    uint16_t typeFlags = 0;
+    do
+    {
+        typeFlags |= tile_element_type_flag(tileElement->GetType());
+    } while (!(tileElement++)->IsLastForTile());
+    return typeFlags;
+}
+
+static uint8_t tile_element_get_run_class(size_t numElements)
+{
+    uint8_t runClass = 0;
+    while ((static_cast<size_t>(1) << runClass) < numElements)
+    {
+        runClass++;
+    }
+    return runClass;
+}
+
+static TileElement* tile_element_allocate_run(uint8_t runClass)
+{
+    if (runClass >= TILE_ELEMENT_RUN_CLASS_COUNT)
+    {
+        return nullptr;
+    }
+
+    size_t runSize = static_cast<size_t>(1) << runClass;
+    auto& freeRuns = _tileElementFreeRuns[runClass];
+    if (!freeRuns.empty())
+    {
+        auto run = freeRuns.back();
+        freeRuns.pop_back();
+        _tileElementChunkLive[tile_element_find_chunk(run)] += runSize;
+        return run;
+    }
+
+    if (_tileElementChunks.empty() || _tileElementChunkUsed + runSize > TILE_ELEMENT_CHUNK_SIZE)
+    {
+        // Hand out the rest of the current chunk as smaller runs before starting a new one
+        if (!_tileElementChunks.empty())
+        {
+            auto chunk = _tileElementChunks.back().get();
+            for (uint8_t tailClass = runClass; tailClass-- > 0;)
+            {
+                size_t tailSize = static_cast<size_t>(1) << tailClass;
+                if (_tileElementChunkUsed + tailSize <= TILE_ELEMENT_CHUNK_SIZE)
+                {
+                    _tileElementFreeRuns[tailClass].push_back(chunk + _tileElementChunkUsed);
+                    _tileElementChunkUsed += tailSize;
+                }
+            }
+        }
+        if (_tileElementSpareChunks.empty())
+        {
+            _tileElementChunks.push_back(std::make_unique<TileElement[]>(TILE_ELEMENT_CHUNK_SIZE));
+        }
+        else
+        {
+            _tileElementChunks.push_back(std::move(_tileElementSpareChunks.back()));
+            _tileElementSpareChunks.pop_back();
+        }
+        _tileElementChunkLive.push_back(0);
+        _tileElementChunkOwners.push_back(std::make_unique<uint16_t[]>(TILE_ELEMENT_CHUNK_SIZE));
+        _tileElementChunkUsed = 0;
+    }
+
+    auto run = _tileElementChunks.back().get() + _tileElementChunkUsed;
+    _tileElementChunkUsed += runSize;
+    _tileElementChunkLive.back() += runSize;
+    return run;
+}
+
+/**
+ * Makes the given run the elements of the given tile.
+ */
+static void tile_element_set_run(size_t tileIndex, TileElement* run, uint8_t runClass)
+{
+    Guard::Assert(_tileElementSubstitutions.empty(), "Tile elements modified while substituted");
+
+    auto chunkIndex = tile_element_find_chunk(run);
+    auto owners = _tileElementChunkOwners[chunkIndex].get() + (run - _tileElementChunks[chunkIndex].get());
+    std::fill_n(owners, static_cast<size_t>(1) << runClass, static_cast<uint16_t>(tileIndex));
+
+    gTileElementTilePointers[tileIndex] = run;
+    _tileElementRunClass[tileIndex] = runClass;
+    tile_element_mark_changed(tileIndex);
+}
+
+static void tile_element_release_run(TileElement* run, uint8_t runClass)
+{
+    if (run != nullptr)
+    {
+        _tileElementReleasedRuns.emplace_back(run, runClass);
+    }
+}
+
+/**
+ * Makes runs released by tile_element_insert available again. Must only be called when no code is holding on to
+ * tile element pointers, e.g. at the start of a tick or before saving.
+ */
+void map_recycle_tile_elements()
+{
+    Guard::Assert(_tileElementSubstitutions.empty(), "Tile elements recycled while substituted");
+
+    for (const auto& [run, runClass] : _tileElementReleasedRuns)
+    {
+        _tileElementChunkLive[tile_element_find_chunk(run)] -= static_cast<size_t>(1) << runClass;
+        if (!tile_element_is_in_chunk(run, _tileElementEvacuatingChunk))
+        {
+            _tileElementFreeRuns[runClass].push_back(run);
+        }
+    }
+    _tileElementReleasedRuns.clear();
+
+    for (auto tileIndex : _tileElementTypeFlagsDirty)
+    {
+        auto tileElement = gTileElementTilePointers[tileIndex];
+        _tileElementTypeFlags[tileIndex] = tileElement != nullptr ? tile_element_get_type_flags(tileElement) : 0;
+    }
+    _tileElementTypeFlagsDirty.clear();
+
+    if (_tileElementEvacuatingChunk != nullptr)
+    {
+        auto chunkIndex = tile_element_find_chunk(_tileElementEvacuatingChunk);
+        if (_tileElementChunkLive[chunkIndex] == 0)
+        {
+            _tileElementSpareChunks.push_back(std::move(_tileElementChunks[chunkIndex]));
+            _tileElementChunks.erase(_tileElementChunks.begin() + chunkIndex);
+            _tileElementChunkLive.erase(_tileElementChunkLive.begin() + chunkIndex);
+            _tileElementChunkOwners.erase(_tileElementChunkOwners.begin() + chunkIndex);
+            _tileElementEvacuatingChunk = nullptr;
+            _tileElementChunksReleased++;
+        }
+    }
+}
+
+/**
+ * Picks the emptiest chunk, other than the one being bump allocated from, to move all runs out of if it is at
+ * most half full. Its free runs are withdrawn so that nothing new gets allocated in it.
+ */
+static void tile_element_begin_evacuation()
+{
+    if (_tileElementChunks.size() < 2)
+        return;
+
+    size_t chunkIndex = 0;
+    for (size_t i = 1; i < _tileElementChunks.size() - 1; i++)
+    {
+        if (_tileElementChunkLive[i] < _tileElementChunkLive[chunkIndex])
+        {
+            chunkIndex = i;
+        }
+    }
+    if (_tileElementChunkLive[chunkIndex] > TILE_ELEMENT_CHUNK_SIZE / 2)
+        return;
+
+    _tileElementEvacuatingChunk = _tileElementChunks[chunkIndex].get();
+    for (auto& freeRuns : _tileElementFreeRuns)
+    {
+        freeRuns.erase(
+            std::remove_if(
+                freeRuns.begin(), freeRuns.end(),
+                [](const TileElement* run) { return tile_element_is_in_chunk(run, _tileElementEvacuatingChunk); }),
+            freeRuns.end());
+    }
+}
+
+/**
+ * Moves the tile to a smaller run if removals have left it using less than a quarter of its run, or out of the
+ * chunk being evacuated. Returns true if the tile was relocated.
+ */
+static bool tile_element_compact_tile(size_t tileIndex)
+{
+    auto tileElement = gTileElementTilePointers[tileIndex];
+    if (tileElement == nullptr)
+        return false;
+
+    _tileElementTypeFlags[tileIndex] = tile_element_get_type_flags(tileElement);
+
+    size_t numElements = 0;
+    do
+    {
+        numElements++;
+    } while (!(tileElement + numElements - 1)->IsLastForTile());
+
+    auto runClass = _tileElementRunClass[tileIndex];
+    auto fittedClass = tile_element_get_run_class(numElements);
+    bool isOversized = runClass > fittedClass + 1;
+    if (!isOversized && !tile_element_is_in_chunk(tileElement, _tileElementEvacuatingChunk))
+        return false;
+
+    auto newRunClass = isOversized ? fittedClass : runClass;
+    auto newTileElement = tile_element_allocate_run(newRunClass);
+    if (newTileElement == nullptr)
+        return false;
+
+    std::copy_n(tileElement, numElements, newTileElement);
+    tile_element_release_run(tileElement, runClass);
+    tile_element_set_run(tileIndex, newTileElement, newRunClass);
+    _tileElementRelocations++;
+    return true;
+}
+
+/**
+ * Relocates a bounded number of tile runs to keep the tile element storage compact. Like map_recycle_tile_elements
+ * this must only be called when no code is in the middle of using tile element pointers. Tile element pointers must
+ * not be kept across ticks or frames, code that needs to refer to an element later keeps its tile and index, as
+ * windows and scripts do, and looks it up again.
+ */
+void map_compact_tile_elements()
+{
+    if (_tileElementEvacuatingChunk == nullptr)
+    {
+        tile_element_begin_evacuation();
+    }
+
+    size_t numRelocations = 0;
+    for (size_t i = 0; i < TILE_ELEMENT_COMPACT_TILES_PER_TICK; i++)
+    {
+        if (numRelocations >= TILE_ELEMENT_COMPACT_RELOCATIONS_PER_TICK)
+            break;
+
+        if (tile_element_compact_tile(_tileElementCompactCursor))
+        {
+            numRelocations++;
+        }
+        if (++_tileElementCompactCursor >= MAX_TILE_TILE_ELEMENT_POINTERS)
+        {
+            _tileElementCompactCursor = 0;
+            _tileElementCompactPasses++;
+        }
+    }
+}
+
+TileElementStorageStats map_get_tile_element_storage_stats()
+{
+    TileElementStorageStats stats{};
+    stats.Chunks = _tileElementChunks.size();
+    stats.Capacity = _tileElementChunks.size() * TILE_ELEMENT_CHUNK_SIZE;
+    if (!_tileElementChunks.empty())
+    {
+        // The end of the chunk being bump allocated from has never been handed out
+        stats.Capacity -= TILE_ELEMENT_CHUNK_SIZE - _tileElementChunkUsed;
+    }
+    for (auto live : _tileElementChunkLive)
+    {
+        stats.Allocated += live;
+    }
+    stats.Used = _tileElementCount;
+    stats.CompactProgress = static_cast<double>(_tileElementCompactCursor) / MAX_TILE_TILE_ELEMENT_POINTERS;
+    stats.CompactPasses = _tileElementCompactPasses;
+    stats.Relocations = _tileElementRelocations;
+    stats.ChunksReleased = _tileElementChunksReleased;
+    stats.SpareChunks = _tileElementSpareChunks.size();
+    stats.IsEvacuatingChunk = _tileElementEvacuatingChunk != nullptr;
+    return stats;
+}
+
+static void map_clear_tile_element_storage()
+{
+    _tileElementChunks.clear();
+    _tileElementSpareChunks.clear();
+    _tileElementChunkLive.clear();
+    _tileElementChunkOwners.clear();
+    _tileElementChunkUsed = 0;
+    for (auto& freeRuns : _tileElementFreeRuns)
+    {
+        freeRuns.clear();
+    }
+    _tileElementReleasedRuns.clear();
+    _tileElementSubstitutions.clear();
+    std::fill(std::begin(gTileElementTilePointers), std::end(gTileElementTilePointers), nullptr);
+    std::fill(std::begin(_tileElementRunClass), std::end(_tileElementRunClass), 0);
+    _tileElementCount = 0;
+    _tileElementEvacuatingChunk = nullptr;
+    _tileElementCompactCursor = 0;
+    std::fill(std::begin(_tileElementTypeFlags), std::end(_tileElementTypeFlags), 0);
+    _tileElementTypeFlagsDirty.clear();
+    for (auto& generation : _tileElementGeneration)
+    {
+        generation++;
+    }
+    for (auto& generation : _tileElementCellGeneration)
+    {
+        generation++;
+    }
+    _trackElementIndex.clear();
+}
+
+/**
+ * Replaces all tile elements with the given list, which holds the elements of every tile in tile pointer order
+ * (x + y * MAXIMUM_MAP_SIZE_TECHNICAL) with the last element of each tile flagged, as in the S4 / S6 formats.
+ */
+void map_load_tile_elements(const std::vector<TileElement>& tileElements)
+{
+    map_clear_tile_element_storage();
+
+    size_t index = 0;
+    for (size_t tileIndex = 0; tileIndex < MAX_TILE_TILE_ELEMENT_POINTERS; tileIndex++)
+    {
+        auto first = index;
+        while (index < tileElements.size() && !tileElements[index++].IsLastForTile())
+            ;
+
+        auto numElements = index - first;
+        auto runClass = tile_element_get_run_class(std::max<size_t>(numElements, 1));
+        auto run = tile_element_allocate_run(runClass);
+        if (run == nullptr)
+        {
+            log_error("Too many elements on tile %zu.", tileIndex);
+            numElements = 0;
+            run = tile_element_allocate_run(0);
+        }
+
+        if (numElements == 0)
+        {
+            // Ran out of element data, give the tile a blank surface
+            run->ClearAs(TILE_ELEMENT_TYPE_SURFACE);
+            run->AsSurface()->SetSlope(TILE_ELEMENT_SLOPE_FLAT);
+            run->AsSurface()->SetSurfaceStyle(TERRAIN_GRASS);
+            run->AsSurface()->SetEdgeStyle(TERRAIN_EDGE_ROCK);
+            run->AsSurface()->SetGrassLength(GRASS_LENGTH_CLEAR_0);
+            run->AsSurface()->SetOwnership(OWNERSHIP_UNOWNED);
+            numElements = 1;
+        }
+        else
+        {
+            std::copy_n(&tileElements[first], numElements, run);
+        }
+        run[numElements - 1].SetLastForTile(true);
+
+        tile_element_set_run(tileIndex, run, runClass);
+        _tileElementTypeFlags[tileIndex] = tile_element_get_type_flags(run);
+        _tileElementCount += static_cast<uint32_t>(numElements);
+    }
+}
+
+/**
+ * Gets a copy of all tile elements in the order expected by map_load_tile_elements.
+ */
+std::vector<TileElement> map_get_tile_elements()
+{
+    std::vector<TileElement> tileElements;
+    tileElements.reserve(_tileElementCount);
+    for (auto tileElement : gTileElementTilePointers)
+    {
+        if (tileElement == nullptr)
+            continue;
+
+        do
+        {
+            tileElements.push_back(*tileElement);
+        } while (!(tileElement++)->IsLastForTile());
+    }
+    return tileElements;
+}
+
+uint32_t map_get_tile_element_count()
+{
+    return _tileElementCount;
+}
+
+MapTileRange map_get_tiles()
+{
+    return MapTileRange(gMapSize);
+}
+
+/**
+ * Gets the tiles within the map size that may contain an element of one of the given types, see
+ * tile_element_type_flag. The tiles are in the same order as tile_element_iterator visits them.
+ */
+std::vector<TileCoordsXY> map_get_tiles_with_elements(uint16_t typeFlags)
+{
+    std::vector<TileCoordsXY> tiles;
+    for (int32_t y = 0; y < gMapSize; y++)
+    {
+        for (int32_t x = 0; x < gMapSize; x++)
+        {
+            if (_tileElementTypeFlags[x + y * MAXIMUM_MAP_SIZE_TECHNICAL] & typeFlags)
+            {
+                tiles.emplace_back(x, y);
+            }
+        }
+    }
+    return tiles;
+}
+
 TileElement* map_get_first_element_at(const CoordsXY& elementPos)
 {
     if (!map_is_location_valid(elementPos))
@@ -203,14 +690,149 @@ TileElement* map_get_nth_element_at(const CoordsXY& coords, int32_t n)
     return nullptr;
 }
 
-void map_set_tile_element(const TileCoordsXY& tilePos, TileElement* elements)
+/**
+ * Replaces the elements of a tile with a copy of the given elements in a new run. The tile is left without elements
+ * if none are given. The last element is flagged as the last for the tile.
+ */
+void map_set_tile_elements(const TileCoordsXY& tilePos, const TileElement* elements, size_t numElements)
 {
     if (!map_is_location_valid(tilePos.ToCoordsXY()))
     {
         log_error("Trying to access element outside of range");
         return;
     }
-    gTileElementTilePointers[tilePos.x + tilePos.y * MAXIMUM_MAP_SIZE_TECHNICAL] = elements;
+
+    auto tileIndex = tilePos.x + tilePos.y * MAXIMUM_MAP_SIZE_TECHNICAL;
+    auto oldRun = gTileElementTilePointers[tileIndex];
+    size_t oldNumElements = 0;
+    if (oldRun != nullptr)
+    {
+        do
+        {
+            oldNumElements++;
+        } while (!oldRun[oldNumElements - 1].IsLastForTile());
+    }
+
+    if (numElements > oldNumElements
+        && !map_check_free_elements_and_reorganise(static_cast<int32_t>(numElements - oldNumElements)))
+    {
+        log_error("Cannot set tile elements");
+        return;
+    }
+
+    TileElement* run = nullptr;
+    uint8_t runClass = 0;
+    if (numElements > 0)
+    {
+        runClass = tile_element_get_run_class(numElements);
+        run = tile_element_allocate_run(runClass);
+        if (run == nullptr)
+        {
+            log_error("Too many elements on tile.");
+            return;
+        }
+        std::copy_n(elements, numElements, run);
+        for (size_t i = 0; i < numElements; i++)
+        {
+            run[i].SetLastForTile(i == numElements - 1);
+        }
+    }
+
+    tile_element_release_run(oldRun, _tileElementRunClass[tileIndex]);
+    _tileElementCount -= static_cast<uint32_t>(oldNumElements);
+    _tileElementCount += static_cast<uint32_t>(numElements);
+    if (run != nullptr)
+    {
+        tile_element_set_run(tileIndex, run, runClass);
+        _tileElementTypeFlags[tileIndex] = tile_element_get_type_flags(run);
+    }
+    else
+    {
+        Guard::Assert(_tileElementSubstitutions.empty(), "Tile elements modified while substituted");
+        gTileElementTilePointers[tileIndex] = nullptr;
+        _tileElementRunClass[tileIndex] = 0;
+        _tileElementTypeFlags[tileIndex] = 0;
+        tile_element_mark_changed(tileIndex);
+    }
+}
+
+/**
+ * Temporarily shows the given elements on a tile instead of its own, for painting previews of things that have not
+ * been built. The elements are not part of the tile element storage, so map_restore_tile_elements must be called
+ * before anything other than painting reads or modifies the map.
+ */
+void map_substitute_tile_elements(const TileCoordsXY& tilePos, TileElement* elements)
+{
+    if (!map_is_location_valid(tilePos.ToCoordsXY()))
+    {
+        log_error("Trying to access element outside of range");
+        return;
+    }
+
+    auto tileIndex = tilePos.x + tilePos.y * MAXIMUM_MAP_SIZE_TECHNICAL;
+    _tileElementSubstitutions.emplace_back(tileIndex, gTileElementTilePointers[tileIndex]);
+    gTileElementTilePointers[tileIndex] = elements;
+    tile_element_mark_changed(tileIndex);
+}
+
+/**
+ * Gives all tiles passed to map_substitute_tile_elements their own elements back.
+ */
+void map_restore_tile_elements()
+{
+    // Restore in reverse so that a tile substituted more than once ends up with its own elements
+    for (auto it = _tileElementSubstitutions.rbegin(); it != _tileElementSubstitutions.rend(); it++)
+    {
+        gTileElementTilePointers[it->first] = it->second;
+        tile_element_mark_changed(it->first);
+    }
+    _tileElementSubstitutions.clear();
+}
+
+/**
+ * Must be called after the elements of a tile have been reordered or had their height or type changed in place, so
+ * that lookups that cache element pointers and map_get_tiles_with_elements see the change.
+ */
+void map_mark_tile_elements_changed(const CoordsXY& loc)
+{
+    if (!map_is_location_valid(loc))
+        return;
+
+    auto tilePos = TileCoordsXY{ loc };
+    auto tileIndex = tilePos.x + tilePos.y * MAXIMUM_MAP_SIZE_TECHNICAL;
+    tile_element_mark_changed(tileIndex);
+
+    // Only add flags, a freshly inserted element may not have been given its type yet
+    auto tileElement = gTileElementTilePointers[tileIndex];
+    if (tileElement != nullptr)
+    {
+        _tileElementTypeFlags[tileIndex] |= tile_element_get_type_flags(tileElement);
+    }
+}
+
+/**
+ * Returns a number that changes whenever the elements of the given tile change, so that results derived from the
+ * elements of a tile can be cached. Returns 0 for locations outside the map.
+ */
+uint32_t map_get_tile_elements_generation(const CoordsXY& loc)
+{
+    if (!map_is_location_valid(loc))
+        return 0;
+
+    auto tilePos = TileCoordsXY{ loc };
+    return _tileElementGeneration[tilePos.x + tilePos.y * MAXIMUM_MAP_SIZE_TECHNICAL];
+}
+
+/**
+ * Like map_get_tile_elements_generation but changes whenever any tile within the given cell of MAP_CELL_SIZE tiles
+ * changes.
+ */
+uint32_t map_get_cell_elements_generation(const TileCoordsXY& cellPos)
+{
+    if (cellPos.x < 0 || cellPos.y < 0 || cellPos.x >= MAP_CELL_COUNT_XY || cellPos.y >= MAP_CELL_COUNT_XY)
+        return 0;
+
+    return _tileElementCellGeneration[cellPos.x + cellPos.y * MAP_CELL_COUNT_XY];
 }
 
 SurfaceElement* map_get_surface_element_at(const CoordsXY& coords)
@@ -287,21 +909,22 @@ void map_init(int32_t size)
 {
     gNextFreeTileElementPointerIndex = 0;
 
-    for (int32_t i = 0; i < MAX_TILE_TILE_ELEMENT_POINTERS; i++)
+    std::vector<TileElement> tileElements(MAX_TILE_TILE_ELEMENT_POINTERS);
+    for (auto& tileElement : tileElements)
     {
-        TileElement* tile_element = &gTileElements[i];
-        tile_element->ClearAs(TILE_ELEMENT_TYPE_SURFACE);
-        tile_element->SetLastForTile(true);
-        tile_element->base_height = 14;
-        tile_element->clearance_height = 14;
-        tile_element->AsSurface()->SetWaterHeight(0);
-        tile_element->AsSurface()->SetSlope(TILE_ELEMENT_SLOPE_FLAT);
-        tile_element->AsSurface()->SetGrassLength(GRASS_LENGTH_CLEAR_0);
-        tile_element->AsSurface()->SetOwnership(OWNERSHIP_UNOWNED);
-        tile_element->AsSurface()->SetParkFences(0);
-        tile_element->AsSurface()->SetSurfaceStyle(TERRAIN_GRASS);
-        tile_element->AsSurface()->SetEdgeStyle(TERRAIN_EDGE_ROCK);
+        tileElement.ClearAs(TILE_ELEMENT_TYPE_SURFACE);
+        tileElement.SetLastForTile(true);
+        tileElement.base_height = 14;
+        tileElement.clearance_height = 14;
+        tileElement.AsSurface()->SetWaterHeight(0);
+        tileElement.AsSurface()->SetSlope(TILE_ELEMENT_SLOPE_FLAT);
+        tileElement.AsSurface()->SetGrassLength(GRASS_LENGTH_CLEAR_0);
+        tileElement.AsSurface()->SetOwnership(OWNERSHIP_UNOWNED);
+        tileElement.AsSurface()->SetParkFences(0);
+        tileElement.AsSurface()->SetSurfaceStyle(TERRAIN_GRASS);
+        tileElement.AsSurface()->SetEdgeStyle(TERRAIN_EDGE_ROCK);
     }
+    map_load_tile_elements(tileElements);
 
     gGrassSceneryTileLoopPosition = 0;
     gWidePathTileLoopX = 0;
@@ -311,7 +934,6 @@ void map_init(int32_t size)
     gMapSize = size;
     gMapSizeMaxXY = size * 32 - 33;
     gMapBaseZ = 7;
-    map_update_tile_pointers();
     map_remove_out_of_range_elements();
     AutoCreateMapAnimations();
 
@@ -329,32 +951,29 @@ void map_count_remaining_land_rights()
     gLandRemainingOwnershipSales = 0;
     gLandRemainingConstructionSales = 0;
 
-    for (int32_t x = 0; x < MAXIMUM_MAP_SIZE_TECHNICAL; x++)
-    {
-        for (int32_t y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL; y++)
+    for (const auto& tilePos : map_get_tiles())
+    {
+        auto* surfaceElement = map_get_surface_element_at(tilePos.ToCoordsXY());
+        // Surface elements are sometimes hacked out to save some space for other map elements
+        if (surfaceElement == nullptr)
+        {
+            continue;
+        }
+
+        uint8_t flags = surfaceElement->GetOwnership();
+
+        // Do not combine this condition with (flags & OWNERSHIP_AVAILABLE)
+        // As some RCT1 parks have owned tiles with the 'construction rights available' flag also set
+        if (!(flags & OWNERSHIP_OWNED))
         {
-            auto* surfaceElement = map_get_surface_element_at(TileCoordsXY{ x, y }.ToCoordsXY());
-            // Surface elements are sometimes hacked out to save some space for other map elements
-            if (surfaceElement == nullptr)
+            if (flags & OWNERSHIP_AVAILABLE)
             {
-                continue;
+                gLandRemainingOwnershipSales++;
             }
-
-            uint8_t flags = surfaceElement->GetOwnership();
-
-            // Do not combine this condition with (flags & OWNERSHIP_AVAILABLE)
-            // As some RCT1 parks have owned tiles with the 'construction rights available' flag also set
-            if (!(flags & OWNERSHIP_OWNED))
+            else if (
+                (flags & OWNERSHIP_CONSTRUCTION_RIGHTS_AVAILABLE) && (flags & OWNERSHIP_CONSTRUCTION_RIGHTS_OWNED) == 0)
             {
-                if (flags & OWNERSHIP_AVAILABLE)
-                {
-                    gLandRemainingOwnershipSales++;
-                }
-                else if (
-                    (flags & OWNERSHIP_CONSTRUCTION_RIGHTS_AVAILABLE) && (flags & OWNERSHIP_CONSTRUCTION_RIGHTS_OWNED) == 0)
-                {
-                    gLandRemainingConstructionSales++;
-                }
+                gLandRemainingConstructionSales++;
             }
         }
     }
@@ -371,38 +990,59 @@ void map_count_remaining_land_rights()
  */
 void map_strip_ghost_flag_from_elements()
 {
-    for (auto& element : gTileElements)
+    for (auto tileElement : gTileElementTilePointers)
     {
-        element.SetGhost(false);
+        if (tileElement == nullptr)
+            continue;
+
+        do
+        {
+            tileElement->SetGhost(false);
+        } while (!(tileElement++)->IsLastForTile());
     }
 }
 
 /**
+ * Removes every element other than the surface from the tiles beyond the map size when importing a park. Whole map
+ * loops such as tile_element_iterator only visit the tiles within the map size, so nothing must be left outside of
+ * it. Surfaces are kept as they are reused when the map is enlarged.
  *
- *  rct2: 0x0068AFFD
+ * This can only exist in hacked parks, as shrinking the map removes these elements.
  */
-void map_update_tile_pointers()
+void map_remove_elements_outside_map()
 {
-    int32_t i, x, y;
-
-    for (i = 0; i < MAX_TILE_TILE_ELEMENT_POINTERS; i++)
-    {
-        gTileElementTilePointers[i] = TILE_UNDEFINED_TILE_ELEMENT;
-    }
-
-    TileElement* tileElement = gTileElements;
-    TileElement** tile = gTileElementTilePointers;
-    for (y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL; y++)
+    std::vector<TileElement> surfaceElements;
+    for (int32_t y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL; y++)
     {
-        for (x = 0; x < MAXIMUM_MAP_SIZE_TECHNICAL; x++)
+        for (int32_t x = 0; x < MAXIMUM_MAP_SIZE_TECHNICAL; x++)
         {
-            *tile++ = tileElement;
-            while (!(tileElement++)->IsLastForTile())
-                ;
+            if (x < gMapSize && y < gMapSize)
+                continue;
+
+            auto tileElement = gTileElementTilePointers[x + y * MAXIMUM_MAP_SIZE_TECHNICAL];
+            if (tileElement == nullptr)
+                continue;
+
+            size_t numElements = 0;
+            surfaceElements.clear();
+            do
+            {
+                numElements++;
+                if (tileElement->GetType() == TILE_ELEMENT_TYPE_SURFACE)
+                {
+                    surfaceElements.push_back(*tileElement);
+                }
+            } while (!(tileElement++)->IsLastForTile());
+
+            if (surfaceElements.size() != numElements)
+            {
+                log_warning(
+                    "Removing %zu elements outside of the map at x = %d and y = %d.", numElements - surfaceElements.size(), x,
+                    y);
+                map_set_tile_elements({ x, y }, surfaceElements.data(), surfaceElements.size());
+            }
         }
     }
-
-    gNextFreeTileElement = tileElement;
 }
 
 /**
@@ -638,11 +1278,11 @@ void map_update_path_wide_flags()
 
         // Next x, y tile
         x += COORDS_XY_STEP;
-        if (x >= MAXIMUM_MAP_SIZE_BIG)
+        if (x >= gMapSize * COORDS_XY_STEP)
         {
             x = 0;
             y += COORDS_XY_STEP;
-            if (y >= MAXIMUM_MAP_SIZE_BIG)
+            if (y >= gMapSize * COORDS_XY_STEP)
             {
                 y = 0;
             }
@@ -943,6 +1583,13 @@ bool map_is_location_at_edge(const CoordsXY& loc)
  */
 void tile_element_remove(TileElement* tileElement)
 {
+    auto chunkIndex = tile_element_find_chunk(tileElement);
+    if (chunkIndex != SIZE_MAX)
+    {
+        auto slot = tileElement - _tileElementChunks[chunkIndex].get();
+        tile_element_mark_changed(_tileElementChunkOwners[chunkIndex][slot]);
+    }
+
     // Replace Nth element by (N+1)th element.
     // This loop will make tileElement point to the old last element position,
     // after copy it to it's new position
@@ -957,11 +1604,7 @@ void tile_element_remove(TileElement* tileElement)
     // Mark the latest element with the last element flag.
     (tileElement - 1)->SetLastForTile(true);
     tileElement->base_height = MAX_ELEMENT_HEIGHT;
-
-    if ((tileElement + 1) == gNextFreeTileElement)
-    {
-        gNextFreeTileElement--;
-    }
+    _tileElementCount--;
 }
 
 /**
@@ -970,32 +1613,51 @@ void tile_element_remove(TileElement* tileElement)
  */
 void map_remove_all_rides()
 {
-    tile_element_iterator it;
-
-    tile_element_iterator_begin(&it);
-    do
+    auto typeFlags = tile_element_type_flag(TILE_ELEMENT_TYPE_PATH) | tile_element_type_flag(TILE_ELEMENT_TYPE_ENTRANCE)
+        | tile_element_type_flag(TILE_ELEMENT_TYPE_TRACK);
+    for (const auto& tilePos : map_get_tiles_with_elements(typeFlags))
     {
-        switch (it.element->GetType())
+        auto loc = tilePos.ToCoordsXY();
+        auto tileElement = map_get_first_element_at(loc);
+        while (tileElement != nullptr)
         {
-            case TILE_ELEMENT_TYPE_PATH:
-                if (it.element->AsPath()->IsQueue())
-                {
-                    it.element->AsPath()->SetHasQueueBanner(false);
-                    it.element->AsPath()->SetRideIndex(RIDE_ID_NULL);
-                }
-                break;
-            case TILE_ELEMENT_TYPE_ENTRANCE:
-                if (it.element->AsEntrance()->GetEntranceType() == ENTRANCE_TYPE_PARK_ENTRANCE)
+            bool removed = false;
+            switch (tileElement->GetType())
+            {
+                case TILE_ELEMENT_TYPE_PATH:
+                    if (tileElement->AsPath()->IsQueue())
+                    {
+                        tileElement->AsPath()->SetHasQueueBanner(false);
+                        tileElement->AsPath()->SetRideIndex(RIDE_ID_NULL);
+                    }
                     break;
-                [[fallthrough]];
-            case TILE_ELEMENT_TYPE_TRACK:
-                footpath_queue_chain_reset();
-                footpath_remove_edges_at(TileCoordsXY{ it.x, it.y }.ToCoordsXY(), it.element);
-                tile_element_remove(it.element);
-                tile_element_iterator_restart_for_tile(&it);
+                case TILE_ELEMENT_TYPE_ENTRANCE:
+                    if (tileElement->AsEntrance()->GetEntranceType() == ENTRANCE_TYPE_PARK_ENTRANCE)
+                        break;
+                    [[fallthrough]];
+                case TILE_ELEMENT_TYPE_TRACK:
+                    footpath_queue_chain_reset();
+                    footpath_remove_edges_at(loc, tileElement);
+                    tile_element_remove(tileElement);
+                    removed = true;
+                    break;
+            }
+
+            if (removed)
+            {
+                // Start the tile over as the remaining elements have moved down
+                tileElement = map_get_first_element_at(loc);
+            }
+            else if (tileElement->IsLastForTile())
+            {
                 break;
+            }
+            else
+            {
+                tileElement++;
+            }
         }
-    } while (tile_element_iterator_next(&it));
+    }
 }
 
 /**
@@ -1070,74 +1732,27 @@ void map_invalidate_selection_rect()
 }
 
 /**
- *
+ * Tile elements no longer need defragmenting as each tile owns its own run, this only makes released runs
+ * available again.
  *  rct2: 0x0068B111
  */
 void map_reorganise_elements()
 {
-    context_setcurrentcursor(CURSOR_ZZZ);
-
-    auto newTileElements = std::make_unique<TileElement[]>(MAX_TILE_ELEMENTS_WITH_SPARE_ROOM);
-    TileElement* newElementsPtr = newTileElements.get();
-
-    if (newTileElements == nullptr)
-    {
-        log_fatal("Unable to allocate memory for map elements.");
-        return;
-    }
-
-    for (int32_t y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL; y++)
-    {
-        for (int32_t x = 0; x < MAXIMUM_MAP_SIZE_TECHNICAL; x++)
-        {
-            TileElement* startElement = map_get_first_element_at(TileCoordsXY{ x, y }.ToCoordsXY());
-            if (startElement == nullptr)
-                continue;
-            TileElement* endElement = startElement;
-            while (!(endElement++)->IsLastForTile())
-                ;
-
-            const auto numElements = static_cast<uint32_t>(endElement - startElement);
-            std::memcpy(newElementsPtr, startElement, numElements * sizeof(TileElement));
-            newElementsPtr += numElements;
-        }
-    }
-
-    const auto numElements = static_cast<uint32_t>(newElementsPtr - newTileElements.get());
-    std::memcpy(gTileElements, newTileElements.get(), numElements * sizeof(TileElement));
-    std::memset(gTileElements + numElements, 0, (MAX_TILE_ELEMENTS_WITH_SPARE_ROOM - numElements) * sizeof(TileElement));
-
-    map_update_tile_pointers();
+    map_recycle_tile_elements();
 }
 
 /**
  *
  *  rct2: 0x0068B044
  *  Returns true on space available for more elements
- *  Reorganises the map elements to check for space
  */
 bool map_check_free_elements_and_reorganise(int32_t numElements)
 {
-    if (numElements != 0)
+    if (numElements > 0 && _tileElementCount + static_cast<uint32_t>(numElements) > MAX_TILE_ELEMENTS)
     {
-        auto tileElementEnd = &gTileElements[MAX_TILE_ELEMENTS];
-
-        // Check if is there is room for the required number of elements
-        auto newTileElementEnd = gNextFreeTileElement + numElements;
-        if (newTileElementEnd > tileElementEnd)
-        {
-            // Defragment the map element list
-            map_reorganise_elements();
-
-            // Check if there is any room again
-            newTileElementEnd = gNextFreeTileElement + numElements;
-            if (newTileElementEnd > tileElementEnd)
-            {
-                // Not enough spare elements left :'(
-                gGameCommandErrorText = STR_ERR_LANDSCAPE_DATA_AREA_FULL;
-                return false;
-            }
-        }
+        // Not enough spare elements left :'(
+        gGameCommandErrorText = STR_ERR_LANDSCAPE_DATA_AREA_FULL;
+        return false;
     }
     return true;
 }
@@ -1158,11 +1773,36 @@ TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants
         return nullptr;
     }
 
-    newTileElement = gNextFreeTileElement;
-    originalTileElement = gTileElementTilePointers[tileLoc.y * MAXIMUM_MAP_SIZE_TECHNICAL + tileLoc.x];
+    auto tileIndex = tileLoc.y * MAXIMUM_MAP_SIZE_TECHNICAL + tileLoc.x;
+    originalTileElement = gTileElementTilePointers[tileIndex];
+
+    // Move the tile to a run with room for one more element
+    size_t numElements = 1;
+    if (originalTileElement != nullptr)
+    {
+        auto tileElement = originalTileElement;
+        do
+        {
+            numElements++;
+        } while (!(tileElement++)->IsLastForTile());
+    }
+    auto runClass = tile_element_get_run_class(numElements);
+    newTileElement = tile_element_allocate_run(runClass);
+    if (newTileElement == nullptr)
+    {
+        log_error("Cannot insert new element");
+        return nullptr;
+    }
+    tile_element_release_run(originalTileElement, _tileElementRunClass[tileIndex]);
+    _tileElementCount++;
+    if (_tileElementTypeFlags[tileIndex] != UINT16_MAX)
+    {
+        _tileElementTypeFlags[tileIndex] = UINT16_MAX;
+        _tileElementTypeFlagsDirty.push_back(static_cast<uint32_t>(tileIndex));
+    }
 
     // Set tile index pointer to point to new element block
-    gTileElementTilePointers[tileLoc.y * MAXIMUM_MAP_SIZE_TECHNICAL + tileLoc.x] = newTileElement;
+    tile_element_set_run(tileIndex, newTileElement, runClass);
 
     if (originalTileElement == nullptr)
     {
@@ -1214,7 +1854,6 @@ TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants
         } while (!((newTileElement - 1)->IsLastForTile()));
     }
 
-    gNextFreeTileElement = newTileElement;
     return insertedElement;
 }
 
@@ -2044,6 +2683,7 @@ static void map_invalidate_tile_under_zoom(int32_t x, int32_t y, int32_t z0, int
  */
 void map_invalidate_tile(const CoordsXYRangedZ& tilePos)
 {
+    map_mark_tile_elements_changed(tilePos);
     map_invalidate_tile_under_zoom(tilePos.x, tilePos.y, tilePos.baseZ, tilePos.clearanceZ, -1);
 }
 
@@ -2062,6 +2702,7 @@ void map_invalidate_tile_zoom1(const CoordsXYRangedZ& tilePos)
  */
 void map_invalidate_tile_zoom0(const CoordsXYRangedZ& tilePos)
 {
+    map_mark_tile_elements_changed(tilePos);
     map_invalidate_tile_under_zoom(tilePos.x, tilePos.y, tilePos.baseZ, tilePos.clearanceZ, 0);
 }
 
@@ -2182,6 +2823,124 @@ void map_clear_all_elements()
     }
 }
 
+/**
+ * Makes track lookups on the calling thread scan the tiles instead of using the track element index, which is not
+ * locked. Must be set on any thread other than the game thread that looks up track, while the game thread waits.
+ */
+void map_bypass_track_element_index(bool bypass)
+{
+    _trackElementIndexBypassed = bypass;
+}
+
+static bool track_element_index_entry_is_valid(
+    const TrackElementIndexEntry& entry, uint32_t generation, int32_t baseHeight)
+{
+    if (entry.Generation != generation)
+        return false;
+    for (auto tileElement : entry)
+    {
+        if (tileElement->GetType() != TILE_ELEMENT_TYPE_TRACK || tileElement->base_height != baseHeight)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Gets the track elements on the tile with the given base height, in tile order. The entry is returned by value as
+ * later lookups may replace it. If the tile has more track elements at that height than an entry can hold, Overflow
+ * is set and the tile has to be scanned instead.
+ */
+static TrackElementIndexEntry map_get_track_elements_at(int32_t tileIndex, int32_t baseHeight)
+{
+    auto generation = _tileElementGeneration[tileIndex];
+    auto key = static_cast<uint32_t>((tileIndex << 8) | baseHeight);
+    auto it = _trackElementIndex.find(key);
+    if (it != _trackElementIndex.end() && track_element_index_entry_is_valid(it->second, generation, baseHeight))
+        return it->second;
+
+    TrackElementIndexEntry entry;
+    entry.Generation = generation;
+    auto tileElement = gTileElementTilePointers[tileIndex];
+    if (tileElement != nullptr)
+    {
+        do
+        {
+            if (tileElement->GetType() == TILE_ELEMENT_TYPE_TRACK && tileElement->base_height == baseHeight)
+            {
+                if (entry.Count == entry.Elements.size())
+                {
+                    entry.Overflow = true;
+                    break;
+                }
+                entry.Elements[entry.Count++] = tileElement;
+            }
+        } while (!(tileElement++)->IsLastForTile());
+    }
+
+    if (it != _trackElementIndex.end())
+    {
+        it->second = entry;
+    }
+    else
+    {
+        if (_trackElementIndex.size() >= TRACK_ELEMENT_INDEX_MAX_ENTRIES)
+        {
+            _trackElementIndex.clear();
+        }
+        _trackElementIndex.emplace(key, entry);
+    }
+    return entry;
+}
+
+/**
+ * Gets the first track element on the tile with the given base height, in tile order, that matches the predicate.
+ */
+template<typename TPred>
+static TrackElement* map_find_track_element_at(const CoordsXY& tilePos, int32_t baseHeight, TPred&& predicate)
+{
+    if (baseHeight < 0 || baseHeight > std::numeric_limits<uint8_t>::max() || !map_is_location_valid(tilePos))
+        return nullptr;
+
+    auto tileIndex = (tilePos.x / COORDS_XY_STEP) + (tilePos.y / COORDS_XY_STEP) * MAXIMUM_MAP_SIZE_TECHNICAL;
+    if (!_trackElementIndexBypassed)
+    {
+        auto entry = map_get_track_elements_at(tileIndex, baseHeight);
+        if (!entry.Overflow)
+        {
+            for (auto tileElement : entry)
+            {
+                auto trackElement = tileElement->AsTrack();
+                if (predicate(trackElement))
+                    return trackElement;
+            }
+            return nullptr;
+        }
+    }
+
+    auto tileElement = gTileElementTilePointers[tileIndex];
+    if (tileElement != nullptr)
+    {
+        do
+        {
+            if (tileElement->GetType() == TILE_ELEMENT_TYPE_TRACK && tileElement->base_height == baseHeight)
+            {
+                auto trackElement = tileElement->AsTrack();
+                if (predicate(trackElement))
+                    return trackElement;
+            }
+        } while (!(tileElement++)->IsLastForTile());
+    }
+    return nullptr;
+}
+
+template<typename TPred> static TrackElement* map_find_track_element_at(const CoordsXYZ& trackPos, TPred&& predicate)
+{
+    // Lookups by z in big units only match elements exactly at that height, unlike those by base height
+    if (trackPos.z % COORDS_Z_STEP != 0)
+        return nullptr;
+    return map_find_track_element_at(trackPos, trackPos.z / COORDS_Z_STEP, std::forward<TPred>(predicate));
+}
+
 /**
  * Gets the track element at x, y, z.
  * @param x x units, not tiles.
@@ -2190,20 +2949,7 @@ void map_clear_all_elements()
  */
 TrackElement* map_get_track_element_at(const CoordsXYZ& trackPos)
 {
-    TileElement* tileElement = map_get_first_element_at(trackPos);
-    if (tileElement == nullptr)
-        return nullptr;
-    do
-    {
-        if (tileElement->GetType() != TILE_ELEMENT_TYPE_TRACK)
-            continue;
-        if (tileElement->GetBaseZ() != trackPos.z)
-            continue;
-
-        return tileElement->AsTrack();
-    } while (!(tileElement++)->IsLastForTile());
-
-    return nullptr;
+    return map_find_track_element_at(trackPos, [](const TrackElement*) { return true; });
 }
 
 /**
@@ -2214,23 +2960,10 @@ TrackElement* map_get_track_element_at(const CoordsXYZ& trackPos)
  */
 TileElement* map_get_track_element_at_of_type(const CoordsXYZ& trackPos, int32_t trackType)
 {
-    TileElement* tileElement = map_get_first_element_at(trackPos);
-    if (tileElement == nullptr)
-        return nullptr;
-    auto trackTilePos = TileCoordsXYZ{ trackPos };
-    do
-    {
-        if (tileElement->GetType() != TILE_ELEMENT_TYPE_TRACK)
-            continue;
-        if (tileElement->base_height != trackTilePos.z)
-            continue;
-        if (tileElement->AsTrack()->GetTrackType() != trackType)
-            continue;
-
-        return tileElement;
-    } while (!(tileElement++)->IsLastForTile());
-
-    return nullptr;
+    auto trackElement = map_find_track_element_at(
+        trackPos, TileCoordsXYZ{ trackPos }.z,
+        [trackType](const TrackElement* element) { return element->GetTrackType() == trackType; });
+    return reinterpret_cast<TileElement*>(trackElement);
 }
 
 /**
@@ -2241,73 +2974,26 @@ TileElement* map_get_track_element_at_of_type(const CoordsXYZ& trackPos, int32_t
  */
 TileElement* map_get_track_element_at_of_type_seq(const CoordsXYZ& trackPos, int32_t trackType, int32_t sequence)
 {
-    TileElement* tileElement = map_get_first_element_at(trackPos);
-    auto trackTilePos = TileCoordsXYZ{ trackPos };
-    do
-    {
-        if (tileElement == nullptr)
-            break;
-        if (tileElement->GetType() != TILE_ELEMENT_TYPE_TRACK)
-            continue;
-        if (tileElement->base_height != trackTilePos.z)
-            continue;
-        if (tileElement->AsTrack()->GetTrackType() != trackType)
-            continue;
-        if (tileElement->AsTrack()->GetSequenceIndex() != sequence)
-            continue;
-
-        return tileElement;
-    } while (!(tileElement++)->IsLastForTile());
-
-    return nullptr;
+    auto trackElement = map_find_track_element_at(
+        trackPos, TileCoordsXYZ{ trackPos }.z, [trackType, sequence](const TrackElement* element) {
+            return element->GetTrackType() == trackType && element->GetSequenceIndex() == sequence;
+        });
+    return reinterpret_cast<TileElement*>(trackElement);
 }
 
 TrackElement* map_get_track_element_at_of_type(const CoordsXYZD& location, int32_t trackType)
 {
-    auto tileElement = map_get_first_element_at(location);
-    if (tileElement != nullptr)
-    {
-        do
-        {
-            auto trackElement = tileElement->AsTrack();
-            if (trackElement != nullptr)
-            {
-                if (trackElement->GetBaseZ() != location.z)
-                    continue;
-                if (trackElement->GetDirection() != location.direction)
-                    continue;
-                if (trackElement->GetTrackType() != trackType)
-                    continue;
-                return trackElement;
-            }
-        } while (!(tileElement++)->IsLastForTile());
-    }
-    return nullptr;
+    return map_find_track_element_at(location, [&location, trackType](const TrackElement* element) {
+        return element->GetDirection() == location.direction && element->GetTrackType() == trackType;
+    });
 }
 
 TrackElement* map_get_track_element_at_of_type_seq(const CoordsXYZD& location, int32_t trackType, int32_t sequence)
 {
-    auto tileElement = map_get_first_element_at(location);
-    if (tileElement != nullptr)
-    {
-        do
-        {
-            auto trackElement = tileElement->AsTrack();
-            if (trackElement != nullptr)
-            {
-                if (trackElement->GetBaseZ() != location.z)
-                    continue;
-                if (trackElement->GetDirection() != location.direction)
-                    continue;
-                if (trackElement->GetTrackType() != trackType)
-                    continue;
-                if (trackElement->GetSequenceIndex() != sequence)
-                    continue;
-                return trackElement;
-            }
-        } while (!(tileElement++)->IsLastForTile());
-    }
-    return nullptr;
+    return map_find_track_element_at(location, [&location, trackType, sequence](const TrackElement* element) {
+        return element->GetDirection() == location.direction && element->GetTrackType() == trackType
+            && element->GetSequenceIndex() == sequence;
+    });
 }
 
 /**
@@ -2318,25 +3004,11 @@ TrackElement* map_get_track_element_at_of_type_seq(const CoordsXYZD& location, i
  */
 TileElement* map_get_track_element_at_of_type_from_ride(const CoordsXYZ& trackPos, int32_t trackType, ride_id_t rideIndex)
 {
-    TileElement* tileElement = map_get_first_element_at(trackPos);
-    if (tileElement == nullptr)
-        return nullptr;
-    auto trackTilePos = TileCoordsXYZ{ trackPos };
-    do
-    {
-        if (tileElement->GetType() != TILE_ELEMENT_TYPE_TRACK)
-            continue;
-        if (tileElement->base_height != trackTilePos.z)
-            continue;
-        if (tileElement->AsTrack()->GetRideIndex() != rideIndex)
-            continue;
-        if (tileElement->AsTrack()->GetTrackType() != trackType)
-            continue;
-
-        return tileElement;
-    } while (!(tileElement++)->IsLastForTile());
-
-    return nullptr;
+    auto trackElement = map_find_track_element_at(
+        trackPos, TileCoordsXYZ{ trackPos }.z, [trackType, rideIndex](const TrackElement* element) {
+            return element->GetRideIndex() == rideIndex && element->GetTrackType() == trackType;
+        });
+    return reinterpret_cast<TileElement*>(trackElement);
 };
 
 /**
@@ -2347,23 +3019,10 @@ TileElement* map_get_track_element_at_of_type_from_ride(const CoordsXYZ& trackPo
  */
 TileElement* map_get_track_element_at_from_ride(const CoordsXYZ& trackPos, ride_id_t rideIndex)
 {
-    TileElement* tileElement = map_get_first_element_at(trackPos);
-    if (tileElement == nullptr)
-        return nullptr;
-    auto trackTilePos = TileCoordsXYZ{ trackPos };
-    do
-    {
-        if (tileElement->GetType() != TILE_ELEMENT_TYPE_TRACK)
-            continue;
-        if (tileElement->base_height != trackTilePos.z)
-            continue;
-        if (tileElement->AsTrack()->GetRideIndex() != rideIndex)
-            continue;
-
-        return tileElement;
-    } while (!(tileElement++)->IsLastForTile());
-
-    return nullptr;
+    auto trackElement = map_find_track_element_at(
+        trackPos, TileCoordsXYZ{ trackPos }.z,
+        [rideIndex](const TrackElement* element) { return element->GetRideIndex() == rideIndex; });
+    return reinterpret_cast<TileElement*>(trackElement);
 };
 
 /**
@@ -2375,25 +3034,11 @@ TileElement* map_get_track_element_at_from_ride(const CoordsXYZ& trackPos, ride_
  */
 TileElement* map_get_track_element_at_with_direction_from_ride(const CoordsXYZD& trackPos, ride_id_t rideIndex)
 {
-    TileElement* tileElement = map_get_first_element_at(trackPos);
-    if (tileElement == nullptr)
-        return nullptr;
-    auto trackTilePos = TileCoordsXYZ{ trackPos };
-    do
-    {
-        if (tileElement->GetType() != TILE_ELEMENT_TYPE_TRACK)
-            continue;
-        if (tileElement->base_height != trackTilePos.z)
-            continue;
-        if (tileElement->AsTrack()->GetRideIndex() != rideIndex)
-            continue;
-        if (tileElement->GetDirection() != trackPos.direction)
-            continue;
-
-        return tileElement;
-    } while (!(tileElement++)->IsLastForTile());
-
-    return nullptr;
+    auto trackElement = map_find_track_element_at(
+        trackPos, TileCoordsXYZ{ trackPos }.z, [&trackPos, rideIndex](const TrackElement* element) {
+            return element->GetRideIndex() == rideIndex && element->GetDirection() == trackPos.direction;
+        });
+    return reinterpret_cast<TileElement*>(trackElement);
 };
 
 WallElement* map_get_wall_element_at(const CoordsXYRangedZ& coords)
@@ -33,9 +33,13 @@ constexpr const int32_t MINIMUM_LAND_HEIGHT_BIG = MINIMUM_LAND_HEIGHT * COORDS_Z
 
 #define MAP_MINIMUM_X_Y (-MAXIMUM_MAP_SIZE_TECHNICAL)
 
-constexpr const uint32_t MAX_TILE_ELEMENTS_WITH_SPARE_ROOM = 0x30000;
-constexpr const uint32_t MAX_TILE_ELEMENTS = MAX_TILE_ELEMENTS_WITH_SPARE_ROOM - 512;
+// Tile element storage grows as needed, this limit only bounds memory use. Parks with more than
+// RCT2_MAX_TILE_ELEMENTS elements can not be saved in the S6 format.
+constexpr const uint32_t MAX_TILE_ELEMENTS = 0x1000000;
 #define MAX_TILE_TILE_ELEMENT_POINTERS (MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL)
+// Tiles are grouped into square cells for indexes that only need to know which part of the map has changed
+constexpr const int32_t MAP_CELL_SIZE = 8;
+constexpr const int32_t MAP_CELL_COUNT_XY = MAXIMUM_MAP_SIZE_TECHNICAL / MAP_CELL_SIZE;
 #define MAX_PEEP_SPAWNS 2
 
 #define TILE_UNDEFINED_TILE_ELEMENT NULL
@@ -117,13 +121,11 @@ extern uint8_t gMapSelectArrowDirection;
 
 extern uint8_t gMapGroundFlags;
 
-extern TileElement gTileElements[MAX_TILE_ELEMENTS_WITH_SPARE_ROOM];
 extern TileElement* gTileElementTilePointers[MAX_TILE_TILE_ELEMENT_POINTERS];
 
 extern std::vector<CoordsXY> gMapSelectionTiles;
 extern std::vector<PeepSpawn> gPeepSpawns;
 
-extern TileElement* gNextFreeTileElement;
 extern uint32_t gNextFreeTileElementPointerIndex;
 
 // Used in the land tool window to enable mountain tool / land smoothing
@@ -144,14 +146,111 @@ constexpr auto SURFACE_STYLE_FLAG_RAISE_OR_LOWER_BASE_HEIGHT = 0x20;
 extern const uint8_t tile_element_lower_styles[9][32];
 extern const uint8_t tile_element_raise_styles[9][32];
 
+struct TileElementStorageStats
+{
+    size_t Chunks;
+    // Elements in chunks that have been handed out as runs at least once
+    size_t Capacity;
+    // Elements in runs owned by a tile or waiting to be recycled
+    size_t Allocated;
+    size_t Used;
+    // Position of the compactor within its current pass over all tiles, from 0 to 1
+    double CompactProgress;
+    uint32_t CompactPasses;
+    uint64_t Relocations;
+    uint32_t ChunksReleased;
+    // Emptied chunks kept for reuse until the next load
+    size_t SpareChunks;
+    bool IsEvacuatingChunk;
+
+    double GetFragmentation() const
+    {
+        return Capacity == 0 ? 0 : 1.0 - static_cast<double>(Used) / Capacity;
+    }
+};
+
+/**
+ * The tile coordinates of the map as sized by gMapSize, row by row. Whole map passes should iterate this rather
+ * than MAXIMUM_MAP_SIZE_TECHNICAL, the tiles beyond the map size never hold anything but a surface.
+ */
+class MapTileRange
+{
+public:
+    class Iterator
+    {
+    private:
+        int32_t _index;
+        int32_t _size;
+
+    public:
+        constexpr Iterator(int32_t index, int32_t size)
+            : _index(index)
+            , _size(size)
+        {
+        }
+
+        TileCoordsXY operator*() const
+        {
+            return { _index % _size, _index / _size };
+        }
+
+        Iterator& operator++()
+        {
+            _index++;
+            return *this;
+        }
+
+        bool operator!=(const Iterator& rhs) const
+        {
+            return _index != rhs._index;
+        }
+    };
+
+    explicit constexpr MapTileRange(int32_t size)
+        : _size(size)
+    {
+    }
+
+    Iterator begin() const
+    {
+        return { 0, _size };
+    }
+
+    Iterator end() const
+    {
+        return { _size * _size, _size };
+    }
+
+private:
+    int32_t _size;
+};
+
+constexpr uint16_t tile_element_type_flag(uint8_t type)
+{
+    return 1 << (type >> 2);
+}
+
 void map_init(int32_t size);
 
 void map_count_remaining_land_rights();
 void map_strip_ghost_flag_from_elements();
-void map_update_tile_pointers();
+void map_remove_elements_outside_map();
+void map_load_tile_elements(const std::vector<TileElement>& tileElements);
+std::vector<TileElement> map_get_tile_elements();
+uint32_t map_get_tile_element_count();
+void map_recycle_tile_elements();
+void map_compact_tile_elements();
+TileElementStorageStats map_get_tile_element_storage_stats();
+MapTileRange map_get_tiles();
+std::vector<TileCoordsXY> map_get_tiles_with_elements(uint16_t typeFlags);
 TileElement* map_get_first_element_at(const CoordsXY& elementPos);
 TileElement* map_get_nth_element_at(const CoordsXY& coords, int32_t n);
-void map_set_tile_element(const TileCoordsXY& tilePos, TileElement* elements);
+void map_set_tile_elements(const TileCoordsXY& tilePos, const TileElement* elements, size_t numElements);
+void map_substitute_tile_elements(const TileCoordsXY& tilePos, TileElement* elements);
+void map_restore_tile_elements();
+void map_mark_tile_elements_changed(const CoordsXY& loc);
+uint32_t map_get_tile_elements_generation(const CoordsXY& loc);
+uint32_t map_get_cell_elements_generation(const TileCoordsXY& cellPos);
 int32_t map_height_from_slope(const CoordsXY& coords, int32_t slopeDirection, bool isSloped);
 BannerElement* map_get_banner_element_at(const CoordsXYZ& bannerPos, uint8_t direction);
 SurfaceElement* map_get_surface_element_at(const CoordsXY& coords);
@@ -247,6 +346,7 @@ std::optional<CoordsXYZ> map_large_scenery_get_origin(
 
 ScreenCoordsXY translate_3d_to_2d_with_z(int32_t rotation, const CoordsXYZ& pos);
 
+void map_bypass_track_element_index(bool bypass);
 TrackElement* map_get_track_element_at(const CoordsXYZ& trackPos);
 TileElement* map_get_track_element_at_of_type(const CoordsXYZ& trackPos, int32_t trackType);
 TileElement* map_get_track_element_at_of_type_seq(const CoordsXYZ& trackPos, int32_t trackType, int32_t sequence);
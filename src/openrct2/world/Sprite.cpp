@@ -49,6 +49,9 @@ const rct_string_id litterNames[12] = { STR_LITTER_VOMIT,
 static CoordsXYZ _spritelocations1[MAX_SPRITES];
 static CoordsXYZ _spritelocations2[MAX_SPRITES];
 
+// Collects the spatial index moves and invalidations made on this thread, see sprite_defer_changes
+static thread_local SpriteDeferredChanges* _spriteDeferredChanges;
+
 static size_t GetSpatialIndexOffset(int32_t x, int32_t y);
 static void move_sprite_to_list(SpriteBase* sprite, EntityListId newListIndex);
 
@@ -118,21 +121,34 @@ uint16_t sprite_get_first_in_quadrant(const CoordsXY& spritePos)
     return gSpriteSpatialIndex[GetSpatialIndexOffset(spritePos.x, spritePos.y)];
 }
 
-static void invalidate_sprite_max_zoom(SpriteBase* sprite, int32_t maxZoom)
+static void invalidate_viewports_max_zoom(int32_t left, int32_t top, int32_t right, int32_t bottom, int32_t maxZoom)
 {
-    if (sprite->sprite_left == LOCATION_NULL)
-        return;
-
     for (int32_t i = 0; i < MAX_VIEWPORT_COUNT; i++)
     {
         rct_viewport* viewport = &g_viewport_list[i];
         if (viewport->width != 0 && viewport->zoom <= maxZoom)
         {
-            viewport_invalidate(viewport, sprite->sprite_left, sprite->sprite_top, sprite->sprite_right, sprite->sprite_bottom);
+            viewport_invalidate(viewport, left, top, right, bottom);
         }
     }
 }
 
+static void invalidate_sprite_max_zoom(SpriteBase* sprite, int32_t maxZoom)
+{
+    if (sprite->sprite_left == LOCATION_NULL)
+        return;
+
+    if (_spriteDeferredChanges != nullptr)
+    {
+        _spriteDeferredChanges->Invalidations.push_back(
+            { sprite->sprite_left, sprite->sprite_top, sprite->sprite_right, sprite->sprite_bottom, maxZoom });
+        return;
+    }
+
+    invalidate_viewports_max_zoom(
+        sprite->sprite_left, sprite->sprite_top, sprite->sprite_right, sprite->sprite_bottom, maxZoom);
+}
+
 /**
  * Invalidate the sprite if at closest zoom.
  *  rct2: 0x006EC60B
@@ -676,9 +692,10 @@ static void SpriteSpatialInsert(SpriteBase* sprite, const CoordsXY& newLoc)
     *next = sprite->sprite_index;
 }
 
-static void SpriteSpatialRemove(SpriteBase* sprite)
+// Unlinks the sprite from the given spatial index entry. Returns false if the index was corrupt and has been rebuilt
+// from the current sprite positions instead.
+static bool SpriteSpatialRemove(SpriteBase* sprite, size_t currentIndex)
 {
-    size_t currentIndex = GetSpatialIndexOffset(sprite->x, sprite->y);
     auto* index = &gSpriteSpatialIndex[currentIndex];
 
     // This indicates that the spatial index data is incorrect.
@@ -686,6 +703,7 @@ static void SpriteSpatialRemove(SpriteBase* sprite)
     {
         log_warning("Bad sprite spatial index. Rebuilding the spatial index...");
         reset_sprite_spatial_index();
+        return false;
     }
 
     auto* sprite2 = GetEntity(*index);
@@ -699,6 +717,7 @@ static void SpriteSpatialRemove(SpriteBase* sprite)
         sprite2 = GetEntity(*index);
     }
     *index = sprite->next_in_quadrant;
+    return true;
 }
 
 static void SpriteSpatialMove(SpriteBase* sprite, const CoordsXY& newLoc)
@@ -708,10 +727,58 @@ static void SpriteSpatialMove(SpriteBase* sprite, const CoordsXY& newLoc)
     if (newIndex == currentIndex)
         return;
 
-    SpriteSpatialRemove(sprite);
+    if (_spriteDeferredChanges != nullptr)
+    {
+        auto& moves = _spriteDeferredChanges->Moves;
+        auto spriteIndex = sprite->sprite_index;
+        auto isSprite = [spriteIndex](const auto& move) { return move.first == spriteIndex; };
+        if (std::none_of(moves.begin(), moves.end(), isSprite))
+        {
+            moves.emplace_back(spriteIndex, currentIndex);
+        }
+        return;
+    }
+
+    SpriteSpatialRemove(sprite, currentIndex);
     SpriteSpatialInsert(sprite, newLoc);
 }
 
+/**
+ * Starts collecting the changes MoveTo and the Invalidate functions make to shared state on the calling thread into
+ * the given list, or stops collecting when given nullptr. Sprites moved while collecting must not be looked up by
+ * position until the changes have been applied.
+ */
+void sprite_defer_changes(SpriteDeferredChanges* changes)
+{
+    _spriteDeferredChanges = changes;
+}
+
+/**
+ * Moves the sprites in the spatial index and invalidates the viewports as collected by sprite_defer_changes. The
+ * spatial index keeps each entry's sprites in sprite index order, so the result does not depend on the order of the
+ * moves.
+ */
+void sprite_apply_deferred_changes(const SpriteDeferredChanges& changes)
+{
+    for (const auto& [spriteIndex, oldIndex] : changes.Moves)
+    {
+        auto* sprite = GetEntity(spriteIndex);
+        if (sprite == nullptr)
+            continue;
+
+        // A rebuilt index already has every sprite at its current position
+        if (!SpriteSpatialRemove(sprite, oldIndex))
+            break;
+        SpriteSpatialInsert(sprite, { sprite->x, sprite->y });
+    }
+
+    for (const auto& invalidation : changes.Invalidations)
+    {
+        invalidate_viewports_max_zoom(
+            invalidation.Left, invalidation.Top, invalidation.Right, invalidation.Bottom, invalidation.MaxZoom);
+    }
+}
+
 /**
  * Moves a sprite to a new location.
  *  rct2: 0x0069E9D3
@@ -773,7 +840,7 @@ void sprite_remove(SpriteBase* sprite)
     sprite->sprite_identifier = SPRITE_IDENTIFIER_NULL;
     _spriteFlashingList[sprite->sprite_index] = false;
 
-    SpriteSpatialRemove(sprite);
+    SpriteSpatialRemove(sprite, GetSpatialIndexOffset(sprite->x, sprite->y));
 }
 
 static bool litter_can_be_at(const CoordsXYZ& mapPos)
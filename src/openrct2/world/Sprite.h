@@ -16,6 +16,9 @@
 #include "Fountain.h"
 #include "SpriteBase.h"
 
+#include <utility>
+#include <vector>
+
 #define SPRITE_INDEX_NULL 0xFFFF
 #define MAX_SPRITES 10000
 
@@ -238,6 +241,29 @@ void litter_remove_at(const CoordsXYZ& litterPos);
 uint16_t remove_floating_sprites();
 void sprite_misc_explosion_cloud_create(const CoordsXYZ& cloudPos);
 void sprite_misc_explosion_flare_create(const CoordsXYZ& flarePos);
+
+/**
+ * Changes to shared sprite state made by MoveTo and the Invalidate functions on a worker thread. Sprites keep their
+ * old spatial index entry and viewports are not invalidated until sprite_apply_deferred_changes is called.
+ */
+struct SpriteDeferredChanges
+{
+    struct Invalidation
+    {
+        int32_t Left;
+        int32_t Top;
+        int32_t Right;
+        int32_t Bottom;
+        int32_t MaxZoom;
+    };
+
+    // Each moved sprite and the spatial index entry it was in before its first move
+    std::vector<std::pair<uint16_t, size_t>> Moves;
+    std::vector<Invalidation> Invalidations;
+};
+
+void sprite_defer_changes(SpriteDeferredChanges* changes);
+void sprite_apply_deferred_changes(const SpriteDeferredChanges& changes);
 uint16_t sprite_get_first_in_quadrant(const CoordsXY& spritePos);
 void sprite_position_tween_store_a();
 void sprite_position_tween_store_b();
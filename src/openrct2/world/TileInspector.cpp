@@ -69,6 +69,7 @@ static bool map_swap_elements_at(const CoordsXY& loc, int16_t first, int16_t sec
         secondElement->SetLastForTile(!secondElement->IsLastForTile());
     }
 
+    map_mark_tile_elements_changed(loc);
     return true;
 }
 
@@ -520,6 +521,7 @@ GameActionResult::Ptr tile_inspector_any_base_height_offset(
         tileElement->base_height += heightOffset;
         tileElement->clearance_height += heightOffset;
 
+        map_mark_tile_elements_changed(loc);
         map_invalidate_tile_full(loc);
 
         rct_window* const tileInspectorWindow = window_find_by_class(WC_TILE_INSPECTOR);
@@ -924,6 +926,7 @@ GameActionResult::Ptr tile_inspector_track_base_height_offset(
 
             tileElement->base_height += offset;
             tileElement->clearance_height += offset;
+            map_mark_tile_elements_changed(elem);
         }
     }
 
@@ -0,0 +1,79 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <openrct2/peep/Peep.h>
+
+// The energy, happiness and nausea updates as they were before they were merged into one kernel
+static uint8_t UpdateEnergyReference(uint8_t energy, uint8_t energyTarget)
+{
+    uint8_t newEnergy = energy;
+    uint8_t newTargetEnergy = energyTarget;
+    if (newEnergy >= newTargetEnergy)
+    {
+        newEnergy -= 2;
+        if (newEnergy < newTargetEnergy)
+            newEnergy = newTargetEnergy;
+    }
+    else
+    {
+        newEnergy = std::min(PEEP_MAX_ENERGY_TARGET, newEnergy + 4);
+        if (newEnergy > newTargetEnergy)
+            newEnergy = newTargetEnergy;
+    }
+
+    if (newEnergy < PEEP_MIN_ENERGY)
+        newEnergy = PEEP_MIN_ENERGY;
+
+    newEnergy = std::min(static_cast<uint8_t>(PEEP_MAX_ENERGY), newEnergy);
+    return newEnergy;
+}
+
+static uint8_t UpdateHappinessOrNauseaReference(uint8_t value, uint8_t target)
+{
+    uint8_t newValue = value;
+    if (newValue >= target)
+    {
+        newValue = std::max(newValue - 4, 0);
+        if (newValue < target)
+            newValue = target;
+    }
+    else
+    {
+        newValue = std::min(255, newValue + 4);
+        if (newValue > target)
+            newValue = target;
+    }
+    return newValue;
+}
+
+TEST(GuestNeeds, MatchesReferenceForAllValuesAndTargets)
+{
+    for (int32_t value = 0; value <= UINT8_MAX; value++)
+    {
+        for (int32_t target = 0; target <= UINT8_MAX; target++)
+        {
+            // Each need is given a different combination so that a mix up between the lanes is caught
+            uint8_t needs[GUEST_NEED_COUNT] = { static_cast<uint8_t>(value), static_cast<uint8_t>(target),
+                                                static_cast<uint8_t>(value) };
+            const uint8_t targets[GUEST_NEED_COUNT] = { static_cast<uint8_t>(target), static_cast<uint8_t>(value),
+                                                        static_cast<uint8_t>(target) };
+            guest_update_needs_towards_targets(needs, targets);
+
+            ASSERT_EQ(needs[GUEST_NEED_ENERGY], UpdateEnergyReference(value, target))
+                << "energy " << value << ", target " << target;
+            ASSERT_EQ(needs[GUEST_NEED_HAPPINESS], UpdateHappinessOrNauseaReference(target, value))
+                << "happiness " << target << ", target " << value;
+            ASSERT_EQ(needs[GUEST_NEED_NAUSEA], UpdateHappinessOrNauseaReference(value, target))
+                << "nausea " << value << ", target " << target;
+        }
+    }
+}
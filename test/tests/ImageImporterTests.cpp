@@ -10,6 +10,8 @@
 #include "TestData.h"
 
 #include <gtest/gtest.h>
+#include <openrct2/core/FileSystem.hpp>
+#include <openrct2/core/Imaging.h>
 #include <openrct2/core/Path.hpp>
 #include <openrct2/drawing/ImageImporter.h>
 #include <string_view>
@@ -56,3 +58,32 @@ TEST_F(ImageImporterTests, Import_Logo)
     auto hash = GetHash(result.Buffer.data(), result.Buffer.size());
     ASSERT_EQ(0xCEF27C7D, hash);
 }
+
+TEST_F(ImageImporterTests, WritePng_RoundTrip)
+{
+    Image image;
+    image.Width = 300;
+    image.Height = 2000;
+    image.Depth = 32;
+    image.Stride = image.Width * 4;
+    image.Pixels.resize(image.Stride * image.Height);
+    for (size_t i = 0; i < image.Pixels.size(); i++)
+    {
+        image.Pixels[i] = static_cast<uint8_t>((i * 7) ^ (i >> 9));
+    }
+
+    // Large enough to be split into several deflate chunks
+    auto path = (fs::temp_directory_path() / "openrct2_test_roundtrip.png").u8string();
+    for (auto level : { 0, 1, 9 })
+    {
+        ImageWriteOptions options;
+        options.CompressionLevel = level;
+        Imaging::WriteToFile(path, image, IMAGE_FORMAT::PNG_32, options);
+
+        auto result = Imaging::ReadFromFile(path, IMAGE_FORMAT::PNG_32);
+        ASSERT_EQ(image.Width, result.Width);
+        ASSERT_EQ(image.Height, result.Height);
+        ASSERT_EQ(image.Pixels, result.Pixels);
+    }
+    fs::remove(path);
+}
@@ -9,6 +9,8 @@
 
 #include "openrct2/localisation/LanguagePack.h"
 
+#include "openrct2/localisation/FormatCodes.h"
+#include "openrct2/localisation/FormatProgram.h"
 #include "openrct2/localisation/Language.h"
 #include "openrct2/localisation/StringIds.h"
 
@@ -77,6 +79,42 @@ TEST_F(LanguagePackTest, language_pack_multibyte)
     delete lang;
 }
 
+TEST_F(LanguagePackTest, format_program)
+{
+    ILanguagePack* lang = LanguagePackFactory::FromText(0, LanguageEnGB);
+    auto program = lang->GetFormatProgram(1);
+    ASSERT_NE(program, nullptr);
+    ASSERT_EQ(program->Source, lang->GetString(1));
+    ASSERT_EQ(program->Tokens.size(), 3U);
+    ASSERT_EQ(program->Tokens[0].Code, static_cast<uint32_t>(FORMAT_STRINGID));
+    ASSERT_EQ(program->Tokens[1].Code, 0U);
+    ASSERT_EQ(program->Tokens[1].Length, 1U);
+    ASSERT_EQ(program->Tokens[2].Code, static_cast<uint32_t>(FORMAT_COMMA16));
+    // Empty strings and overrides are formatted raw
+    ASSERT_EQ(lang->GetFormatProgram(0), nullptr);
+    ASSERT_EQ(lang->GetFormatProgram(0x6000), nullptr);
+    // Changing a string recompiles it
+    lang->SetString(2, "Wooden Roller Coaster");
+    program = lang->GetFormatProgram(2);
+    ASSERT_NE(program, nullptr);
+    ASSERT_EQ(program->Source, lang->GetString(2));
+    ASSERT_EQ(program->Tokens.size(), 1U);
+    ASSERT_EQ(program->Tokens[0].Length, 21U);
+    lang->RemoveString(2);
+    ASSERT_EQ(lang->GetFormatProgram(2), nullptr);
+    delete lang;
+}
+
+TEST_F(LanguagePackTest, format_program_malformed)
+{
+    // Truncated multi-byte sequence
+    auto program = FormatProgram::Compile("abc\xC3");
+    ASSERT_FALSE(program.IsValid());
+    // Control code missing its argument byte
+    program = FormatProgram::Compile("\x01");
+    ASSERT_FALSE(program.IsValid());
+}
+
 const utf8* LanguagePackTest::LanguageEnGB = "# STR_XXXX part is read and XXXX becomes the string id number.\n"
                                              "# Everything after the colon and before the new line will be saved as the "
                                              "string.\n"
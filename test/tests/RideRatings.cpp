@@ -20,7 +20,10 @@
 #include <openrct2/platform/platform.h>
 #include <openrct2/ride/Ride.h>
 #include <openrct2/ride/RideData.h>
+#include <openrct2/ride/RideRatings.h>
+#include <memory>
 #include <string>
+#include <vector>
 
 using namespace OpenRCT2;
 
@@ -35,6 +38,52 @@ protected:
         }
     }
 
+    void CalculateRatingsForAllRidesBatched()
+    {
+        std::vector<ride_id_t> rideIds;
+        for (const auto& ride : GetRideManager())
+        {
+            rideIds.push_back(ride.id);
+        }
+        ride_ratings_update_rides(rideIds);
+    }
+
+    void LoadPark()
+    {
+        std::string path = TestData::GetParkPath("bpb.sv6");
+
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+
+        core_init();
+        _context = CreateContext();
+        bool initialised = _context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        load_from_sv6(path.c_str());
+
+        // Check ride count to check load was successful
+        ASSERT_EQ(ride_get_count(), 134);
+    }
+
+    void CheckRatings()
+    {
+        // Load expected ratings
+        auto expectedDataPath = Path::Combine(TestData::GetBasePath(), "ratings", "bpb.sv6.txt");
+        auto expectedRatings = File::ReadAllLines(expectedDataPath);
+
+        // Check ride ratings
+        int expI = 0;
+        for (const auto& ride : GetRideManager())
+        {
+            auto actual = FormatRatings(ride);
+            auto expected = expectedRatings[expI];
+            ASSERT_STREQ(actual.c_str(), expected.c_str());
+
+            expI++;
+        }
+    }
+
     void DumpRatings()
     {
         for (const auto& ride : GetRideManager())
@@ -52,39 +101,30 @@ protected:
             (int)ratings.Nausea);
         return line;
     }
+
+private:
+    std::unique_ptr<IContext> _context;
 };
 
 TEST_F(RideRatings, all)
 {
-    std::string path = TestData::GetParkPath("bpb.sv6");
-
-    gOpenRCT2Headless = true;
-    gOpenRCT2NoGraphics = true;
-
-    core_init();
-    auto context = CreateContext();
-    bool initialised = context->Initialise();
-    ASSERT_TRUE(initialised);
-
-    load_from_sv6(path.c_str());
-
-    // Check ride count to check load was successful
-    ASSERT_EQ(ride_get_count(), 134);
-
+    LoadPark();
     CalculateRatingsForAllRides();
+    CheckRatings();
+}
 
-    // Load expected ratings
-    auto expectedDataPath = Path::Combine(TestData::GetBasePath(), "ratings", "bpb.sv6.txt");
-    auto expectedRatings = File::ReadAllLines(expectedDataPath);
-
-    // Check ride ratings
-    int expI = 0;
-    for (const auto& ride : GetRideManager())
-    {
-        auto actual = FormatRatings(ride);
-        auto expected = expectedRatings[expI];
-        ASSERT_STREQ(actual.c_str(), expected.c_str());
+TEST_F(RideRatings, all_batched)
+{
+    LoadPark();
+    CalculateRatingsForAllRidesBatched();
+    CheckRatings();
+}
 
-        expI++;
-    }
+TEST_F(RideRatings, all_cached)
+{
+    LoadPark();
+    CalculateRatingsForAllRides();
+    // Nothing has changed, so every proximity score now comes from the cache
+    CalculateRatingsForAllRides();
+    CheckRatings();
 }
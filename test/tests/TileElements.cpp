@@ -9,11 +9,15 @@
 
 #include "TestData.h"
 
+#include <algorithm>
+#include <iterator>
 #include <gtest/gtest.h>
 #include <openrct2/Context.h>
 #include <openrct2/Game.h>
 #include <openrct2/OpenRCT2.h>
 #include <openrct2/ParkImporter.h>
+#include <openrct2/ride/Ride.h>
+#include <openrct2/ride/Track.h>
 #include <openrct2/world/Footpath.h>
 #include <openrct2/world/Map.h>
 
@@ -140,3 +144,249 @@ TEST_F(TileElementWantsFootpathConnection, DifferentHeight)
     EXPECT_FALSE(tile_element_wants_path_connection_towards({ 18, 10, 24, 1 }, nullptr));
     SUCCEED();
 }
+
+class TileElementStorage : public testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        _context = CreateContext();
+        bool initialised = _context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        map_init(64);
+        SUCCEED();
+    }
+
+    static void TearDownTestCase()
+    {
+        if (_context)
+            _context.reset();
+    }
+
+private:
+    static std::shared_ptr<IContext> _context;
+};
+
+std::shared_ptr<IContext> TileElementStorage::_context;
+
+TEST_F(TileElementStorage, InsertAndRemove)
+{
+    const auto loc = TileCoordsXY{ 10, 10 }.ToCoordsXY();
+    const auto numElements = map_get_tile_element_count();
+    const auto z = map_get_surface_element_at(loc)->GetBaseZ() + 16;
+
+    TileElement* inserted = tile_element_insert({ loc, z }, 0b1111);
+    ASSERT_NE(inserted, nullptr);
+    EXPECT_EQ(map_get_tile_element_count(), numElements + 1);
+
+    // The tile is moved to a larger run with the new element on top of the surface
+    TileElement* first = map_get_first_element_at(loc);
+    EXPECT_FALSE(first->IsLastForTile());
+    EXPECT_EQ(first + 1, inserted);
+    EXPECT_TRUE(inserted->IsLastForTile());
+    EXPECT_EQ(inserted->GetBaseZ(), z);
+
+    tile_element_remove(inserted);
+    EXPECT_EQ(map_get_tile_element_count(), numElements);
+    EXPECT_TRUE(map_get_first_element_at(loc)->IsLastForTile());
+}
+
+TEST_F(TileElementStorage, SaveAndLoad)
+{
+    auto tileElements = map_get_tile_elements();
+    ASSERT_EQ(tileElements.size(), map_get_tile_element_count());
+    ASSERT_EQ(tileElements.size(), static_cast<size_t>(MAX_TILE_TILE_ELEMENT_POINTERS));
+
+    map_load_tile_elements(tileElements);
+    EXPECT_EQ(map_get_tile_element_count(), tileElements.size());
+    EXPECT_EQ(map_get_tile_elements().size(), tileElements.size());
+}
+
+TEST_F(TileElementStorage, CompactShrinksRuns)
+{
+    const auto loc = TileCoordsXY{ 20, 20 }.ToCoordsXY();
+    const auto z = map_get_surface_element_at(loc)->GetBaseZ() + 16;
+
+    // Grow the tile to a run of 8 elements and then remove everything except the surface again
+    for (int32_t i = 0; i < 6; i++)
+    {
+        ASSERT_NE(tile_element_insert({ loc, z + i * 8 }, 0b1111), nullptr);
+    }
+    map_recycle_tile_elements();
+    for (int32_t i = 0; i < 6; i++)
+    {
+        tile_element_remove(map_get_first_element_at(loc) + 1);
+    }
+    const auto before = map_get_tile_element_storage_stats();
+
+    // One full pass over the map
+    for (int32_t i = 0; i < 64; i++)
+    {
+        map_recycle_tile_elements();
+        map_compact_tile_elements();
+    }
+    map_recycle_tile_elements();
+
+    const auto after = map_get_tile_element_storage_stats();
+    EXPECT_GT(after.Relocations, before.Relocations);
+    EXPECT_EQ(after.Used, before.Used);
+    EXPECT_LT(after.Allocated, before.Allocated);
+    EXPECT_TRUE(map_get_first_element_at(loc)->IsLastForTile());
+}
+
+TEST_F(TileElementStorage, TilesWithElements)
+{
+    const auto tilePos = TileCoordsXY{ 30, 12 };
+    const auto z = map_get_surface_element_at(tilePos.ToCoordsXY())->GetBaseZ() + 16;
+    const auto trackFlag = tile_element_type_flag(TILE_ELEMENT_TYPE_TRACK);
+
+    auto contains = [](const std::vector<TileCoordsXY>& tiles, const TileCoordsXY& pos) {
+        return std::any_of(
+            tiles.begin(), tiles.end(), [&pos](const TileCoordsXY& t) { return t.x == pos.x && t.y == pos.y; });
+    };
+    EXPECT_FALSE(contains(map_get_tiles_with_elements(trackFlag), tilePos));
+
+    auto tileElement = tile_element_insert({ tilePos.ToCoordsXY(), z }, 0b1111);
+    ASSERT_NE(tileElement, nullptr);
+    tileElement->SetType(TILE_ELEMENT_TYPE_TRACK);
+    map_recycle_tile_elements();
+
+    auto tiles = map_get_tiles_with_elements(trackFlag);
+    EXPECT_TRUE(contains(tiles, tilePos));
+    EXPECT_FALSE(contains(tiles, TileCoordsXY{ 31, 12 }));
+
+    tile_element_remove(map_get_first_element_at(tilePos.ToCoordsXY()) + 1);
+}
+
+TEST_F(TileElementStorage, TrackElementLookup)
+{
+    const auto loc = TileCoordsXY{ 40, 40 }.ToCoordsXY();
+    const auto z = map_get_surface_element_at(loc)->GetBaseZ() + 16;
+    const auto trackPos = CoordsXYZ{ loc, z };
+    EXPECT_EQ(map_get_track_element_at(trackPos), nullptr);
+
+    auto tileElement = tile_element_insert(trackPos, 0b1111);
+    ASSERT_NE(tileElement, nullptr);
+    tileElement->SetType(TILE_ELEMENT_TYPE_TRACK);
+    tileElement->AsTrack()->SetRideIndex(3);
+    tileElement->AsTrack()->SetTrackType(TRACK_ELEM_FLAT);
+    map_mark_tile_elements_changed(loc);
+
+    EXPECT_EQ(map_get_track_element_at(trackPos), tileElement->AsTrack());
+    EXPECT_EQ(map_get_track_element_at_from_ride(trackPos, 3), tileElement);
+    EXPECT_EQ(map_get_track_element_at_from_ride(trackPos, 4), nullptr);
+    EXPECT_EQ(map_get_track_element_at_of_type(trackPos, TRACK_ELEM_FLAT), tileElement);
+
+    // Inserting into the tile moves its elements, lookups must follow
+    auto other = tile_element_insert({ loc, z + 64 }, 0b1111);
+    ASSERT_NE(other, nullptr);
+    auto moved = map_get_track_element_at(trackPos);
+    ASSERT_NE(moved, nullptr);
+    EXPECT_EQ(moved, map_get_first_element_at(loc)[1].AsTrack());
+
+    tile_element_remove(other);
+    tile_element_remove(map_get_first_element_at(loc) + 1);
+    EXPECT_EQ(map_get_track_element_at(trackPos), nullptr);
+}
+
+TEST_F(TileElementStorage, TrackElementLookupManyAtHeight)
+{
+    const auto loc = TileCoordsXY{ 44, 40 }.ToCoordsXY();
+    const auto z = map_get_surface_element_at(loc)->GetBaseZ() + 16;
+    const auto trackPos = CoordsXYZ{ loc, z };
+
+    // More track elements at one height than an index entry holds
+    constexpr ride_id_t numElements = 6;
+    for (ride_id_t i = 0; i < numElements; i++)
+    {
+        auto tileElement = tile_element_insert(trackPos, 0b1111);
+        ASSERT_NE(tileElement, nullptr);
+        tileElement->SetType(TILE_ELEMENT_TYPE_TRACK);
+        tileElement->AsTrack()->SetRideIndex(i);
+        tileElement->AsTrack()->SetTrackType(TRACK_ELEM_FLAT);
+    }
+    map_mark_tile_elements_changed(loc);
+
+    for (ride_id_t i = 0; i < numElements; i++)
+    {
+        auto tileElement = map_get_track_element_at_from_ride(trackPos, i);
+        ASSERT_NE(tileElement, nullptr);
+        EXPECT_EQ(tileElement->AsTrack()->GetRideIndex(), i);
+    }
+
+    for (ride_id_t i = 0; i < numElements; i++)
+    {
+        tile_element_remove(map_get_first_element_at(loc) + 1);
+    }
+    EXPECT_EQ(map_get_track_element_at(trackPos), nullptr);
+}
+
+TEST_F(TileElementStorage, RidesWithTrackIn)
+{
+    const auto tilePos = TileCoordsXY{ 50, 21 };
+    const auto loc = tilePos.ToCoordsXY();
+    const auto z = map_get_surface_element_at(loc)->GetBaseZ() + 16;
+    EXPECT_FALSE(ride_get_rides_with_track_in({ 40, 11 }, { 60, 31 })[5]);
+
+    auto tileElement = tile_element_insert({ loc, z }, 0b1111);
+    ASSERT_NE(tileElement, nullptr);
+    tileElement->SetType(TILE_ELEMENT_TYPE_TRACK);
+    tileElement->AsTrack()->SetRideIndex(5);
+    map_mark_tile_elements_changed(loc);
+
+    // Ranges that only overlap part of the tile's cell
+    EXPECT_TRUE(ride_get_rides_with_track_in({ 40, 11 }, { 60, 31 })[5]);
+    EXPECT_TRUE(ride_get_rides_with_track_in({ 50, 21 }, { 50, 21 })[5]);
+    EXPECT_FALSE(ride_get_rides_with_track_in({ 51, 11 }, { 60, 31 })[5]);
+    EXPECT_FALSE(ride_get_rides_with_track_in({ 40, 11 }, { 60, 20 })[5]);
+
+    tile_element_remove(map_get_first_element_at(loc) + 1);
+    EXPECT_FALSE(ride_get_rides_with_track_in({ 40, 11 }, { 60, 31 })[5]);
+}
+
+TEST_F(TileElementStorage, SetTileElements)
+{
+    const auto tilePos = TileCoordsXY{ 12, 12 };
+    const auto loc = tilePos.ToCoordsXY();
+    const auto numElements = map_get_tile_element_count();
+
+    TileElement elements[3];
+    for (auto& element : elements)
+    {
+        element = *map_get_first_element_at(loc);
+    }
+    map_set_tile_elements(tilePos, elements, std::size(elements));
+    EXPECT_EQ(map_get_tile_element_count(), numElements + 2);
+    EXPECT_FALSE(map_get_first_element_at(loc)[1].IsLastForTile());
+    EXPECT_TRUE(map_get_first_element_at(loc)[2].IsLastForTile());
+
+    map_set_tile_elements(tilePos, elements, 1);
+    EXPECT_EQ(map_get_tile_element_count(), numElements);
+    EXPECT_TRUE(map_get_first_element_at(loc)->IsLastForTile());
+    map_recycle_tile_elements();
+}
+
+TEST_F(TileElementStorage, TypeChangedInPlace)
+{
+    const auto tilePos = TileCoordsXY{ 14, 14 };
+    const auto loc = tilePos.ToCoordsXY();
+    map_recycle_tile_elements();
+
+    auto hasTile = [&tilePos]() {
+        auto tiles = map_get_tiles_with_elements(tile_element_type_flag(TILE_ELEMENT_TYPE_WALL));
+        return std::find(tiles.begin(), tiles.end(), tilePos) != tiles.end();
+    };
+    ASSERT_FALSE(hasTile());
+
+    auto tileElement = map_get_first_element_at(loc);
+    auto original = *tileElement;
+    tileElement->SetType(TILE_ELEMENT_TYPE_WALL);
+    map_mark_tile_elements_changed(loc);
+    EXPECT_TRUE(hasTile());
+
+    *tileElement = original;
+    map_mark_tile_elements_changed(loc);
+}